@@ -1,42 +1,260 @@
 // Logger.cpp : Defines the exported functions for the DLL application.
 //
+// Messages are formatted on the calling thread into a fixed size slot of a
+// lock-free ring buffer, and a background thread stamps them with the time and
+// writes them out. Producers claim slots with a compare-and-swap on the tail,
+// so any number of threads can log without taking a lock.
+//
 #include <stdio.h>
 #include <time.h>
-#include <sstream>
-#include <iomanip>
 #include "stdafx.h"
 #include "Logger.h"
 #include <ctime>
 #include <cstdarg>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 namespace Logger
 {
+  static const size_t QUEUE_SIZE = 4096;       // Must be a power of two
+  static const size_t MESSAGE_SIZE = 256;      // Longer messages are truncated
+
+  struct Record
+  {
+    long long time;                            // System clock, in milliseconds
+    const char * logId;                        // Level names are string literals, so only the pointer is kept
+    int length;
+    char message[MESSAGE_SIZE];
+  };
+
+  struct Slot
+  {
+    std::atomic<size_t> sequence;
+    Record record;
+  };
+
   static int priority_level = Info::level | Warning::level | Error::level;
+  static int overflow_policy = LOG_OVERFLOW_DROP;
   static FILE * log_file = stdout;
 
-  int Log_print(int priority, const char * logId, const char * format, va_list args)
+  static Slot queue[QUEUE_SIZE];
+  static std::atomic<size_t> queue_head{ 0 };  // Next slot the writer reads
+  static std::atomic<size_t> queue_tail{ 0 };  // Next slot a producer claims
+  static std::atomic<unsigned long long> dropped{ 0 };        // Not yet reported in the log
+  static std::atomic<unsigned long long> dropped_total{ 0 };
+
+  static std::once_flag start_flag;
+  static std::atomic<bool> running{ false };
+  static std::atomic<bool> writer_done{ false };
+  static std::atomic<int> producers{ 0 };      // Callers that may still publish to the queue
+  static std::mutex file_lock;                 // Held by whoever is writing to log_file
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Writes one record to the log file, formatting the timestamp only when
+      the second changes
+  */
+  /****************************************************************************/
+  static void WriteRecord(const Record & record)
+  {
+    static time_t lastTime = 0;
+    static char timeStamp[16] = "";
+
+    time_t ltime = static_cast<time_t>(record.time / 1000);
+
+    if (ltime != lastTime)
+    {
+      strftime(timeStamp, sizeof(timeStamp), "%H:%M:%S", localtime(&ltime));
+      lastTime = ltime;
+    }
+
+    fprintf(log_file, "[%s] [%s] : %.*s\n", timeStamp, record.logId, record.length, record.message);
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Writes every record that has been published since the last call
+
+    \return
+      Number of records written
+  */
+  /****************************************************************************/
+  static size_t Drain()
+  {
+    std::lock_guard<std::mutex> lock(file_lock);
+
+    size_t written = 0;
+    size_t pos = queue_head.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+      Slot & slot = queue[pos & (QUEUE_SIZE - 1)];
+
+      if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+        break;
+
+      WriteRecord(slot.record);
+
+      // Hand the slot back to producers for the next lap around the ring
+      slot.sequence.store(pos + QUEUE_SIZE, std::memory_order_release);
+      queue_head.store(++pos, std::memory_order_release);
+      ++written;
+    }
+
+    unsigned long long lost = dropped.exchange(0);
+
+    if (lost)
+      fprintf(log_file, "[LOGGER] : %llu messages dropped, the log queue was full\n", lost);
+
+    if (written || lost)
+      fflush(log_file);
+
+    return written + static_cast<size_t>(lost);
+  }
+
+  static void WriterLoop()
+  {
+    while (running.load(std::memory_order_acquire))
+    {
+      if (Drain() == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    Drain();
+    writer_done.store(true, std::memory_order_release);
+  }
+
+  static void StartWriter()
+  {
+    for (size_t i = 0; i < QUEUE_SIZE; ++i)
+      queue[i].sequence.store(i, std::memory_order_relaxed);
+
+    running.store(true, std::memory_order_release);
+
+    // Detached so an unexpected exit can't trip over a joinable thread,
+    // Shutdown waits on writer_done instead
+    std::thread(WriterLoop).detach();
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Claims a slot at the tail of the queue. When the queue is full the
+      message is dropped, unless the policy is to block or the message is an
+      error, in which case the caller waits for the writer to catch up. A
+      waiting caller gives up as soon as the writer is shut down
+
+    \return
+      The claimed slot and its position, or nullptr if the message was dropped
+      or the writer stopped
+  */
+  /****************************************************************************/
+  static Slot * Claim(int priority, size_t & pos)
   {
-    int written = 0;
-    std::stringstream formatTime;
+    bool wait = (overflow_policy == LOG_OVERFLOW_BLOCK) || (priority & LOG_ERROR);
+
+    pos = queue_tail.load(std::memory_order_relaxed);
 
-    if (priority & priority_level)
+    for (;;)
     {
-      time_t ltime;       // Time
+      Slot & slot = queue[pos & (QUEUE_SIZE - 1)];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      long long diff = static_cast<long long>(sequence) - static_cast<long long>(pos);
+
+      if (diff == 0)
+      {
+        if (queue_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          return &slot;
+      }
+      else if (diff < 0)
+      {
+        // Full, the writer hasn't freed this slot from the last lap yet
+        if (!wait)
+        {
+          ++dropped;
+          ++dropped_total;
+          return nullptr;
+        }
+
+        // Nothing will free the slot once the writer has stopped
+        if (!running.load())
+          return nullptr;
+
+        std::this_thread::yield();
+        pos = queue_tail.load(std::memory_order_relaxed);
+      }
+      else
+        pos = queue_tail.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Formats a message into a record, which is the only work left on the caller's thread
+  static int FillRecord(Record & record, const char * logId, const char * format, va_list args)
+  {
+    record.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+    record.logId = logId;
+
+    int length = vsnprintf(record.message, MESSAGE_SIZE, format, args);
+
+    if (length < 0)
+      length = 0;
+    else if (length >= static_cast<int>(MESSAGE_SIZE))
+      length = MESSAGE_SIZE - 1;
 
-      ltime = time(NULL);
+    return record.length = length;
+  }
+
+  int Log_print(int priority, const char * logId, const char * format, va_list args)
+  {
+    if (!(priority & priority_level))
+      return 0;
+
+    std::call_once(start_flag, StartWriter);
 
-      formatTime << std::put_time(localtime(&ltime), "%H:%M:%S");
+    // Counted before running is checked, so Shutdown waits for every caller
+    // that saw the writer running to finish publishing
+    ++producers;
 
-      // Print timestamp and level info
-      fprintf(log_file, "[%s] [%s] : ", formatTime.str().c_str(), logId);
+    if (running.load())
+    {
+      size_t pos;
+      Slot * slot = Claim(priority, pos);
 
-      // Print formated message
-      written = vfprintf(log_file, format, args);
+      if (slot != nullptr)
+      {
+        int written = FillRecord(slot->record, logId, format, args);
 
-      // Print newline
-      fprintf(log_file, "\n");
+        // Publish the record to the writer
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        --producers;
+
+        return written;
+      }
+
+      // Dropped because the queue was full
+      if (running.load())
+      {
+        --producers;
+        return 0;
+      }
     }
 
+    --producers;
+
+    // Logging after shutdown goes straight to the file
+    Record record;
+    int written = FillRecord(record, logId, format, args);
+
+    std::lock_guard<std::mutex> lock(file_lock);
+    WriteRecord(record);
+    fflush(log_file);
+
     return written;
   }
 
@@ -59,9 +277,59 @@ namespace Logger
 
   void Set_Logfile(const char * name)
   {
-    fclose(log_file);
+    Flush();
+
+    std::lock_guard<std::mutex> lock(file_lock);
+
+    if (log_file != stdout)
+      fclose(log_file);
 
     log_file = fopen(name, "w");
 
+    if (log_file == nullptr)
+      log_file = stdout;
+  }
+
+  void Set_Overflow(int policy)
+  {
+    overflow_policy = policy;
+  }
+
+  unsigned long long Get_Dropped()
+  {
+    return dropped_total.load();
+  }
+
+  void Flush()
+  {
+    if (!running.load(std::memory_order_acquire))
+      return;
+
+    // Wait for the writer to pass everything queued so far
+    size_t tail = queue_tail.load(std::memory_order_acquire);
+
+    while (queue_head.load(std::memory_order_acquire) < tail && running.load(std::memory_order_acquire))
+      std::this_thread::yield();
+
+    std::lock_guard<std::mutex> lock(file_lock);
+    fflush(log_file);
+  }
+
+  void Shutdown()
+  {
+    Flush();
+
+    if (!running.exchange(false))
+      return;
+
+    // The writer drains whatever is left before it finishes
+    while (!writer_done.load(std::memory_order_acquire))
+      std::this_thread::yield();
+
+    // Callers that saw the writer running may publish after its last drain
+    while (producers.load() != 0)
+      std::this_thread::yield();
+
+    Drain();
   }
 }
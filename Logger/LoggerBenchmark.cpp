@@ -0,0 +1,78 @@
+// LoggerBenchmark.cpp : Measures how long Log calls take on the calling thread.
+//
+// Not part of the DLL. LoggerBenchmark.vcxproj builds it as a console
+// application with Logger.cpp compiled in (LOGGER_STATIC), the same way the
+// game uses the logger. Run it as:
+//
+//   LoggerBenchmark [messages per thread] [log file]
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Keep info calls compiled in for release builds too, or there'd be nothing
+// to measure
+#define LOG_COMPILED_LEVELS (~0)
+#include "Logger.h"
+
+using namespace Logger;
+
+static double RunThreads(unsigned threads, unsigned messages)
+{
+  std::vector<std::thread> workers;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (unsigned t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([t, messages]()
+    {
+      for (unsigned i = 0; i < messages; ++i)
+        Log<Info>("thread %u message %u value %f", t, i, i * 0.5);
+    });
+  }
+
+  for (std::thread & worker : workers)
+    worker.join();
+
+  auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char ** argv)
+{
+  unsigned messages = argc > 1 ? static_cast<unsigned>(atoi(argv[1])) : 100000;
+  const char * file = argc > 2 ? argv[2] : "logger_benchmark.log";
+
+  Set_Priority(LOG_ALL);
+  Set_Logfile(file);
+
+  const unsigned threadCounts[] = { 1, 8 };
+  const int policies[] = { LOG_OVERFLOW_DROP, LOG_OVERFLOW_BLOCK };
+
+  for (int policy : policies)
+  {
+    Set_Overflow(policy);
+
+    for (unsigned threads : threadCounts)
+    {
+      Flush();
+
+      unsigned long long droppedBefore = Get_Dropped();
+      double seconds = RunThreads(threads, messages);
+      unsigned long long dropped = Get_Dropped() - droppedBefore;
+      double total = static_cast<double>(threads) * messages;
+
+      printf("%-5s %u thread(s): %.0f calls/sec, %.1f ns per call, %llu dropped\n",
+        policy == LOG_OVERFLOW_DROP ? "drop" : "block", threads,
+        total / seconds, seconds * 1e9 / total * threads, dropped);
+    }
+  }
+
+  Shutdown();
+
+  return 0;
+}
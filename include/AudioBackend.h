@@ -0,0 +1,81 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+
+#ifndef AUDIO_BACKEND_H
+#define AUDIO_BACKEND_H
+
+#include <string>
+#include <vector>
+
+// FMOD only ships for Windows. Everywhere else the SDL mixer is all there is.
+#if defined(_WIN32) && !defined(AUDIO_NO_FMOD)
+#define AUDIO_FMOD
+#endif
+
+struct Vector3
+{
+  float x;
+  float y;
+  float z;
+  Vector3() : x(0), y(0), z(0) {};
+  Vector3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {};
+};
+
+// Index of a sound in the engine. Look it up once with GetSoundHandle and
+//      keep it; handles stay valid until the engine shuts down.
+typedef int SoundHandle;
+const SoundHandle INVALID_SOUND = -1;
+
+// Sounds that can play at once.
+const int AUDIO_MAX_VOICES = 32;
+
+/**********************************************************************/
+/**********************************************************************/
+/*! \brief
+ * What actually makes the noise. The engine keeps the sound table and the
+ * voice pool itself and hands the backend sounds by handle and voices by
+ * their slot in the pool, so a backend only has to open files and play
+ * them. Everything here is called from the audio thread only.
+ */
+class AudioBackend
+{
+  public:
+    virtual ~AudioBackend() {}
+
+    virtual const char* GetName() const = 0;
+    virtual bool Init() = 0;
+    virtual void Update() = 0;
+
+    // Opening may finish later; PollSounds reports when it does.
+    virtual void OpenSound( SoundHandle hSound, const std::string& strPath, bool b3d, bool bLooping, bool bStream ) = 0;
+    virtual void ReleaseSound( SoundHandle hSound ) = 0;
+    virtual void PollSounds( std::vector<SoundHandle>& vReady, std::vector<SoundHandle>& vFailed ) = 0;
+
+    virtual bool StartVoice( int nVoice, SoundHandle hSound, float fVolumedB, int nPriority, bool bPaused, const Vector3& vPosition ) = 0;
+    virtual void StopVoice( int nVoice ) = 0;
+    virtual void SetVoiceVolume( int nVoice, float fVolumedB ) = 0;
+    virtual void SetVoicePaused( int nVoice, bool bPaused ) = 0;
+    virtual void SetVoicePriority( int nVoice, int nPriority ) = 0;
+    virtual void SetVoicePosition( int nVoice, const Vector3& vPosition ) = 0;
+    // Voices whose sounds ran out on their own since the last call.
+    virtual void PollFinished( std::vector<int>& vVoices ) = 0;
+
+    virtual void SetListener( const Vector3& /*vPosition*/ ) {}
+
+    // FMOD Studio banks and events. Other backends don't have them.
+    virtual void LoadBank( const std::string& /*strBankName*/, unsigned /*flags*/ ) {}
+    virtual void LoadEvent( const std::string& /*strEventName*/ ) {}
+    virtual void PlayEvent( const std::string& /*strEventName*/ ) {}
+    virtual void StopEvent( const std::string& /*strEventName*/, bool /*bImmediate*/ ) {}
+    virtual void SetEventParameter( const std::string& /*strEventName*/, const std::string& /*strParameterName*/, float /*fValue*/ ) {}
+};
+
+AudioBackend* CreateAudioBackend( const std::string& strName );
+
+float dbToVolume(float db);
+float VolumeTodb(float volume);
+
+#endif
@@ -0,0 +1,99 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+
+#ifndef AUDIO_QUEUE_H
+#define AUDIO_QUEUE_H
+
+#include <atomic>
+#include <deque>
+#include <utility>
+#include <vector>
+
+/**********************************************************************/
+/**********************************************************************/
+/*! \brief
+ * Queue between exactly two threads: one pushes, the other pops, and
+ * neither ever takes a lock. Items pushed while the ring is full wait in an
+ * overflow list only the pushing thread touches, and go in on the next Push
+ * or Flush, so pushing never blocks and never drops anything.
+ */
+template <typename T>
+class AudioQueue
+{
+  public:
+    /*! \brief
+     * \param nCapacity
+     * Size of the ring. Must be a power of two.
+     */
+    explicit AudioQueue( size_t nCapacity ) : mRing( nCapacity ), mnMask( nCapacity - 1 ), mnHead( 0 ), mnTail( 0 )
+    {
+    }
+
+    /*! \brief
+     * Adds an item. Pushing thread only.
+     */
+    void Push( const T& item )
+    {
+      Flush();
+      if ( !mOverflow.empty() || !TryPush( item ) )
+      {
+        mOverflow.push_back( item );
+      }
+    }
+
+    /*! \brief
+     * Moves whatever is waiting in the overflow list into the ring, as far
+     * as it fits. Pushing thread only.
+     */
+    void Flush()
+    {
+      while ( !mOverflow.empty() && TryPush( mOverflow.front() ) )
+      {
+        mOverflow.pop_front();
+      }
+    }
+
+    /*! \brief
+     * Takes the oldest item out. Popping thread only.
+     * \return
+     * False if the queue was empty.
+     */
+    bool Pop( T& item )
+    {
+      size_t nHead = mnHead.load( std::memory_order_relaxed );
+      if ( nHead == mnTail.load( std::memory_order_acquire ) )
+      {
+        return false;
+      }
+      item = std::move( mRing[nHead & mnMask] );
+      mnHead.store( nHead + 1, std::memory_order_release );
+      return true;
+    }
+
+  private:
+    bool TryPush( const T& item )
+    {
+      size_t nTail = mnTail.load( std::memory_order_relaxed );
+      if ( nTail - mnHead.load( std::memory_order_acquire ) > mnMask )
+      {
+        return false;
+      }
+      mRing[nTail & mnMask] = item;
+      mnTail.store( nTail + 1, std::memory_order_release );
+      return true;
+    }
+
+    AudioQueue( const AudioQueue& ) = delete;
+    AudioQueue& operator=( const AudioQueue& ) = delete;
+
+    std::vector<T> mRing;
+    size_t mnMask;
+    alignas(64) std::atomic<size_t> mnHead;  // Next item to pop. Written by the popping thread.
+    alignas(64) std::atomic<size_t> mnTail;  // Next free slot. Written by the pushing thread.
+    std::deque<T> mOverflow;                 // Pushing thread only.
+};
+
+#endif
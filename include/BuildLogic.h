@@ -25,6 +25,7 @@ namespace Logic
   };
 
   ClickedFace::Faces GetClickedFace(glm::vec2 mousePos);
+  ClickedFace::Faces GetClickedFace(GameInstance * block, glm::vec2 mousePos);
 
   void OnBlockClicked(GameInstance * block, const Packet & payload);
 
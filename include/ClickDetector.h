@@ -7,8 +7,11 @@
 
 #include "GameInstance.h"
 #include "glm/glm/vec2.hpp"
+#include "glm/glm/mat4x4.hpp"
 #include "ParsedObjects.h"
+#include "DrawToken.h"
 #include <string>
+#include <vector>
 
 namespace Engine
 {
@@ -21,9 +24,28 @@ namespace Engine
     ClickDetector(GameInstance * owner, const ParsedObject & obj);
 
     const std::string & getMeshID() const { return meshId; }
+
+    void resetToken(const DrawToken & token);
   private:
+    friend class ClickDetectorHandler;
+
     std::string meshId;
-    
+
+    // Picking data, refreshed when the draw element's final matrix changes
+    DrawToken token_;
+    bool hasToken_ = false;
+    size_t stamp_ = 0;
+    glm::mat4 inverse_;
+    glm::vec2 min_;   // Screen space bounds
+    glm::vec2 max_;
+    bool onScreen_ = false;
+
+    // Picking grid cells the detector is listed in
+    bool inGrid_ = false;
+    int cellX0_ = 0;
+    int cellY0_ = 0;
+    int cellX1_ = 0;
+    int cellY1_ = 0;
   };
 
   class ClickDetectorHandler : public ComponentHandler
@@ -41,6 +63,18 @@ namespace Engine
     void ConnectEvents(Component * sub);
 
   private:
+    static const int PICK_GRID_SIZE = 32; // Cells per axis of the picking grid
+
+    bool refreshDetector(ClickDetector * detector, float ar);
+    void rebuildPickGrid();
+    void insertIntoGrid(ClickDetector * detector);
+    void removeFromGrid(ClickDetector * detector);
+    void getCellRange(const glm::vec2 & min, const glm::vec2 & max, int & x0, int & y0, int & x1, int & y1) const;
+
     unsigned long lastMousedOver_;
+
+    // Screen space grid of detectors whose bounds overlap each cell
+    std::vector<std::vector<ClickDetector *> > pickGrid_;
+    size_t indexedRevision_; // Component list revision the grid was built from
   };
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "Timer.h"
 //#include "structures.h"
 #include "Structure.h"
+#include "TextToken.h"
 
 namespace Engine
 {
@@ -33,6 +34,7 @@ namespace Engine
     std::vector<glm::vec3>& getPosition();
     std::vector<glm::vec3>& getID();
     STRUCT_LIST * getParsedStructs();
+    STRUCT_INDEX * getStructureIndex();
     OBJECT_BY_TILE_LIST* getBlocksAtTileList();
 
     void toggleAuto();
@@ -73,7 +75,6 @@ namespace Engine
     void onWaveChanged(const Packet & payload);
     void onSetHPFrame(const Packet & payload);
     void onSetResourceFrame(const Packet & paylaod);
-    void onStagePaused(const Packet & payload);
 
     bool isLost();
     bool isWon();
@@ -89,6 +90,7 @@ namespace Engine
     void positionsRequest(Packet& data);
     void IDRequest(Packet& data);
     void LSLRequest(Packet& data);
+    void LSIRequest(Packet& data);
     void tilePositionRequest(Packet& data);
     void tileBlocksRequest(Packet& data);
 
@@ -112,11 +114,14 @@ namespace Engine
     unsigned long waveTextId_;  // Instance ID of wave text
     unsigned long beginId_;
 
+    TextToken wallsText_;       // Label drawn over the ammo counter
+    TextToken healthText_;      // Label drawn over the health counter
+
     unsigned waveNum_;
     unsigned waveCount_;
 
-    Timer auto_timer_; // autoplay timer
-    Timer regen_timer_; // block regen timer
+    Timer auto_timer_; // autoplay timer, runs on the stage clock
+    Timer regen_timer_; // block regen timer, runs on the stage clock
 
     std::vector<glm::vec3> positions_;
     std::vector<glm::vec3> ID_;
@@ -125,6 +130,7 @@ namespace Engine
     OBJECT_BY_TILE_LIST BlocksAtTileList;
 
     STRUCT_LIST LoadedStructureList;
+    STRUCT_INDEX LoadedStructureIndex;
   };
 
   class ControllerHandler : public ComponentHandler
@@ -62,6 +62,20 @@ private:
   mutable glm::mat4 trans_;
 
   mutable bool needsUpdate_;
+
+  // Final matrix (group transform * modifier * element), cached by the group
+  mutable glm::mat4 final_;
+  mutable float finalAr_;
+  mutable size_t finalEpoch_;
+  mutable size_t finalStamp_;  // Unique per rebuild, lets users detect changes
+  mutable bool finalValid_;
+
+  // Screen space bounds of the mesh under the final matrix, refreshed with it
+  mutable glm::vec2 boundsMin_;
+  mutable glm::vec2 boundsMax_;
+  mutable bool onScreen_;
+
+  mutable bool baked_;  // Drawn from its group's static batches
   /*
   Ctor
 
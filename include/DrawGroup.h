@@ -14,6 +14,7 @@
 
 #include "DrawToken.h"
 #include "DrawElement.h"
+#include "StaticBatch.h"
 #include "Draw_fwd.h"
 
 class DrawGroup
@@ -40,11 +41,18 @@ public:
 
   DrawToken newElement(const RMesh * mesh, const DrawSurface * surface = nullptr);
 
-  void draw(Renderer & render);
+  void collect(RenderQueue & queue, Renderer & render, DrawLayer layer);
+
+  void setBaked(bool baked);
+  bool isBaked() const;
+
+  void setKeepOrder(bool keep);
 
   size_t getDrawOrder(size_t id) const;
   size_t size() const;
 
+  const glm::mat4 & getFinalMatrix(size_t id, float ar);
+
   /*
     Ctor
     Dtor
@@ -66,6 +74,8 @@ protected:
   DrawToken getToken(size_t id);
 
   DrawElement & getElement(size_t token);
+  DrawElement & getElementAttributes(size_t token);
+  DrawElement & getElementBatch(size_t token);
 
   /*
     Register/Deregister token
@@ -78,6 +88,18 @@ private:
   void sort();
   void scrub();
 
+  const DrawElement & peekElement(size_t token) const;
+  bool isFinalCurrent(const DrawElement & element, float ar) const;
+  void computeModifier(size_t id, const DrawElement & element, float ar, glm::mat4 & mod, glm::mat4 & local);
+  void updateFinalMatrices(float ar);
+  void storeFinal(const DrawElement & element, const glm::mat4 & final, float ar);
+
+  void bake(float ar);
+  bool rebuildChunk(size_t chunk, const glm::mat4 & refMod, float ar);
+  void updateBaked(float ar);
+  bool pushChunk(RenderQueue & queue, DrawLayer layer, uint32_t rank, size_t chunk) const;
+  StaticAttributes getAttributes(const DrawElement & element) const;
+
   struct DrawStruct
   {
     DrawStruct(DrawGroup * parent, const glm::vec2 & pos, const glm::vec2 & scale, float rot, const RMesh * mesh, const DrawSurface * surface, const glm::vec4 & shade);
@@ -87,6 +109,10 @@ private:
 
   std::unordered_map<size_t, DrawStruct> objects_;
   std::vector<size_t> drawOrder_;
+
+  // Position of each element in drawOrder_, rebuilt lazily after it changes
+  mutable std::unordered_map<size_t, size_t> orderIndex_;
+  mutable bool orderDirty_;
   /*
   Sort
 
@@ -96,8 +122,40 @@ private:
 
   */
   glm::mat4 global_;
+  size_t epoch_;    // Bumped whenever every cached final matrix goes stale
   size_t total_;
   COMPFUNC sorter_;
   MODFUNC modifier_;
+  bool keepOrder_;  // Elements the sorter can't order still keep creation order
+
+  // Scratch space for rebuilding final matrices in one pass
+  std::vector<size_t> dirtyIds_;
+  std::vector<glm::mat4> modBatch_;
+  std::vector<glm::mat4> localBatch_;
+
+  struct BakedSlot
+  {
+    size_t chunk;
+    size_t index;
+  };
+
+  static const size_t BAKE_CHUNK_SIZE = 1024; // Most elements in one static batch
+
+  // Baked groups keep elements in static batches. Each batch is a run of
+  // consecutive elements in draw order sharing a mesh and surface, and is drawn
+  // at the rank of its first element so the layer's order is kept. Moving an
+  // element only rebuilds its own batch, while adding or removing elements or
+  // changing a mesh, surface or scale reference bakes the group again. Only
+  // elements sharing the modifier of the reference element are baked, the
+  // rest are drawn normally
+  bool baked_;
+  bool bakeDirty_;
+  size_t bakedRef_;
+  glm::mat4 bakedGroup_;  // Transformation of every batch, from the reference element
+  std::vector<std::unique_ptr<StaticBatch> > chunks_;
+  std::vector<std::vector<size_t> > chunkIds_;  // Elements of each batch, in draw order
+  std::unordered_map<size_t, BakedSlot> bakedSlots_;
+  std::vector<size_t> attributeDirty_;  // Baked elements whose shade or frame changed
+  std::vector<size_t> transformDirty_;  // Baked elements that were moved
 };
 
@@ -10,7 +10,11 @@
 #include <memory>
 
 #include "Renderer.h"
+#include "PickBuffer.h"
+#include "RenderQueue.h"
 #include "DrawGroup.h"
+#include "TextBatch.h"
+#include "Font.h"
 //#include "RMesh.h"
 #include "Texture.h"
 #include "Draw_fwd.h"
@@ -28,9 +32,11 @@ public:
 
   const Texture * getTexture(const std::string & name) const;
   const RMesh * getMesh(const std::string & name) const;
+  const Font * getFont(const std::string & name) const;
 
   void loadMesh(const std::string & name, const RMesh & mesh);
   void loadTexture(const std::string & name, const std::string & path, size_t frames = 1);
+  void loadFont(const std::string & name, const std::string & path, unsigned pixelSize = 48);
   
   void loadVertexShader(const std::string & name, const std::string & path);
   void loadFragmentShader(const std::string & name, const std::string & path);
@@ -55,6 +61,7 @@ public:
 
   size_t getViewWidth() const;
   size_t getViewHeight() const;
+  float getAspectRatio() const;
   size_t getViewOffsetX() const;
   size_t getViewOffsetY() const;
 
@@ -70,16 +77,33 @@ public:
 
   DrawToken newElement(DrawLayer layer, const std::string & mesh, const std::string & surface = "");
 
+  bool loadTextShaders(const std::string & vertexPath, const std::string & fragmentPath);
+  TextToken newText(DrawLayer layer, const std::string & font);
+
   void update();
   void swap(float r, float g, float b, float a = 1.f);
 
+  bool loadPickShaders(const std::string & vertexPath, const std::string & fragmentPath);
+
+  void setGPUPicking(bool enabled);
+  bool isGPUPicking() const;
+
+  void setPickPoint(const glm::vec2 & ndc);
+  void queuePick(const RMesh * mesh, const glm::mat4 & mat, unsigned long id, size_t order);
+  bool getPickResult(unsigned long & id, unsigned & face) const;
+
 private:
   
   Renderer render_;
+  RenderQueue queue_;
+  PickBuffer picker_;
+  bool gpuPicking_;
 
   RES_MAP<DrawLayer, DrawGroup> layers_;
   RES_MAP<std::string, RMesh> meshes_;
   RES_MAP<std::string, Shader> vertexShaders_;
   RES_MAP<std::string, Shader> fragmentShaders_;
   RES_MAP<std::string, Texture> textures_;
+  RES_MAP<std::string, Font> fonts_;
+  RES_MAP<DrawLayer, TextBatch> text_;
 };
\ No newline at end of file
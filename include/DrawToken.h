@@ -9,6 +9,8 @@
 #include "glm/glm/mat4x4.hpp"
 #include "Draw_fwd.h"
 
+struct DrawElement;
+
 class DrawToken
 {
 public:
@@ -27,6 +29,7 @@ public:
 
   glm::mat4 getMatrix(float ar) const;
   glm::mat4 getFinalMatrix(float ar) const;
+  size_t getFinalStamp() const;
 
   glm::vec4 getShade() const;
 
@@ -97,6 +100,8 @@ private:
   void registerMe();
   void deregisterMe();
 
+  const DrawElement & element() const;
+
 
   size_t id_;
 
@@ -82,6 +82,7 @@ namespace DrawUtils
   void R_InitLayers(DrawSystem & sys);
   void R_InitShaders(DrawSystem & sys);
   void R_LoadMeshes(DrawSystem & sys);
+  void R_LoadFonts(DrawSystem & sys);
 
   std::vector<IMGINFO> R_GetPreloads(DrawSystem & sys);
 
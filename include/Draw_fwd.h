@@ -35,6 +35,11 @@ enum class ScaleReference { XX, XY, YY };
 using DrawLayer = unsigned;
 
 class Renderer;
+class RenderQueue;
+class StaticBatch;
+class TextBatch;
+class TextToken;
+class Font;
 class Shader;
 class RMesh;
 class DrawSurface;
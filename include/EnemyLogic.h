@@ -9,6 +9,8 @@
 #include "../include/object_stats.h"
 #include "../include/Physics.h"
 #include "../include/grid.h"
+#include "../include/Transform.h"
+#include "../include/EnemyPathing.h"
 
 
 namespace Engine
@@ -38,12 +40,31 @@ namespace Engine
     virtual ~EnemyLogicHandler() {};
     void update();
     void ConnectEvents( Component * base_sub );
-    void Pathing( EnemyLogic& Enemy );
 
     static void EnemyHealthFlagRequest( const EnemyLogic* member, Packet& data );
     static void EnemyPathingFlagRequest( const EnemyLogic* member, Packet& data );
     static void EnemyAttackFlagRequest( const EnemyLogic* member, Packet& data );
     static void EnemyCollisionFlagRequest( const EnemyLogic* member, Packet& data );
+
+  private:
+    void UpdateLevelConstants();
+    void GatherPathing();
+    void RunPathing();
+    void ApplyPathing();
+
+    /* Pathing state of every enemy, gathered each frame so the Path* functions 
+       run over contiguous arrays. Indexed like componentList_. */
+    std::vector<EnemyLogic *> pathEnemies_;
+    std::vector<Physics *> pathPhysics_;
+    std::vector<unsigned> pathFlags_;
+    std::vector<glm::vec2> pathPositions_;
+    std::vector<movement> pathMovement_;
+    std::vector<unsigned char> pathReachedEnd_;
+
+    /* Level constants, only recomputed when the grid's layout changes. */
+    float xmax_;
+    unsigned gridRevision_;
+    bool levelCached_;
   };
 
   class EnemyLogic : public Component
@@ -68,7 +89,13 @@ namespace Engine
     void SetEnemyCollisionFlag( unsigned val );
     void SetEnemyHealthFlag( unsigned val );
     void SetEnemyPathingFlag( unsigned val );
+
+    Physics * GetPhysics();
+    Transform * GetTransform();
   private:
+    Physics * physics_;     // Cached on first use
+    Transform * transform_;
+
     unsigned EnemyAttackFlag;
     unsigned EnemyCollisionFlag;
     unsigned EnemyHealthFlag;
@@ -13,9 +13,10 @@ typedef std::pair<glm::vec2, glm::vec2> movement;
 
 namespace Engine
 {
-    movement PathNormal( const movement& data);
+    // forward is the unit direction the enemy's path goes in
+    movement PathNormal( const movement& data, const glm::vec2& forward = glm::vec2(1, 0) );
     movement PathSwitchLane( const movement& data );
-    movement PathFast( const movement& data);
-    movement PathAccel( const movement& data);
+    movement PathFast( const movement& data, const glm::vec2& forward = glm::vec2(1, 0) );
+    movement PathAccel( const movement& data, const glm::vec2& forward = glm::vec2(1, 0) );
     movement PathBump( const movement& data);
 }
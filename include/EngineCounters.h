@@ -0,0 +1,42 @@
+// Primary Author : agent
+//
+// © Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright © Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace Engine
+{
+  /****************************************************************************/
+  /*!
+    \brief
+      Named per-frame values that systems can report for debugging. Counters
+      are zeroed at the start of every frame by the GSM, so systems should
+      add what they did that frame. Values are shown in the imgui debug panel
+  */
+  /****************************************************************************/
+  class EngineCounters
+  {
+  public:
+    static void NewFrame();
+
+    static void Add(const std::string & name, double value = 1);
+    static void Set(const std::string & name, double value);
+    static double Get(const std::string & name);
+
+    static const std::map<std::string, double> & GetAll();
+
+  private:
+    static EngineCounters & get();
+
+    EngineCounters() {}
+
+    EngineCounters(const EngineCounters &) = delete;
+    EngineCounters & operator=(const EngineCounters &) = delete;
+
+    std::map<std::string, double> counters_;
+  };
+}
@@ -0,0 +1,66 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+#include <vector>
+#include "glm/glm/glm.hpp"
+
+namespace Engine
+{
+  /****************************************************************************/
+  /*!
+    \brief
+      Navigation field over the grid. Every open tile stores its distance to
+      the right edge of the grid and the neighbor to step to next, so any
+      number of enemies can look up where to go without searching. When a
+      tile is blocked or cleared, only the tiles whose routes change are
+      recomputed.
+  */
+  /****************************************************************************/
+  class FlowField
+  {
+  public:
+    static const int UNREACHABLE = 0x7fffffff;
+
+    FlowField();
+
+    void Rebuild(int width, int height, const std::vector<int> & heights);
+    void SetBlocked(int x, int y, bool blocked);
+
+    glm::ivec2 GetDirection(int x, int y) const;
+    int GetDistance(int x, int y) const;
+    bool IsBlocked(int x, int y) const;
+
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+    int GetCycles() const { return cycles_; }
+
+  private:
+    static const unsigned char NO_DIRECTION = 4;
+
+    typedef std::pair<int, int> QueueEntry;   // Distance, cell
+
+    int CellIndex(int x, int y) const { return y * width_ + x; }
+    bool IsGoal(int cell) const { return cell % width_ == width_ - 1; }
+    int Neighbor(int cell, int direction) const;
+
+    void Propagate(std::vector<QueueEntry> & queue);
+    void Touch(int cell);
+    void UpdateDirection(int cell);
+    void UpdateTouchedDirections();
+
+    int width_;
+    int height_;
+    int cycles_;                           // Tiles visited by the last update
+
+    std::vector<int> distance_;            // Steps to the right edge, row major
+    std::vector<unsigned char> direction_; // Neighbor to step to next
+    std::vector<bool> blocked_;
+
+    std::vector<int> touched_;             // Tiles changed by the current update
+    std::vector<unsigned> touchedMark_;
+    unsigned updateId_;
+  };
+}
@@ -0,0 +1,88 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+
+#ifndef FMOD_BACKEND_H
+#define FMOD_BACKEND_H
+
+#include "AudioBackend.h"
+
+#ifdef AUDIO_FMOD
+#include <map>
+
+//#pragma warning (push)
+//#pragma warning (disable : 4201)
+#include "../include/fmod/fmod.hpp"
+#include "../include/fmod/fmod_dsp.h"
+#include "../include/fmod/fmod_common.h"
+#include "../include/fmod/fmod_errors.h"
+#include "../include/fmod/fmod_studio.hpp"
+//#pragma warning (pop)
+
+/**********************************************************************/
+/**********************************************************************/
+/*! \brief
+ * Plays sounds through FMOD, and is the only backend with Studio banks and
+ * events. Sounds are opened with FMOD_NONBLOCKING so they load on FMOD's
+ * own thread.
+ */
+class FmodBackend : public AudioBackend
+{
+  public:
+    FmodBackend();
+    ~FmodBackend();
+
+    const char* GetName() const { return "fmod"; }
+    bool Init();
+    void Update();
+
+    void OpenSound( SoundHandle hSound, const std::string& strPath, bool b3d, bool bLooping, bool bStream );
+    void ReleaseSound( SoundHandle hSound );
+    void PollSounds( std::vector<SoundHandle>& vReady, std::vector<SoundHandle>& vFailed );
+
+    bool StartVoice( int nVoice, SoundHandle hSound, float fVolumedB, int nPriority, bool bPaused, const Vector3& vPosition );
+    void StopVoice( int nVoice );
+    void SetVoiceVolume( int nVoice, float fVolumedB );
+    void SetVoicePaused( int nVoice, bool bPaused );
+    void SetVoicePriority( int nVoice, int nPriority );
+    void SetVoicePosition( int nVoice, const Vector3& vPosition );
+    void PollFinished( std::vector<int>& vVoices );
+
+    void SetListener( const Vector3& vPosition );
+
+    void LoadBank( const std::string& strBankName, unsigned flags );
+    void LoadEvent( const std::string& strEventName );
+    void PlayEvent( const std::string& strEventName );
+    void StopEvent( const std::string& strEventName, bool bImmediate );
+    void SetEventParameter( const std::string& strEventName, const std::string& strParameterName, float fValue );
+
+    static int ErrorCheck( FMOD_RESULT result );
+
+  private:
+    static FMOD_RESULT F_CALLBACK EndOfSound(FMOD_CHANNELCONTROL *chanControl,
+                                         FMOD_CHANNELCONTROL_TYPE controlType,
+                                         FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType,
+                                         void *commandData1,
+                                         void *commandData2);
+
+    FMOD::Studio::System* mpStudioSystem;
+    FMOD::System* mpSystem;
+
+    typedef std::map<std::string, FMOD::Studio::EventInstance*> EventMap;
+    typedef std::map<std::string, FMOD::Studio::Bank*> BankMap;
+
+    BankMap mBanks;
+    EventMap mEvents;
+
+    std::vector<FMOD::Sound*> mSounds;     // Indexed by SoundHandle.
+    std::vector<SoundHandle> mOpening;     // Still loading on FMOD's thread.
+    FMOD::Channel* mChannels[AUDIO_MAX_VOICES];
+    std::vector<int> mFinished;            // Filled by EndOfSound during update.
+};
+
+FMOD_VECTOR VectorToFmod(const Vector3& vPosition);
+
+#endif
+#endif
@@ -0,0 +1,69 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+
+#include "glm/glm/vec2.hpp"
+
+#include "DrawSurface.h"
+#include "Draw_fwd.h"
+
+/**
+* \brief  Glyph atlas of a font, stored as a signed distance field so one atlas
+*         stays sharp at any text size. Covers printable ASCII.
+*/
+class Font : public DrawSurface
+{
+public:
+  struct Glyph
+  {
+    glm::vec2 offset;   // Top left of the quad from the pen, in pixels (y up)
+    glm::vec2 size;     // Quad size in pixels
+    glm::vec2 uvMin;
+    glm::vec2 uvMax;
+    float advance;
+  };
+
+  Font(const std::string & path, unsigned pixelSize = 48);
+  Font(const Font &) = delete;
+  Font & operator=(const Font &) = delete;
+
+  virtual ~Font();
+
+  void bind() const override;
+  void unbind() const override;
+
+  bool isLoaded() const;
+
+  const Glyph * getGlyph(char c) const;
+
+  float getPixelSize() const;
+  float getAscent() const;
+  float getDescent() const;
+
+  static const int SPREAD = 6;  // Distance in pixels covered by the field on each side of an edge
+
+private:
+  static const char FIRST_CHAR = 32;
+  static const char LAST_CHAR = 126;
+
+  void uploadAtlas() const;
+
+  std::string path_;
+  float pixelSize_;
+  float ascent_;
+  float descent_;
+
+  std::vector<Glyph> glyphs_;
+  std::vector<unsigned char> atlas_;
+  int atlasWidth_;
+  int atlasHeight_;
+
+  mutable GLuint texture_ = NULL;
+};
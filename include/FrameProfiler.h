@@ -0,0 +1,155 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Engine
+{
+  /****************************************************************************/
+  /*!
+    \brief
+      Log-linear histogram of durations in microseconds. Each power of two
+      is split into 32 linear buckets, so any recorded value is reported
+      within about 3% no matter how large it is
+  */
+  /****************************************************************************/
+  class FrameHistogram
+  {
+  public:
+    FrameHistogram();
+
+    void Clear();
+    void Record(uint64_t micros);
+
+    uint64_t Percentile(double percent) const;
+    uint64_t Max() const { return max_; }
+    uint64_t Count() const { return count_; }
+    double Mean() const;
+
+  private:
+    static const unsigned SUB_BUCKETS = 64;
+    static const unsigned HALF_BUCKETS = SUB_BUCKETS / 2;
+    static const unsigned MAX_SHIFT = 36;
+    static const unsigned BUCKET_COUNT = SUB_BUCKETS + MAX_SHIFT * HALF_BUCKETS;
+
+    static unsigned BucketIndex(uint64_t micros);
+    static uint64_t BucketValue(unsigned index);
+
+    std::array<uint32_t, BUCKET_COUNT> counts_;
+    uint64_t count_;
+    uint64_t total_;
+    uint64_t max_;
+  };
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Frame time statistics over some number of frames, in milliseconds
+  */
+  /****************************************************************************/
+  struct FrameStats
+  {
+    size_t frames;
+    double mean;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+  };
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Records how long every frame took with a nanosecond clock, along with
+      how long named sections of the frame took. Frames that run over the
+      stutter threshold are kept in a log with their section timings
+  */
+  /****************************************************************************/
+  class FrameProfiler
+  {
+  public:
+    static const size_t MAX_SECTIONS = 16;
+    static const size_t HISTORY_SIZE = 3600;
+    static const size_t STUTTER_LOG_SIZE = 128;
+
+    struct FrameSample
+    {
+      uint64_t frame;
+      uint64_t total;                               // Nanoseconds
+      std::array<uint64_t, MAX_SECTIONS> sections;  // Nanoseconds, indexed like GetSectionNames
+    };
+
+    /**************************************************************************/
+    /*!
+      \brief
+        Times a section of the current frame from construction until Stop is
+        called or it goes out of scope
+    */
+    /**************************************************************************/
+    class Section
+    {
+    public:
+      explicit Section(const char * name);
+      ~Section();
+
+      Section(const Section &) = delete;
+      Section & operator=(const Section &) = delete;
+
+      void Stop();
+
+    private:
+      const char * name_;
+      uint64_t start_;
+      bool running_;
+    };
+
+    static uint64_t Now();
+
+    static void EndFrame(uint64_t frameNanos);
+    static void AddSection(const char * name, uint64_t nanos);
+
+    static FrameStats GetWindowStats(size_t frames);
+    static FrameStats GetLifetimeStats();
+    static void ResetStats();
+
+    static FrameStats MakeStats(const FrameHistogram & histogram);
+
+    static void SetStutterThreshold(double millis);
+    static double GetStutterThreshold();
+
+    static const std::vector<std::string> & GetSectionNames();
+    static const std::deque<FrameSample> & GetHistory();
+    static const std::deque<FrameSample> & GetStutters();
+
+    static bool ExportCSV(const std::string & framesPath, const std::string & stuttersPath);
+
+  private:
+    static FrameProfiler & get();
+
+    FrameProfiler();
+
+    FrameProfiler(const FrameProfiler &) = delete;
+    FrameProfiler & operator=(const FrameProfiler &) = delete;
+
+    static bool WriteSamples(const std::string & path, const std::deque<FrameSample> & samples);
+
+    FrameSample current_;
+    uint64_t frameCount_;
+    uint64_t stutterThreshold_;
+
+    std::vector<std::string> sectionNames_;
+    std::deque<FrameSample> history_;
+    std::deque<FrameSample> stutters_;
+
+    FrameHistogram lifetime_;
+    FrameHistogram window_;   // Scratch for window stats
+  };
+}
@@ -13,7 +13,6 @@
 #include "DrawSystem.h"
 //#include "Transform.h"
 //#include "Physics.h"
-//#include "GraphicsPipeline.h"
 //#include "grid.h"
 #include "Stage.h"
 
@@ -96,7 +95,6 @@ namespace Engine
     std::unique_ptr<DrawSystem> renderer_;
     Messenger mess_;
     Camera cam_;
-    //GFXPipe & gfxPipe_;
 	  //Grid grid_;
   };
 }
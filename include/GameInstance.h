@@ -203,6 +203,7 @@ namespace Engine
     virtual void ConnectEvents(Component * sub) = 0;
 
     std::vector<Component *> componentList_;
+    size_t listRevision_; // Bumped whenever componentList_ gains or loses a component
     const std::string & getComponentHandlerType() const;
     std::vector<std::string> dependencies_;
 
@@ -211,6 +212,10 @@ namespace Engine
   private:
     const std::string handlerType_;
     bool isPausable_;
+
+    // Script event names, built once instead of per component each frame
+    const std::string preUpdateEvent_;
+    const std::string updateEvent_;
   };
 
   struct instance_not_found : public std::exception
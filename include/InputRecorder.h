@@ -0,0 +1,79 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <SDL2/SDL_events.h>
+
+#include "FrameProfiler.h"
+
+class Display;
+
+namespace Engine
+{
+  /****************************************************************************/
+  /*!
+    \brief
+      Writes the input of every frame to a binary log, along with the frame's
+      time and the seed random numbers were drawn from. Replaying a log feeds
+      the same input, frame times and seeds back in place of the live ones,
+      so a recorded session plays out the same way every time and can be
+      used as a benchmark.
+
+      Log layout (little endian):
+        header : "RFIN", u16 version, u16 reserved
+        frame  : u32 frame ns, f32 dt, u32 seed, u16 event count, events
+        event  : u8 type, then u16 scancode (keys), u8 button (mouse
+                 buttons), i16 y (wheel) or i16 x, i16 y (motion)
+  */
+  /****************************************************************************/
+  class InputRecorder
+  {
+  public:
+    static bool StartRecording(const std::string & path);
+    static bool StartReplay(const std::string & path, bool exitWhenDone = false);
+    static void Stop();
+
+    static bool IsRecording();
+    static bool IsReplaying();
+
+    static bool FilterEvent(const SDL_Event & event);
+    static void EndFrame(Display & disp);
+
+  private:
+    enum Mode { IDLE, RECORDING, REPLAYING };
+
+    static InputRecorder & get();
+
+    InputRecorder();
+
+    InputRecorder(const InputRecorder &) = delete;
+    InputRecorder & operator=(const InputRecorder &) = delete;
+
+    void recordFrame(Display & disp);
+    void replayFrame(Display & disp);
+    void applyEvent(uint8_t type, const uint8_t * data);
+    void reportBenchmark() const;
+
+    Mode mode_;
+    FILE * file_;
+
+    std::vector<uint8_t> events_;   // Events recorded so far this frame
+    uint16_t eventCount_;
+    bool applying_;                 // Replayed events are being fed to the input system
+
+    std::mt19937 seeds_;            // Draws the seed for each recorded frame
+    uint64_t lastClock_;            // Frame clock at the end of the last frame
+    uint64_t replayClock_;          // Frame clock rebuilt from the replayed frame times
+
+    bool exitWhenDone_;
+    FrameHistogram frameTimes_;     // Real time each replayed frame took
+  };
+}
@@ -25,6 +25,7 @@ namespace Engine
     Level(const Level&) = delete;
     Level& operator=(const Level&) = delete;
     std::vector<std::string> objects;
+    std::string waves_;           // Wave definition file, empty if the level has none
     static const Json::Value defValue;
     int index_;
   };
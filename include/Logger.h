@@ -5,23 +5,60 @@
 // ---------------------------------------------------------------------------------
 
 /* 
-To link to this, set your include dirrectorys to look for 'Logger.lib',
-which should be in the projects libs/ folder; running it requires the
-'Logger.dll' dll, which can be found in the projects dlls/ folder.
-
-If you are missing the library or DLL file, or if they don't work on your
-machine, you can build it with the project solution found in the Logger/ folder
+The game compiles Logger/Logger.cpp into its own executable with
+LOGGER_STATIC defined, so no library or DLL is needed. Other programs can
+still build the Logger/ sources as a DLL with LOGGER_EXPORTS defined and
+link to it as before
 */
 #pragma once
 #include <stdio.h>
 #include <cstdarg>
+#include <type_traits>
 
-#ifdef LOGGER_EXPORTS
+#if defined(LOGGER_STATIC)
+#define LOGGER_API
+#elif defined(LOGGER_EXPORTS)
 #define LOGGER_API __declspec(dllexport)
 #else
 #define LOGGER_API __declspec(dllimport)
 #endif
 
+// Levels that log calls are compiled in for, as a plain number so the
+// preprocessor can test it (0x001 info, 0x002 warning, 0x004 error). Release
+// builds keep errors only.
+//
+// The LOGGER_INFO, LOGGER_WARNING and LOGGER_ERROR macros expand to nothing
+// for a stripped level, arguments included. Log<T> calls for a stripped
+// level go to an empty inline function instead, but their arguments are
+// still evaluated, so use the macros where the arguments cost something
+#ifndef LOG_COMPILED_LEVELS
+#ifdef NDEBUG
+#define LOG_COMPILED_LEVELS 0x004
+#else
+#define LOG_COMPILED_LEVELS (~0)
+#endif
+#endif
+
+// Each level also matches the bits of the levels it derives from, see Info,
+// Warning and Error below
+#if (LOG_COMPILED_LEVELS) & 0x001
+#define LOGGER_INFO(...) ((void)Logger::Log<Logger::Info>(__VA_ARGS__))
+#else
+#define LOGGER_INFO(...) ((void)0)
+#endif
+
+#if (LOG_COMPILED_LEVELS) & 0x003
+#define LOGGER_WARNING(...) ((void)Logger::Log<Logger::Warning>(__VA_ARGS__))
+#else
+#define LOGGER_WARNING(...) ((void)0)
+#endif
+
+#if (LOG_COMPILED_LEVELS) & 0x007
+#define LOGGER_ERROR(...) ((void)Logger::Log<Logger::Error>(__VA_ARGS__))
+#else
+#define LOGGER_ERROR(...) ((void)0)
+#endif
+
 /******************************************************************************/
 /*!
   \brief 
@@ -36,6 +73,9 @@ machine, you can build it with the project solution found in the Logger/ folder
 
     Messages will only be logged if their logging level is set with
     Set_Priority. If Set_Priority is set to 0, no messages will be logged
+
+    Messages are formatted on the calling thread and queued; a background
+    thread timestamps them and writes them to the log file
 */
 /******************************************************************************/
 namespace Logger
@@ -48,6 +88,11 @@ namespace Logger
     LOG_ALL = ~0
   };
 
+  enum LogOverflow {
+    LOG_OVERFLOW_DROP,    // Drop messages while the queue is full
+    LOG_OVERFLOW_BLOCK    // Wait for the writer to make room
+  };
+
   /****************************************************************************/
   /*!
     \brief 
@@ -112,7 +157,8 @@ namespace Logger
   */
   /****************************************************************************/
   template <typename T> 
-  int Log(const char * format, ...)
+  typename std::enable_if<(T::level & LOG_COMPILED_LEVELS) != 0, int>::type
+  Log(const char * format, ...)
   {
     va_list args;
     //const char * format = message.c_str();
@@ -125,6 +171,14 @@ namespace Logger
     return written;
   }
 
+  // Levels stripped by LOG_COMPILED_LEVELS
+  template <typename T> 
+  typename std::enable_if<(T::level & LOG_COMPILED_LEVELS) == 0, int>::type
+  Log(const char *, ...)
+  {
+    return 0;
+  }
+
   /****************************************************************************/
   /*!
     \brief 
@@ -166,4 +220,38 @@ namespace Logger
   */
   /****************************************************************************/
   LOGGER_API void Set_Logfile(const char * logFile);
+
+  /****************************************************************************/
+  /*!
+    \brief 
+      Sets what happens to messages logged while the queue is full. Defaults
+      to LOG_OVERFLOW_DROP. Messages with the LOG_ERROR bit always wait
+  */
+  /****************************************************************************/
+  LOGGER_API void Set_Overflow(int policy);
+
+  /****************************************************************************/
+  /*!
+    \brief 
+      Gets the number of messages dropped because the queue was full
+  */
+  /****************************************************************************/
+  LOGGER_API unsigned long long Get_Dropped();
+
+  /****************************************************************************/
+  /*!
+    \brief 
+      Blocks until every message logged so far has been written
+  */
+  /****************************************************************************/
+  LOGGER_API void Flush();
+
+  /****************************************************************************/
+  /*!
+    \brief 
+      Writes any queued messages and stops the writer thread. Messages logged
+      afterwards are written immediately on the calling thread
+  */
+  /****************************************************************************/
+  LOGGER_API void Shutdown();
 }
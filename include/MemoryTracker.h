@@ -0,0 +1,97 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Engine
+{
+  // Subsystems memory is counted under
+  enum class MemoryTag
+  {
+    Other,
+    ECS,
+    Render,
+    Scripting,
+    Assets,
+    Audio,
+
+    Count
+  };
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Memory use of one subsystem. Frame values are for the last finished
+      frame
+  */
+  /****************************************************************************/
+  struct MemoryStats
+  {
+    int64_t live;         // Bytes
+    int64_t peak;         // Bytes
+    uint64_t allocs;      // Since startup
+    uint64_t frameAllocs;
+    uint64_t frameFrees;
+    uint64_t frameBytes;  // Bytes allocated
+  };
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Counts heap memory per subsystem. Every allocation made with new is
+      counted under the tag of the innermost MemoryScope on its thread, and
+      remembers that tag so it is taken off the right subsystem when freed.
+      Heaps that don't go through new (Lua, FMOD) use Allocate and Free with
+      a tag of their own. Defining ENGINE_NO_MEMORY_TRACKING leaves new
+      alone, and only those heaps are counted
+  */
+  /****************************************************************************/
+  class MemoryTracker
+  {
+  public:
+    static const size_t TAG_COUNT = static_cast<size_t>(MemoryTag::Count);
+
+    /**************************************************************************/
+    /*!
+      \brief
+        Counts allocations made on this thread under a tag until Stop is
+        called or it goes out of scope
+    */
+    /**************************************************************************/
+    class Scope
+    {
+    public:
+      explicit Scope(MemoryTag tag);
+      ~Scope();
+
+      Scope(const Scope &) = delete;
+      Scope & operator=(const Scope &) = delete;
+
+      void Stop();
+
+    private:
+      MemoryTag previous_;
+      bool running_;
+    };
+
+    static void * Allocate(size_t size, MemoryTag tag);
+    static void * Reallocate(void * ptr, size_t size, MemoryTag tag);
+    static void Free(void * ptr);
+
+    static MemoryTag CurrentTag();
+
+    static void NewFrame();
+
+    static MemoryStats GetStats(MemoryTag tag);
+    static const char * GetTagName(MemoryTag tag);
+
+    static void LogReport();
+    static bool ExportCSV(const std::string & path);
+  };
+}
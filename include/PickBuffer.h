@@ -0,0 +1,92 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+#include <GL/glew.h>
+
+#include <vector>
+#include <unordered_map>
+
+#include "glm/glm/vec2.hpp"
+#include "glm/glm/mat4x4.hpp"
+
+#include "Draw_fwd.h"
+
+/**
+* \brief  Face of an isometric block mesh written alongside a picked id
+*/
+enum PickFace { PF_NONE, PF_TOP, PF_LEFT, PF_RIGHT };
+
+/**
+* \brief  Offscreen integer target that meshes are rendered into with their
+*         instance id, so a single pixel read resolves what is under the cursor.
+*         The pixel is read into a pixel buffer and only mapped a frame later,
+*         so the result never stalls the pipeline.
+*/
+class PickBuffer
+{
+public:
+  PickBuffer();
+  ~PickBuffer();
+
+  PickBuffer(const PickBuffer &) = delete;
+  PickBuffer & operator=(const PickBuffer &) = delete;
+
+  bool init(const Shader & vertex, const Shader & fragment, size_t width, size_t height);
+  void clean();
+
+  void resize(size_t width, size_t height);
+
+  void setPoint(const glm::vec2 & ndc);
+  void queue(const RMesh * mesh, const glm::mat4 & mat, unsigned id, size_t order);
+  void releaseMesh(const RMesh * mesh);
+  void render(const Renderer & render);
+
+  bool getResult(unsigned & id, unsigned & face) const;
+  bool isReady() const;
+
+private:
+  struct PickItem
+  {
+    const RMesh * mesh;
+    glm::mat4 mat;
+    unsigned id;
+    size_t order;
+  };
+
+  struct MeshBuffers
+  {
+    GLuint vao;
+    GLuint vbo;
+    GLuint ibo;
+    GLsizei count;
+  };
+
+  void createTarget();
+  void destroyTarget();
+  const MeshBuffers & getBuffers(const RMesh * mesh);
+  void readResult(unsigned slot);
+
+  size_t width_;
+  size_t height_;
+  glm::vec2 point_;
+
+  GLuint program_;
+  GLuint fbo_;
+  GLuint target_;
+  GLuint pbo_[2];
+  GLsync fence_[2];
+  unsigned slot_;
+
+  GLint transformLocation_;
+  GLint idLocation_;
+
+  std::vector<PickItem> queue_;
+  std::unordered_map<const RMesh *, MeshBuffers> buffers_;
+
+  unsigned resultId_;
+  unsigned resultFace_;
+  bool hasResult_;
+};
@@ -4,6 +4,8 @@
 // FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
 // ---------------------------------------------------------------------------------
 #pragma once
+#include <GL/glew.h>
+
 #include "glm/glm/vec4.hpp"
 #include "glm/glm/vec3.hpp"
 #include "glm/glm/vec2.hpp"
@@ -59,6 +61,8 @@ public:
   std::vector<Vertex> verts;
   std::vector<Tri> tris;
 
+  GLenum drawMode = GL_TRIANGLES; // Primitive type the indices are drawn as
+
 protected:
   void getPlanes();
 
@@ -0,0 +1,81 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+#include "glm/glm/vec4.hpp"
+#include "glm/glm/mat4x4.hpp"
+
+#include "Renderer.h"
+#include "Draw_fwd.h"
+
+/**
+* \brief  Flat list of everything drawn in a frame. Packets from every layer are
+*         sorted by one 64 bit key and consecutive packets sharing a mesh and
+*         surface are submitted as a single instanced draw.
+*
+*         Key layout, most significant first:
+*           layer (8) | rank (32) | shader (4) | texture (12) | mesh (8)
+*
+*         The rank is the element's place in its group's draw order, where
+*         elements the group's sorter considers equal share a rank and so are
+*         free to be reordered by texture and mesh, unless the group keeps
+*         creation order as the UI layers do. Text is drawn after
+*         everything else in its layer with its own program.
+*/
+class RenderQueue
+{
+public:
+  RenderQueue();
+
+  RenderQueue(const RenderQueue &) = delete;
+  RenderQueue & operator=(const RenderQueue &) = delete;
+
+  void clear();
+
+  void push(DrawLayer layer, uint32_t rank,
+    const RMesh * mesh, const DrawSurface * surface,
+    const glm::mat4 & mat, const glm::vec4 & shade, unsigned frame);
+
+  void pushStatic(DrawLayer layer, uint32_t rank, const StaticBatch * batch, const glm::mat4 & group);
+  void pushText(DrawLayer layer, const TextBatch * text, const glm::mat4 & group);
+
+  void sort();
+  void submit(Renderer & render);
+
+  size_t size() const;
+
+private:
+  struct DrawPacket
+  {
+    const RMesh * mesh;
+    const DrawSurface * surface;
+    const StaticBatch * batch;  // Drawn on its own with the packet's transform when set
+    const TextBatch * text;     // Same as batch, but with the text program
+  };
+
+  unsigned getResourceId(std::unordered_map<const void *, unsigned> & ids, const void * res);
+  uint64_t makeKey(DrawLayer layer, uint32_t rank, unsigned shader, const RMesh * mesh, const DrawSurface * surface);
+
+  std::vector<uint64_t> keys_;
+  std::vector<DrawPacket> packets_;
+  std::vector<DrawInstance> instances_;
+
+  // Packet indices in draw order, filled by sort
+  std::vector<uint32_t> order_;
+
+  // Scratch space reused between frames
+  std::vector<uint64_t> sortKeys_;
+  std::vector<uint64_t> keyScratch_;
+  std::vector<uint32_t> orderScratch_;
+  std::vector<DrawInstance> sorted_;
+
+  // Small ids for the texture and mesh fields of the key, 0 is reserved for none
+  std::unordered_map<const void *, unsigned> textureIds_;
+  std::unordered_map<const void *, unsigned> meshIds_;
+};
@@ -7,11 +7,22 @@
 
 #include<memory>
 #include <mutex>
+#include <unordered_map>
 
 #include "glm/glm/mat4x4.hpp"
 #include "Shader.h"
 #include "Draw_fwd.h"
 
+/**
+* \brief  Per instance data sent with batched draws
+*/
+struct DrawInstance
+{
+  glm::mat4 transform;
+  glm::vec4 shade;
+  unsigned frame;
+};
+
 class Renderer
 {
 public:
@@ -32,6 +43,19 @@ public:
   void resize(size_t x, size_t y, size_t width, size_t height);
 
   void draw(const RMesh & mesh, const glm::mat4 & mat, const glm::vec4 & shade, const DrawSurface * tex = nullptr, unsigned currFrame = 0, GLenum drawMode = GL_TRIANGLES);
+
+  void uploadInstances(const DrawInstance * instances, size_t count);
+  void drawInstances(const RMesh & mesh, const DrawSurface * tex, size_t first, size_t count, GLenum drawMode = GL_TRIANGLES);
+  void releaseMesh(const RMesh * mesh);
+
+  void bindMesh(const RMesh & mesh);
+  void drawStatic(const StaticBatch & batch, const glm::mat4 & group);
+
+  bool useTextShaders(const Shader & vertex, const Shader & fragment);
+  void drawText(GLuint vao, const Font & font, size_t first, size_t count, const glm::mat4 & group);
+
+  static void setVertexLayout();
+
   void swap(float r, float g, float b, float a = 1);
   bool reloadShader();
   std::unique_lock<std::mutex> makeCurrent();
@@ -42,6 +66,18 @@ public:
   size_t getY() const;
 
 private:  
+  struct MeshBuffers
+  {
+    GLuint vao;
+    GLuint vbo;
+    GLuint ibo;
+    GLsizei count;
+  };
+
+  MeshBuffers & uploadMesh(const RMesh & mesh);
+  const MeshBuffers & getBuffers(const RMesh & mesh);
+  void useProgram(const DrawSurface * tex, const glm::mat4 & group);
+
   size_t width_;
   size_t height_;
   size_t x_;
@@ -53,4 +89,16 @@ private:
   Shader fragmentShader_;
 
   GLuint compShader_;
+  GLint texturedLocation_;
+  GLint frameCountLocation_;
+  GLint groupLocation_;
+
+  GLuint textShader_;
+  GLint textGroupLocation_;
+
+  // Meshes are uploaded once and drawn from these afterwards
+  std::unordered_map<const RMesh *, MeshBuffers> meshBuffers_;
+
+  GLuint instanceBuffer_;
+  size_t instanceCapacity_;
 };
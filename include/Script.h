@@ -10,6 +10,8 @@
 
 #include <string>
 #include <memory>
+#include <ctime>
+#include <unordered_map>
 
 #include "Logger.h"
 
@@ -94,11 +96,55 @@ public:
   void unloadScript(SCRIPT_PTR script);
   void start();
 
+  void snapshotState();
+  void seedRandom(unsigned seed);
+
+  // Stops every script and restores the last snapshot, then runs init for the
+  // given stage
+  template<typename T>
+  void restoreState(T * stage)
+  {
+    using namespace Logger;
+
+    try
+    {
+      luabind::call_function<void>(state_, "restoreState", stage);
+    }
+    catch (const std::exception & err)
+    {
+      Log<Error>(err.what());
+    }
+  }
+
   lua_State * getLuaState() { return state_; }
-  void update(float dt);
+  void update(float dt, double frameTimeLeft = -1);
+
+  void setGCBudget(double seconds, bool scaleToFrame = false);
+
+  static bool LoadChunk(lua_State * L, const std::string & file);
+  static bool ChunkExists(const std::string & file);
+  static void FlushChunks();
 
 private:
+  // Compiled script kept as bytecode so every routine can get its own closure
+  struct Chunk
+  {
+    time_t modified;
+    std::string bytecode;
+  };
+
+  static bool GetModifiedTime(const std::string & file, time_t & modified);
+
+  void stepCollector(double frameTimeLeft);
+
+  // Compiled chunks shared by every sandbox, keyed by file path
+  static std::unordered_map<std::string, Chunk> chunks_;
+
   std::string source_;
   lua_State * state_;
+
+  double gcBudget_;    // Seconds per frame the garbage collector can run for
+  bool gcScaled_;      // Scale the budget to the time left in the frame
+  int gcBaseKB_;       // Heap size after the last finished collection cycle
 };
 
@@ -27,6 +27,14 @@ namespace Engine
   using SCRIPT_EVENT_LINK = std::weak_ptr<ScriptEvent>;
   using SCRIPT_EVENT_PTR = std::shared_ptr<ScriptEvent>;
 
+  // How a listener recieves the messages posted to its event
+  enum class ListenMode
+  {
+    Immediate,  // Called once for every message as it's posted
+    Batched,    // Called once per frame with an array of that frame's messages
+    Latest      // Called once per frame with only the last message posted
+  };
+
   class ScriptListener
   {
   public:
@@ -38,8 +46,9 @@ namespace Engine
 
   protected:
     friend class ScriptEvent;
-    ScriptListener(ScriptEvent * scriptEvent_, luabind::object _callFunction);
+    ScriptListener(ScriptEvent * scriptEvent_, luabind::object _callFunction, ListenMode _mode);
     luabind::object callFunction;
+    ListenMode mode;
     
   private:
     ScriptEvent * scriptEvent;
@@ -58,7 +67,10 @@ namespace Engine
     template<typename T>
     void postMessage(const Packet & data);
 
-    SCRIPT_LISTENER_PTR connect(luabind::object); /* Might not be correct type. Should be passed a lua function */
+    SCRIPT_LISTENER_PTR connect(luabind::object, ListenMode mode = ListenMode::Immediate); /* Might not be correct type. Should be passed a lua function */
+    SCRIPT_LISTENER_PTR connectImmediate(luabind::object func) { return connect(func, ListenMode::Immediate); }
+    SCRIPT_LISTENER_PTR connectBatched(luabind::object func) { return connect(func, ListenMode::Batched); }
+    SCRIPT_LISTENER_PTR connectLatest(luabind::object func) { return connect(func, ListenMode::Latest); }
 
     void disconnectListener(ScriptListener * listener);
 
@@ -72,8 +84,10 @@ namespace Engine
   private:
     lua_State * L;
     std::string eventName_;
-    luabind::object dataTable;
+    luabind::object dataTable;   // Messages held for batched listeners
     unsigned totalObjects_;
+    luabind::object latest_;     // Last message held for latest-only listeners
+    bool hasLatest_;
     Messenger mess_;
 
     std::list<SCRIPT_LISTENER_LINK> listeners_;
@@ -108,16 +122,21 @@ namespace Engine
 
   template<typename T>
   ScriptEvent::ScriptEvent(Messenger & sub, lua_State * _L, const std::string & eventName, T **) :
-    L(_L), eventName_(eventName), dataTable(luabind::newtable(_L)), totalObjects_(0)
+    L(_L), eventName_(eventName), dataTable(luabind::newtable(_L)), totalObjects_(0), hasLatest_(false)
   {
     SUBSCRIBER_ACTION post = std::bind(&ScriptEvent::postMessage<T>, this, std::placeholders::_1);
 
     mess_.Subscribe(sub, eventName, post);
   }
 
+  // Immediate listeners are called right away, anything else is held until 
+  // the router pushes the event at the end of the frame
   template<typename T>
   void ScriptEvent::postMessage(const Packet & data)
   {
+    bool batched = false;
+    bool latest = false;
+
     auto iter = listeners_.begin();
 
     while (iter != listeners_.end())
@@ -126,10 +145,35 @@ namespace Engine
         iter = listeners_.erase(iter);
       else
       {
-        luabind::call_function<void>(L, "pushEvent", iter->lock()->callFunction, data.getData<T>());
+        SCRIPT_LISTENER_PTR listener = iter->lock();
+
+        switch (listener->mode)
+        {
+        case ListenMode::Immediate:
+          luabind::call_function<void>(L, "pushEvent", listener->callFunction, data.getData<T>());
+          break;
+
+        case ListenMode::Batched:
+          batched = true;
+          break;
+
+        case ListenMode::Latest:
+          latest = true;
+          break;
+        }
+
         ++iter;
       }
     }
+
+    if (batched)
+      dataTable[++totalObjects_] = data.getData<T>();
+
+    if (latest)
+    {
+      latest_ = luabind::object(L, data.getData<T>());
+      hasLatest_ = true;
+    }
   }
 
   // Router
@@ -0,0 +1,99 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+
+#ifndef SDL_MIXER_BACKEND_H
+#define SDL_MIXER_BACKEND_H
+
+#include <memory>
+#include <SDL2/SDL.h>
+#include "AudioBackend.h"
+
+/**********************************************************************/
+/**********************************************************************/
+/*! \brief
+ * Software mixer on top of an SDL audio device, for machines without FMOD.
+ * Plays WAV files (8, 16 and 24 bit PCM or 32 bit float). Sounds are
+ * decoded to stereo floats at the device rate when opened; streamed sounds
+ * are decoded a piece at a time from Update instead. Mixing happens on
+ * SDL's audio thread. 3D positions and priorities are ignored.
+ */
+class SdlMixerBackend : public AudioBackend
+{
+  public:
+    SdlMixerBackend();
+    ~SdlMixerBackend();
+
+    const char* GetName() const { return "sdl"; }
+    bool Init();
+    void Update();
+
+    void OpenSound( SoundHandle hSound, const std::string& strPath, bool b3d, bool bLooping, bool bStream );
+    void ReleaseSound( SoundHandle hSound );
+    void PollSounds( std::vector<SoundHandle>& vReady, std::vector<SoundHandle>& vFailed );
+
+    bool StartVoice( int nVoice, SoundHandle hSound, float fVolumedB, int nPriority, bool bPaused, const Vector3& vPosition );
+    void StopVoice( int nVoice );
+    void SetVoiceVolume( int nVoice, float fVolumedB );
+    void SetVoicePaused( int nVoice, bool bPaused );
+    void SetVoicePriority( int /*nVoice*/, int /*nPriority*/ ) {}
+    void SetVoicePosition( int /*nVoice*/, const Vector3& /*vPosition*/ ) {}
+    void PollFinished( std::vector<int>& vVoices );
+
+    // Layout of the samples in a WAV file.
+    struct WavFormat
+    {
+      int nChannels;
+      int nRate;
+      int nBits;
+      bool bFloat;
+      long lDataStart;     // Where the samples start in the file.
+      unsigned nDataBytes;
+    };
+
+  private:
+    class Stream;
+
+    struct Sample
+    {
+      std::string mstrPath;
+      WavFormat mFormat;
+      std::vector<float> mvFrames;  // Stereo, at the device rate. Empty for streams.
+      bool mbLooping;
+      bool mbStream;
+    };
+
+    // Only changed with the device locked, since the mixer reads it.
+    struct Voice
+    {
+      const Sample* mpSample;   // NULL while the voice is free.
+      Stream* mpStream;         // Streamed sounds only.
+      size_t mnFrame;           // Next frame of the sample to play.
+      float mfGain;
+      bool mbPaused;
+      bool mbFinished;          // Set by the mixer when the sound runs out.
+    };
+
+    static void SDLCALL MixCallback( void* pUserData, Uint8* pStream, int nBytes );
+    void Mix( float* pOut, int nFrames );
+    void ClearVoice( Voice& voice, std::vector<Stream*>& vStreams );
+
+    SdlMixerBackend( const SdlMixerBackend& ) = delete;
+    SdlMixerBackend& operator=( const SdlMixerBackend& ) = delete;
+
+    bool mbSdlStarted;
+    SDL_AudioDeviceID mDevice;
+    SDL_AudioSpec mSpec;
+
+    std::vector<std::unique_ptr<Sample> > mSamples;  // Indexed by SoundHandle.
+    std::vector<SoundHandle> mReady;
+    std::vector<SoundHandle> mFailed;
+    std::vector<int> mFinished;
+
+    Voice mVoices[AUDIO_MAX_VOICES];
+    std::vector<float> mScratch;  // Mixer's buffer for reading streams.
+};
+
+#endif
@@ -9,6 +9,8 @@
 #include <vector>
 #include <list>
 #include <set>
+#include <deque>
+#include <cstdint>
 #include <functional>
 #include "GameInstance.h"
 
@@ -16,6 +18,8 @@
 #include "GameInstance.h"
 #include "ScriptSignal.h"
 #include "grid.h"
+#include "Timer.h"
+#include "StageSnapshot.h"
 
 
 namespace Engine
@@ -28,6 +32,7 @@ namespace Engine
   {
   public:
     typedef std::function<void(Stage *)> STAGE_RESET_FUNC;
+    typedef std::function<void(Stage *)> LOAD_STEP;
 
     Stage(const Stage &) = delete;
     Stage & operator=(const Stage &) = delete;
@@ -40,6 +45,9 @@ namespace Engine
     void setStageOrder(unsigned order);
     void setStageRendered(bool rendered);
     void setStageReset(bool reset) { resetting_ = reset; }
+    void setStagePreloaded(bool preloaded) { preloaded_ = preloaded; }
+    void setPreloadWhenIdle(bool preload) { preloadWhenIdle_ = preload; }
+    void queueLoadStep(LOAD_STEP step);
 
     //static Grid & GetGrid();
 
@@ -55,6 +63,10 @@ namespace Engine
     bool isStageEnding() const;
     bool isStageResetting() const { return resetting_; }
     bool isStageToggling() const { return toggleRunning_; }
+    bool isStageLoading() const { return loading_; }
+    bool isStageLoadingInBackground() const { return loading_ && loadingBackground_; }
+    bool isStagePreloaded() const { return preloaded_; }
+    float getLoadProgress() const;
     void stageClear();
 
     void sendStageToBack();
@@ -74,9 +86,11 @@ namespace Engine
     static void DestroyStage(Stage & stage);
     static void CleanStage(Stage & stage);
     static void ToggleRunning(Stage & stage);
-    static void ResetStage(const std::string & name, unsigned order);
     //static void ResetStage(Stage & stage);
     static void ResetStage(Stage * stage);
+    static void PreloadStage(Stage & stage);
+    static void UpdateLoading(Stage & stage);
+    static void SeedLuaRandom(unsigned seed);
 
     GameInstance & addGameInstance(const std::string type);
     GameInstance & addGameInstance();
@@ -87,6 +101,7 @@ namespace Engine
     GameInstance & getFirstInstanceByName(const std::string & name) const;
     std::ostream & printInstanceList(std::ostream & os) const;
     Messenger & getMessenger() { return mess_; }
+    const StageClock & getClock() const { return clock_; }
     // This is a fatal exception. Please do not try to catch this.
     struct malformed_stage_list: public std::exception
     {
@@ -119,6 +134,10 @@ namespace Engine
     
     void initLuaSandbox(const std::string & sandbox = "scripts/sandbox.lua");
     void startLuaSandbox();
+    void snapshotLuaSandbox();
+    void restoreLuaSandbox();
+
+    StageSnapshot & getSnapshot() { return snapshot_; }
 
     SCRIPT_PTR loadScript(const std::string & script);
     SCRIPT_PTR loadScript(const std::string & script, GameInstance * owner);
@@ -146,6 +165,13 @@ namespace Engine
 
     Stage(const std::string & name, STAGE_RESET_FUNC reset, unsigned order);
     static unsigned long AssignID();
+
+    static bool luaSeeded_;   // SeedLuaRandom has been called
+    static unsigned luaSeed_; // Last seed given to SeedLuaRandom, for new sandboxes
+
+    void beginLoad(bool background);
+    void continueLoad();
+    void finishLoad();
     const std::string stageName_;
 
     bool isRunning_;
@@ -158,11 +184,24 @@ namespace Engine
     bool resetting_;
     bool toggleRunning_;
 
+    StageClock clock_;  // Stops while the stage isn't running
+
     std::unique_ptr<Sandbox> lua_Sandbox_;
     luabind::object hierarchy_;
     ScriptRouter event_Router_;
 
     STAGE_RESET_FUNC resFunc_;
+    StageSnapshot snapshot_;  // State right after the reset function last ran
+
+    std::deque<LOAD_STEP> loadSteps_; // Work left in the current reset
+    size_t loadStepsTotal_;
+    unsigned loadFrames_;
+    uint64_t loadStart_;
+    bool loading_;
+    bool loadingBackground_;    // Preloading, only gets spare time each frame
+    bool loadRestored_;         // Current load started from the snapshot
+    bool preloaded_;            // Reset ahead of time and hasn't run since
+    bool preloadWhenIdle_;      // Preload whenever the stage isn't running
 
     Grid grid_; // each stage should have its own grid
   };
@@ -0,0 +1,77 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <typeinfo>
+
+namespace Engine
+{
+  class Stage;
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Image of a stage taken right after it finished loading. Keeps the data
+      the reset function loaded from disk and a copy of the stage's lua
+      environment, so restarting the stage can restore from it instead of
+      rebuilding the lua sandbox and reparsing every file. Instances, their
+      components and the grid are still created by the reset function.
+  */
+  /****************************************************************************/
+  class StageSnapshot
+  {
+  public:
+    StageSnapshot();
+
+    StageSnapshot(const StageSnapshot &) = delete;
+    StageSnapshot & operator=(const StageSnapshot &) = delete;
+
+    void capture(Stage & stage);
+    void restore(Stage & stage);
+    void invalidate();
+
+    bool isCaptured() const { return captured_; }
+    size_t getInstanceCount() const { return instanceCount_; }
+
+    /**************************************************************************/
+    /*!
+      \brief
+        Gets data kept in the snapshot, calling the loader to make it the
+        first time it is asked for. Loaders that throw leave nothing behind
+
+      \param key
+        Name of the data, usually the file it was loaded from
+
+      \param loader
+        Callable returning a new T. The snapshot takes ownership of it
+    */
+    /**************************************************************************/
+    template<typename T, typename LOADER>
+    std::shared_ptr<T> load(const std::string & key, LOADER loader)
+    {
+      std::string typedKey = std::string(typeid(T).name()) + ":" + key;
+
+      auto found = data_.find(typedKey);
+
+      if (found != data_.end())
+        return std::static_pointer_cast<T>(found->second);
+
+      std::shared_ptr<T> loaded(loader());
+
+      data_[typedKey] = loaded;
+
+      return loaded;
+    }
+
+  private:
+    std::map<std::string, std::shared_ptr<void> > data_;  // Loaded data, by type and key
+
+    bool captured_;
+    size_t instanceCount_;  // Instances on the stage when it was captured
+  };
+}
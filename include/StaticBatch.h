@@ -0,0 +1,70 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+#include <GL/glew.h>
+
+#include <vector>
+
+#include "glm/glm/vec2.hpp"
+#include "glm/glm/vec4.hpp"
+#include "glm/glm/mat4x4.hpp"
+
+#include "Draw_fwd.h"
+
+/**
+* \brief  Per instance values of a static batch that can change without a rebuild
+*/
+struct StaticAttributes
+{
+  glm::vec4 shade;
+  unsigned frame;
+};
+
+/**
+* \brief  Instances of one mesh and surface whose transformations are kept on the
+*         GPU between frames. Transformations are only uploaded when the batch is
+*         built, while shade and frame live in a separate buffer that can be
+*         patched one instance at a time. The batch keeps its own copy of the
+*         mesh's vertices and indices, so it stays drawable if the renderer
+*         releases the mesh.
+*/
+class StaticBatch
+{
+public:
+  StaticBatch(const RMesh * mesh, const DrawSurface * surface);
+  ~StaticBatch();
+
+  StaticBatch(const StaticBatch &) = delete;
+  StaticBatch & operator=(const StaticBatch &) = delete;
+
+  void build(const std::vector<glm::mat4> & transforms, const std::vector<StaticAttributes> & attributes);
+  void setAttributes(size_t index, const StaticAttributes & attributes);
+
+  const RMesh * getMesh() const;
+  const DrawSurface * getSurface() const;
+  size_t size() const;
+
+  GLuint getVAO() const;
+  GLenum getDrawMode() const;
+  GLsizei getIndexCount() const;
+
+  // Bounds of every instance before the group transformation
+  glm::vec2 boundsMin;
+  glm::vec2 boundsMax;
+
+private:
+  const RMesh * mesh_;
+  const DrawSurface * surface_;
+  size_t count_;
+  GLenum drawMode_;
+  GLsizei indexCount_;
+
+  GLuint vao_;
+  GLuint vertices_;
+  GLuint indices_;
+  GLuint transforms_;
+  GLuint attributes_;
+};
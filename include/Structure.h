@@ -34,13 +34,8 @@ namespace Engine
     void SetType(int type) { _type = type; }
     void SetHeight(int height) { _height = height; }
     void SetTileXY(int x, int y) { _x = x; _y = y; }
-
-    virtual ~StructureTile() {};
   
   private:
-    StructureTile(const StructureTile &) = delete;
-    StructureTile & operator=(const StructureTile &) = delete;
-
     int _x;
     int _y;
     int _group;
@@ -61,7 +56,8 @@ namespace Engine
     int GetY() const { return height_; }
     int GetZ() const { return zMax_; }
     int GetGroup() const { return group_; }
-    std::vector<std::vector<std::shared_ptr<StructureTile> > >& GetGrid() { return grid_; }
+    StructureTile& GetTile(int x, int y) { return tiles_[y * width_ + x]; }
+    const StructureTile& GetTile(int x, int y) const { return tiles_[y * width_ + x]; }
     GameInstance* GetEntity() const;
 
     void SetWidth(int width);
@@ -76,6 +72,7 @@ namespace Engine
     void PrintStructure() const;
 
     bool CompareGrids(const Structure& rhs) const;
+    std::string GetPatternKey() const;
     void SetStructureEntity();
 
     void SetArt();
@@ -84,6 +81,8 @@ namespace Engine
   private:
 
     void LoadStructureFromPath(const std::string& path);
+    void Resize(int width, int height);
+
     int height_;
     int width_;
     int zMax_;
@@ -92,12 +91,14 @@ namespace Engine
     int group_;
 
     unsigned long structEntity_;
-    std::vector<std::vector<std::shared_ptr<StructureTile> > > grid_;
+    std::vector<StructureTile> tiles_; // Row major, width_ * height_
     Stage* stage_;
     std::vector<unsigned long> childTiles_;
   };
 
   typedef std::unordered_map<std::string, Structure> STRUCT_LIST;
+  typedef std::unordered_map<std::string, std::string> STRUCT_INDEX; // Pattern key to structure alias
+  typedef std::pair<STRUCT_LIST, STRUCT_INDEX> STRUCT_DATA;             // Everything read from a definitions file
   typedef std::vector<std::pair<std::pair<int, int>, std::vector<GameInstance*>>> OBJECT_BY_TILE_LIST;
  
 }
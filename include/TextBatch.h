@@ -0,0 +1,92 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+#include <GL/glew.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "glm/glm/vec2.hpp"
+#include "glm/glm/vec4.hpp"
+#include "glm/glm/mat4x4.hpp"
+
+#include "RMesh.h"
+#include "TextToken.h"
+#include "Draw_fwd.h"
+
+class Font;
+
+/**
+* \brief  Every text label of a layer, laid out into one vertex buffer. The
+*         buffer is only rebuilt when a label changes or the aspect ratio does,
+*         and is drawn with one call per font.
+*
+*         Label positions are in the layer's space with the label centred on
+*         them, and sizes are the height of a line in the same units.
+*/
+class TextBatch
+{
+public:
+  TextBatch();
+  ~TextBatch();
+
+  TextBatch(const TextBatch &) = delete;
+  TextBatch & operator=(const TextBatch &) = delete;
+
+  TextToken newLabel(const Font * font);
+
+  void layout(float ar);
+  void draw(Renderer & render, const glm::mat4 & group) const;
+
+  size_t size() const;
+  bool empty() const;
+
+private:
+  friend class TextToken;
+
+  struct Label
+  {
+    const Font * font;
+    std::string text;
+    glm::vec2 position;
+    float size;
+    glm::vec4 color;
+    bool visible;
+    int count;
+  };
+
+  // Indices drawn with one font
+  struct Range
+  {
+    const Font * font;
+    size_t first;
+    size_t count;
+  };
+
+  bool registerLabel(size_t id);
+  void deregisterLabel(size_t id);
+
+  const Label & getLabel(size_t id) const;
+  Label & getLabel(size_t id);
+  void markDirty();
+
+  void layoutLabel(const Label & label, float ar);
+
+  std::map<size_t, Label> labels_;
+  size_t nextId_;
+
+  bool dirty_;
+  float ar_;
+
+  std::vector<Vertex> verts_;
+  std::vector<unsigned> indices_;
+  std::vector<Range> ranges_;
+
+  GLuint vao_;
+  GLuint vbo_;
+  GLuint ibo_;
+};
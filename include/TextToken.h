@@ -0,0 +1,55 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#pragma once
+#include <string>
+
+#include "glm/glm/vec2.hpp"
+#include "glm/glm/vec4.hpp"
+
+#include "Draw_fwd.h"
+
+/**
+* \brief  Handle to a text label. Like DrawTokens, labels are reference counted
+*         and removed once the last token referring to them is destroyed.
+*/
+class TextToken
+{
+public:
+  TextToken();
+  TextToken(const TextToken & cpy);
+
+  ~TextToken();
+
+  TextToken & operator=(const TextToken & rhs);
+  bool operator==(const TextToken & rhs) const;
+
+  bool isValid() const;
+
+  // Getters
+  const std::string & getText() const;
+  glm::vec2 getPosition() const;
+  float getSize() const;
+  glm::vec4 getColor() const;
+  bool isVisible() const;
+
+  // Setters, which only cause a relayout when the value changes
+  void setText(const std::string & text);
+  void setPosition(const glm::vec2 & pos);
+  void setSize(float size);
+  void setColor(const glm::vec4 & color);
+  void setVisible(bool visible);
+
+private:
+  friend class TextBatch;
+
+  TextToken(TextBatch * parent, size_t id);
+
+  void registerMe();
+  void deregisterMe();
+
+  TextBatch * parent_;
+  size_t id_;
+};
@@ -36,7 +36,7 @@ private:
   int imageHeight_;
   int channels_;
 
-  std::vector<unsigned char> bmp;
+  mutable std::vector<unsigned char> bmp; // file contents, freed once uploaded
   mutable GLuint texture_ = NULL;
 
   size_t frames_;
@@ -5,22 +5,65 @@
 // ---------------------------------------------------------------------------------
 #pragma once
 
-#include <chrono>
+#include <cstdint>
 #include <iostream>
+
+/**
+* \brief  Monotonic time shared by everything in a frame. The main loop publishes
+*         one timestamp per frame (a fixed step loop would publish one per
+*         simulation tick) and every Timer reads it, so timers agree with each
+*         other and reading them never touches the system clock.
+*/
+class FrameClock
+{
+public:
+  static void Publish(uint64_t nanos);
+  static uint64_t Now();
+
+private:
+  static uint64_t & current();
+};
+
+/**
+* \brief  Frame time that stops while it is paused. Stages own one and pause it
+*         with the stage, so timers running on it don't need pausing themselves.
+*/
+class StageClock
+{
+public:
+  StageClock();
+
+  void Pause();
+  void Resume();
+
+  bool IsPaused() const { return isPaused_; }
+  uint64_t Now() const;
+
+private:
+  bool isPaused_;
+  uint64_t pauseTime_;  // Clock reading when it was paused
+  uint64_t offset_;     // Frame time spent paused
+};
+
 class Timer
 {
 public:
-  Timer();
+  explicit Timer(const StageClock * clock = nullptr);
 
   void Reset();
   void Pause();
   void UnPause();
 
+  void SetClock(const StageClock * clock);
+
   bool IsPaused() const { return isPaused_; }
   double ElapsedTime() const;
 
 private:
+  uint64_t now() const;
+
+  const StageClock * clock_;  // Frame clock is used when null
   bool isPaused_;
-  std::chrono::milliseconds pauseTime_;
-  std::chrono::milliseconds initTime_;
+  uint64_t pauseTime_;        // Elapsed time when paused
+  uint64_t initTime_;
 };
\ No newline at end of file
@@ -64,16 +64,17 @@ namespace Engine
     float getRot() const;
     float getWidth() const { return width_; }
     float getHeight() const { return height_; }
+    unsigned long getVersion() const { return version_; }
 
     void setX(float x);
     void setY(float y);
-    void setDepth(float z) { depth_ = z; }
-    void addRot(float rot){ rot_ += rot; }
+    void setDepth(float z) { depth_ = z; ++version_; }
+    void addRot(float rot){ rot_ += rot; ++version_; }
     void setRot(float rot);
     void setPos(const glm::vec2 & pos, bool dispatchEvent = true);
     void setPos(float x, float y);
-	inline void setWidth(float w) { width_ = w; }
-	inline void setHeight(float h) { height_ = h; }
+	inline void setWidth(float w) { width_ = w; ++version_; }
+	inline void setHeight(float h) { height_ = h; ++version_; }
 	inline void setStart(glm::vec2 pos) { startPos_ = pos; }
 	inline const glm::vec2 getStart() const { return startPos_; }
     void OnMoved(const Packet & payload);
@@ -96,6 +97,8 @@ namespace Engine
     float height_;
     float rot_; // Rotation (in radians) of the component
 	glm::vec2 startPos_;
+
+    unsigned long version_ = 1; // Bumped whenever the transform changes
   };
 }
 
@@ -4,6 +4,7 @@
 // FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
 // ---------------------------------------------------------------------------------
 #pragma once
+#include <unordered_map>
 
 #include "EnemyLogic.h"
 #include "GameInstance.h"
@@ -13,9 +14,6 @@ namespace Engine
 {
   class Wave;
 
-  // Unsigned long for enemy instance ID, size_t for wave number
-  typedef std::vector<std::pair<unsigned long, size_t>> ENEMY_LIST;
-
   class WaveController : public Component
   {
   public:
@@ -48,11 +46,12 @@ namespace Engine
     void KillAll();
     bool IsWaveDead(size_t wave) const;
 
-    void OnStagePaused(const Packet & payload);
+    void OnInstanceRemoved(unsigned long id);
 
   private:
     std::vector<Wave> wv_;
-    ENEMY_LIST enemies_;
+    std::unordered_map<unsigned long, size_t> liveEnemies_; // Enemy instance ID to the wave it spawned in
+    std::vector<size_t> aliveCount_;                        // Living enemies in each wave
     size_t currentWave_;
     Timer waveTimer_;
     bool running_;
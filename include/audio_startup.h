@@ -8,8 +8,6 @@
 #define AUDIO_STARTUP_H
 #include "audio_test.h"
 
-unsigned getSoundCount( const string& soundName );
-void setSoundCount( const string& soundName, unsigned count );
 void setMelodyMute(bool muted);
 bool getMelodyMute();
 void setVolumeMute(bool muted);
@@ -19,6 +17,8 @@ int getRepeatChannel();
 bool isVisitedPause();
 void setVisitedPause(bool visitedPause);
 void GatherSounds( const string& strFileName, Audio_Engine& AEngine );
+void setAudioBackend(const std::string& strBackend);
+const std::string& getAudioBackend();
 Audio_Engine* GetAudioEngine(); //TODO: Implement this!
 void StartGameAudioSystem();
 
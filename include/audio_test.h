@@ -9,67 +9,126 @@
 
 #include <string> // Used as container.
 #include <map>    // Higher level container.
+#include <unordered_map>
 #include <vector>
+#include <atomic>
+#include <thread>
 #include <math.h>
 
-//#pragma warning (push)
-//#pragma warning (disable : 4201)
-#include "../include/fmod/fmod.hpp"
-#include "../include/fmod/fmod_dsp.h"
-#include "../include/fmod/fmod_common.h"
-#include "../include/fmod/fmod_errors.h"
-#include "../include/fmod/fmod_studio.hpp"
-//#pragma warning (pop)
-
-//#pragma comment (lib, "fmodL_vc.lib")
+#include "AudioBackend.h"
+#include "AudioQueue.h"
 
 using std::map;
 using std::string;
 
-struct Vector3
+/**********************************************************************/
+/**********************************************************************/
+// A loaded (or loading) sound.
+struct SoundEntry
+{
+  string mName;
+  int mnState;            // Implementation::SoundState
+  bool mb3d;              // How it was loaded, used to reload it.
+  bool mbLooping;
+  bool mbStream;
+};
+
+// One slot in the voice pool.
+struct Voice
+{
+  Voice();
+
+  int mnChannelId;          // -1 while the voice is free.
+  SoundHandle mSound;
+  bool mbStarted;           // Sent to the audio thread. False while the sound is still loading.
+  float mfVolume;           // Volume asked for (dB).
+  float mfLevel;            // Volume actually applied, with global volume and mutes (dB).
+  int mnPriority;           // 0: most important, 256: least important.
+  unsigned mnStarted;       // When it started, compared to find the oldest voice.
+  bool mbPaused;
+  bool mbMuteListed;        // Muted by the "mute all" function.
+  Vector3 mvPosition;
+};
+
+// Sent from the game to the audio thread.
+struct AudioCommand
+{
+  enum Type { OPEN_SOUND, RELEASE_SOUND, START_VOICE, STOP_VOICE, SET_VOLUME, SET_PAUSED,
+              SET_PRIORITY, SET_POSITION, SET_LISTENER, LOAD_BANK, LOAD_EVENT, PLAY_EVENT,
+              STOP_EVENT, SET_EVENT_PARAMETER };
+  enum { OPEN_3D = 1, OPEN_LOOPING = 2, OPEN_STREAM = 4 };
+
+  Type mType;
+  int mnVoice;
+  int mnChannelId;
+  SoundHandle mSound;
+  float mfValue;            // Volume (dB) or event parameter value.
+  int mnValue;              // Priority, paused, open or bank flags.
+  bool mbPaused;            // Start the voice paused.
+  Vector3 mvPosition;
+  string mstrName;          // File, bank or event name.
+  string mstrParameter;
+};
+
+// Sent from the audio thread back to the game.
+struct AudioEvent
 {
-  float x;
-  float y;
-  float z;
-  Vector3() : x(0), y(0), z(0) {};
-  Vector3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {};
+  enum Type { SOUND_READY, SOUND_FAILED, VOICE_ENDED };
+
+  Type mType;
+  SoundHandle mSound;
+  int mnChannelId;
 };
 
 /**********************************************************************/
 /**********************************************************************/
-// This keeps the FMOD API calls separate from the engine class.
-//      It also holds a map of played sounds and triggered events.
+// This keeps the backend separate from the engine class.
+//      It holds the sound table and the voice pool on the game's side,
+//      and runs the audio thread that talks to the backend. The two sides
+//      only ever talk through the command and event queues.
 struct Implementation
 {
-  Implementation();
+  explicit Implementation( AudioBackend* pBackend );
   ~Implementation();
 
   void Update();
 
-  FMOD::Studio::System* mpStudioSystem;
-  FMOD::System* mpSystem;
-
-  int mnNextChannelId;
-
-  typedef map<string, FMOD::Sound*> SoundMap;
-  typedef map<int, FMOD::Channel*> ChannelMap;
-  typedef map<int, string> ChannelPlayingMap;
-  typedef map<string, FMOD::Studio::EventInstance*> EventMap;
-  typedef map<string, FMOD::Studio::Bank*> BankMap;
-  typedef map<int, float> VolumeMap;
-
-  //These two aren't used right now.
-  BankMap mBanks;
-  EventMap mEvents;
-  /////////////////////
-  SoundMap mSounds;
-  ChannelMap mChannels;
-  ChannelPlayingMap mPlaying;
-  VolumeMap mVolume;
-
-  //Stores list of sounds paused by the "pause all" function.
-  //   This lets you unpause only those sounds later.
-  ChannelMap mPaused;
+  enum SoundState { SOUND_LOADING, SOUND_READY, SOUND_UNLOADED, SOUND_FAILED };
+
+  static const int MAX_VOICES = AUDIO_MAX_VOICES;
+  static const int MAX_INSTANCES = 5;  // Copies of one sound that can play at once.
+
+  SoundHandle FindSound(const string& strSoundName) const;
+  void OpenSound(SoundHandle hSound);
+  Voice* FindVoice(int nChannelId);
+  Voice* AllocVoice(SoundHandle hSound, int nPriority);
+  void StartVoice(Voice& voice);
+  void FreeVoice(Voice& voice);
+  bool AnyVoiceMuteListed() const;
+  void Send(const AudioCommand& command);
+
+  // Audio thread only.
+  void RunAudioThread();
+  void Execute(const AudioCommand& command);
+
+  AudioBackend* mpBackend;
+  AudioQueue<AudioCommand> mCommands;
+  AudioQueue<AudioEvent> mEvents;
+  std::atomic<bool> mbRunning;
+  std::thread mThread;
+  int mnVoiceIds[MAX_VOICES];  // Audio thread's copy of the channel id each voice is playing.
+
+  unsigned mnNextChannelId;
+  unsigned mnVoicesStarted;
+
+  typedef std::unordered_map<string, SoundHandle> SoundHandleMap;
+
+  std::vector<SoundEntry> mSounds;  // Indexed by SoundHandle.
+  SoundHandleMap mSoundHandles;
+  Voice mVoices[MAX_VOICES];
+
+  // Last values given to SetEventParameter, by event then parameter.
+  map<string, map<string, float> > mEventParameters;
 };
 
 /**********************************************************************/
@@ -83,17 +142,20 @@ namespace luabind
 class Audio_Engine
 {
   public:
-    static void Init();
+    static void Init( const string& strBackend = string() );
     static void Update();
     static void Shutdown();
-    static int ErrorCheck( FMOD_RESULT result );
 
-    void LoadBank( const string& strBankName, FMOD_STUDIO_LOAD_BANK_FLAGS flags );
+    static const int DEFAULT_PRIORITY = 128;
+
+    void LoadBank( const string& strBankName, unsigned flags );
     void LoadEvent( const string& strEventName );
-    void LoadSound( const string& strSoundName, bool b3d = true, bool bLooping = false, bool bStream = false );
+    SoundHandle LoadSound( const string& strSoundName, bool b3d = true, bool bLooping = false, bool bStream = false );
     void UnLoadSound( const string& strSoundName );
+    SoundHandle GetSoundHandle( const string& strSoundName );
     void Set3dListenerAndOrientation( const Vector3& vPos = Vector3(), float fVolumedB = 0.0f );
-    int PlaySounds( const string& strSoundName, const Vector3& vPos = Vector3(), float fVolumedB = 0.0f );
+    int PlaySounds( SoundHandle hSound, const Vector3& vPos = Vector3(), float fVolumedB = 0.0f, int nPriority = DEFAULT_PRIORITY );
+    int PlaySounds( const string& strSoundName, const Vector3& vPos = Vector3(), float fVolumedB = 0.0f, int nPriority = DEFAULT_PRIORITY );
     void PlayEvent( const string& strEventName );
     void SetChannelPause( int nChannelId, bool pause );
     int FindSoundChannel(const string& strSoundName);
@@ -104,7 +166,6 @@ class Audio_Engine
     void SetEventParameter( const string& strEventName, const string& strParameterName, float fValue );
     void SetChannelMute(int nChannelId, bool mute);
     void SetAllChannelsMute( bool isPaused );
-    void StopChannelPtr(FMOD::Channel* target);
     void StopChannel( int nChannelId );
     float GetChannelVolume( int nCHannelId );
     void SetChannel3dPosition( int nChannelId, const Vector3& vPosition );
@@ -114,18 +175,10 @@ class Audio_Engine
     void SetGlobalVolumedB(float volume);
     void SetChannelPriority(int nChannelId, int priority);
     float GetGlobalVolumedB();
-    static FMOD_RESULT F_CALLBACK EndOfSound(FMOD_CHANNELCONTROL *chanControl,
-                                         FMOD_CHANNELCONTROL_TYPE controlType,
-                                         FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType,
-                                         void *commandData1,
-                                         void *commandData2);
 
     // lua stuff
     static luabind::scope GetLuaRegisters();
 
 };
 
-float dbToVolume(float db);
-float VolumeTodb(float volume);
-FMOD_VECTOR VectorToFmod(const Vector3& vPosition);
 #endif
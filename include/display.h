@@ -26,6 +26,8 @@ public:
   inline SDL_Window* GetWindow() { return m_window; }
   void Destroy();
   float GetFrameTime();
+  void OverrideFrameTime(float dt);
+  double GetFrameTimeLeft() const;
   void UpdateFrameTime();
   void SetWindowTitle(const std::string& title);
   void SetSize(int x, int y);
@@ -45,6 +47,9 @@ private:
   // Number of frames to store for calculating weighted framerate
   static const unsigned FRAME_VALUES = 10;
 
+  // Frame time the game aims for (seconds)
+  static const double TARGET_FRAME_TIME;
+
   int m_winHeight;
   int m_winWidth;
   SDL_Window* m_window;
@@ -53,9 +58,9 @@ private:
 
   EVENT_HANDLER externalEvent_;
 
-  size_t frametimes[FRAME_VALUES];  // Timings for previous frames
-  size_t frametimelast;             // Previous frame time
-  size_t framecount;                // Number of frames stored
+  unsigned long long frametimes[FRAME_VALUES];  // Timings for previous frames (ns)
+  size_t framecount;                            // Number of frames stored
+  unsigned long long framestart;                // Profiler clock at the start of the frame (ns)
 
   float framespersecond; // Frametime
 
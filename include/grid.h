@@ -14,6 +14,7 @@
 #include "Logger.h"
 #include "Tile.h"
 #include "Structure.h"
+#include "FlowField.h"
 #include <set>
 
 namespace Engine
@@ -44,10 +45,15 @@ namespace Engine
     bool CheckIfTileIsNotGrouped(int x, int y);
     bool CheckIfTileIsValid(int x, int y);
     unsigned char CheckAround(int x, int y);
-    unsigned char CheckUngrouped(int x, int y);
     int PushTile(int x, int y, unsigned long ID);
     int PopTile(int x, int y);
 
+    void OnBlockPushed(int x, int y, int height);
+    void OnBlockPopped(int x, int y, int height);
+
+    int GetCellGroup(int x, int y) const { return cellGroups_[CellIndex(x, y)]; }
+    int GetCellHeight(int x, int y) const { return cellHeights_[CellIndex(x, y)]; }
+
     int GetGridWidth() const { return width_; }
     int GetGridHeight() const { return height_; }
     int GetCycles() const { return cycles_; }
@@ -59,44 +65,49 @@ namespace Engine
     int GetRowOffset() const { return row_offset_; }
     int GetNumBlocks() const { return num_blocks_; }
 
-    void Group(int x, int y, int index);
-    void ChooseNextPosition(int x, int y, unsigned char possibleMoves, int* newX, int* newY);
+    const FlowField& GetFlowField() const { return flow_; }
+    unsigned GetLayoutRevision() const { return layoutRevision_; }
+    glm::vec2 SampleFlow(const glm::vec2& pos) const;
+
     void ResetGrid();
     void PrintGrid();
-    std::set<int> FindModifiedGroups(int x, int y);
-    void ParseGroups(const std::set<int>& tGroups);
-    int FindModifiedGroupOnRemove(int x, int y);
-    void ParseRemovedGroup(int group);
     void UpdateStructure(int group);
 
     void LoadStructureData(const std::string& defPath);
 
   private:
     friend class Tile;
+
+    // Tiles and bounding box of a group of connected blocks
+    struct GroupInfo
+    {
+      std::vector<int> cells; // Indices into the cell arrays
+      int minX;
+      int minY;
+      int maxX;
+      int maxY;
+    };
+
     void CreateGrid(int width, int height);
     unsigned int CreateTile(int x, int y);
     void DrawTile(unsigned int Tile, int i, int j);
     void DrawRow(const std::vector<unsigned long>& vec);
     void DrawColumn(const std::vector<unsigned long>& vec);
-    void GroupStructureFrom(int x, int y);
-    void GroupStructures();
     void ParseGrid();
     void SetTileData();
-    void ResetGroups();
-
-    glm::vec2 GetFirstPosInstanceOfGroup(int group);
-    int GetStructWidthFromGroup(int gX, int gY, int group);
-    int GetStructHeightFromGroup(int gX, int gY, int group);
-    void CopyStructFromGridFromTo(Structure& nStruct, int iX, int iY, int lX, int lY);
-    std::vector<unsigned long> GetTilePtrsFromGroup(int group);
-   
-    
-    void GroupUngroupedStructures();
-    
-    
-    void ResetGroupInGrid(int group);
-    void SetUngroupedStructureTo(int group);
-    void SetUngroupedStructureAdditionTo(int group);
+
+    static STRUCT_DATA * ParseStructureData(const std::string& defPath);
+
+    int CellIndex(int x, int y) const { return y * width_ + x; }
+    void ResizeCells(int width, int height);
+    void UpdateCellTransform();
+    void SetCellGroup(int cell, int group);
+    void AddCellToGroup(int cell, int group);
+    void MergeGroupInto(int from, int into);
+    void SplitGroup(int group);
+
+    void CopyGroupToStructure(Structure& nStruct, const GroupInfo& info);
+    std::vector<unsigned long> GetTilesFromGroup(const GroupInfo& info);
     
     void CreateStructure(int group);
     void RemoveStructure(int group);
@@ -119,5 +130,13 @@ namespace Engine
     int column_offset_;
     int num_blocks_; // number of blocks on grid
 
+    std::vector<int> cellHeights_;  // Blocks on each tile, row major
+    std::vector<int> cellGroups_;   // Group of each tile (0 empty, 1 ungrouped, 2+ grouped)
+    std::map<int, GroupInfo> groupInfo_;
+
+    FlowField flow_;          // Routes enemies around blocks
+    glm::vec2 cellOrigin_;    // World position of the center of tile (0, 0)
+    glm::vec2 cellSize_;      // World size of a tile, zero until the grid is drawn
+    unsigned layoutRevision_; // Changes whenever the grid is resized or redrawn
   };
 }
@@ -12,13 +12,13 @@
 #include "GameInstance.h"
 #include "glm/glm/ext.hpp"
 #include "shader.h"
-//#include "GraphicsPipeline.h"
 #include "DrawToken.h"
 
 namespace Engine
 {
   class SpriteHandler;
   class Sprite;
+  class Transform;
 
   
 
@@ -53,7 +53,7 @@ namespace Engine
     /* Sprite(GameInstance * owner,
             float x, float y, float width, float height);*/
 
-    void SetTransform();
+    bool SetTransform();
     //glm::mat4 GetTransform() { return transform_; }
 
 
@@ -72,5 +72,13 @@ namespace Engine
     float yOffset_;
 
     DrawToken item_;
+
+    // Last transform pushed into the draw token
+    const Transform * transform_ = nullptr;
+    unsigned long transformVersion_ = 0;
+    glm::vec2 syncedPos_;
+    glm::vec2 syncedScale_;
+    float syncedRot_;
+    float syncedDepth_;
   };
 }
@@ -6,39 +6,44 @@ namespace Utils
 {
   using RANDOM_ENGINE = std::mt19937;
 
+  // Every random number is drawn from here. Input recording reseeds it each
+  // frame so a replayed session draws the same numbers
+  inline RANDOM_ENGINE & random_engine()
+  {
+    static RANDOM_ENGINE engine{ std::random_device()() };
+    return engine;
+  }
+
+  inline void seed_random(unsigned seed)
+  {
+    random_engine().seed(seed);
+  }
+
   template<typename T>
   T random_uniform(const T & min, const T & max)
   {
-    std::random_device generator;
-    RANDOM_ENGINE gen(generator());
     std::uniform_int_distribution<T> distribution(min, max);
-    return distribution(generator);
+    return distribution(random_engine());
   }
 
   template<>
   inline float random_uniform(const float & min, const float & max)
   {
-    std::random_device generator;
-    RANDOM_ENGINE gen(generator());
     std::uniform_real_distribution<float> distribution(min, max);
-    return distribution(generator);
+    return distribution(random_engine());
   }
 
   template<>
   inline double random_uniform(const double & min, const double & max)
   {
-    std::random_device generator;
-    RANDOM_ENGINE gen(generator());
     std::uniform_real_distribution<double> distribution(min, max);
-    return distribution(generator);
+    return distribution(random_engine());
   }
 
   template<typename T>
   T random_normal(const T & mean, const T & deviation)
   {
-    std::random_device generator;
-    RANDOM_ENGINE gen(generator());
     std::normal_distribution<T> distribution(mean, deviation);
-    return distribution(generator);
+    return distribution(random_engine());
   }
 }
\ No newline at end of file
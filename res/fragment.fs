@@ -7,13 +7,10 @@ out vec4 outColor;
 
 uniform sampler2D diffuse;
 uniform bool textured;
-uniform vec4 shade;
-uniform uint currFrame;
-uniform uint frameCount;
 
 void main() 
 {
-  vec4 newColor = fragColor * shade;
+  vec4 newColor = fragColor;
 
   if(textured)
     outColor = texture(diffuse, outTex) * newColor;
@@ -0,0 +1,27 @@
+#version 430
+
+in vec2 localPos;
+
+out uvec2 outId;
+
+uniform uint pickId;
+
+// Faces of an isometric block, matching PickFace
+const uint PF_TOP = 1;
+const uint PF_LEFT = 2;
+const uint PF_RIGHT = 3;
+
+void main() 
+{
+  uint face;
+
+  // Top face is the diamond above the block's center
+  if(abs(localPos.x) * 2 + abs(localPos.y - 0.25) * 4 <= 1)
+    face = PF_TOP;
+  else if(localPos.x < 0)
+    face = PF_LEFT;
+  else
+    face = PF_RIGHT;
+
+  outId = uvec2(pickId, face);
+}
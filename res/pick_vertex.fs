@@ -0,0 +1,14 @@
+#version 430
+
+
+layout(location = 0)in vec2 position;
+
+uniform mat4x4 transform;
+
+out vec2 localPos;
+
+void main() 
+{
+  gl_Position = transform * vec4(position.x, position.y, 0, 1);
+  localPos = position;
+}
@@ -0,0 +1,18 @@
+#version 430
+
+in vec4 fragColor;
+in vec2 outTex;
+
+out vec4 outColor;
+
+// Signed distance field, 0.5 lies on the glyph's edge
+uniform sampler2D diffuse;
+
+void main() 
+{
+  float dist = texture(diffuse, outTex).r;
+  float width = fwidth(dist);
+  float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+
+  outColor = vec4(fragColor.rgb, fragColor.a * alpha);
+}
@@ -0,0 +1,19 @@
+#version 430
+
+
+layout(location = 0)in vec2 position;
+layout(location = 1)in vec4 color;
+layout(location = 2)in vec2 inTex;
+
+// Transformation shared by every label of a layer
+uniform mat4x4 group;
+
+out vec4 fragColor;
+out vec2 outTex;
+
+void main() 
+{
+  gl_Position = group * vec4(position.x, position.y, 0, 1);
+  fragColor = color;
+  outTex = inTex;
+}
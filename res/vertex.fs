@@ -5,8 +5,13 @@ layout(location = 0)in vec2 position;
 layout(location = 1)in vec4 color;
 layout(location = 2)in vec2 inTex;
 
-uniform mat4x4 transform;
-uniform uint currFrame;
+// Per instance data
+layout(location = 3)in mat4x4 transform;
+layout(location = 7)in vec4 shade;
+layout(location = 8)in uint currFrame;
+
+// Transformation shared by every instance of a draw
+uniform mat4x4 group;
 uniform uint frameCount;
 
 out vec4 fragColor;
@@ -16,7 +21,7 @@ void main()
 {
   vec2 unTex = vec2(inTex.x * (1.0f / frameCount), inTex.y);
 
-  gl_Position = transform * vec4(position.x, position.y, 0, 1);
-  fragColor = color;
+  gl_Position = group * transform * vec4(position.x, position.y, 0, 1);
+  fragColor = color * shade;
   outTex = vec2(unTex.x, unTex.y) + vec2(float(currFrame) / frameCount, 0);
 }
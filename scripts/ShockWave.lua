@@ -3,6 +3,7 @@
 -- Copyright 1996-2016, DigiPen Institute of Technology (USA). All rights reserved.
 ---------------------------------------------------------------------------------
 local audio = game:GetSystem("Audio_Engine")
+local shockSound = audio:GetSoundHandle("shock.wav")
 
 wait()
 local range = parent.ObjectStats.hp
@@ -25,7 +26,7 @@ function hitEnemies()
         -- damage enemy and create feedback
         enemy.ParticleEmitter:Emit("explosion")
         enemy.ObjectStats.hp = enemy.ObjectStats.hp - parent.ObjectStats.damage
-        audio:PlaySounds("shock.wav", -30)
+        audio:PlaySound(shockSound, -30)
 
         -- Add enemy to the hit list
         hit[enemy.id] = enemy
@@ -4,6 +4,7 @@
 ---------------------------------------------------------------------------------
 local input = game:GetSystem("InputSystem")
 local audio = game:GetSystem("Audio_Engine")
+local destroyedSound = audio:GetSoundHandle("building_destroyed_fast.wav")
 local camera = game:GetSystem("Camera")
 local mouse = game:GetSystem("Mouse")
 
@@ -45,7 +46,7 @@ onControllerUpdate = parent.ControllerUpdate:Connect( function(dt)
     end
 
     if input:KeyPressed(Enum.KeyCode.K) then 
-    audio:PlaySounds("building_destroyed_fast.wav", 0)
+    audio:PlaySound(destroyedSound, 0)
     end 
 
     if input:KeyDown(Enum.KeyCode.A) or input:KeyDown(Enum.KeyCode.Left) then
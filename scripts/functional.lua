@@ -54,10 +54,11 @@ function this:build_hierarchy(instance)
 end
 
 -- Creates a new routine from the given bytecode and and optional environment table
+-- Files are compiled once and cached by the sandbox, each routine gets its own copy
 function this:new_routine(file, newEnv)
   local job, jobnum
 
-  local compiled = assert(loadfile(file))
+  local compiled = assert(loadchunk(file))
   -- Determine job number
   for i = 1, total_routines do
     if routines[i] == nil then
@@ -144,6 +145,14 @@ function this:kill_routine(id)
  -- collectgarbage('collect')
 end
 
+-- Drops every routine and loaded module so a restarting stage starts clean
+function this:reset()
+  routines = {}
+  ended_scripts = {}
+  total_routines = 0
+  modules = {}
+end
+
 --[[ library extensions ]]--
 function lua_wait(time)
   if not time then time = 0 end -- set default wait time
@@ -220,7 +229,7 @@ end
 
 function lua_require_module(modName)
   if modules[modName] == nil then
-    local mod = assert(loadfile(modPath .. modName .. '.lua'))
+    local mod = assert(loadchunk(modPath .. modName .. '.lua'))
 
     setfenv(mod, env)
 
@@ -56,6 +56,67 @@ function env_loadstring(data)
   return compile
 end
 
+-- Shared environment as it was when the stage finished loading
+local snapshot = nil
+
+-- Copies a value so nothing done to the copy shows up in the original. 
+-- Tables are copied all the way down, metatables included, and tables seen
+-- twice are copied once. Functions and userdata are shared: scripts can't 
+-- change them, and the state of the sandbox's own functions is cleared by 
+-- functional:reset
+local function deep_copy(value, copies)
+  if type(value) ~= "table" then
+    return value
+  elseif copies[value] ~= nil then
+    return copies[value]
+  end
+
+  local copy = {}
+  copies[value] = copy
+
+  for i, v in pairs(value) do
+    copy[i] = deep_copy(v, copies)
+  end
+
+  local meta = debug.getmetatable(value)
+
+  if meta ~= nil then
+    debug.setmetatable(copy, deep_copy(meta, copies))
+  end
+
+  return copy
+end
+
+function snapshotState()
+  -- The stage hierarchy isn't kept, init gives the stage a new one
+  local stage = env.stage
+
+  env.stage = nil
+  snapshot = deep_copy(env, {})
+  env.stage = stage
+end
+
+-- Stops every script and puts the environment back to the snapshot. Every
+-- table gets a fresh copy, so changes made before the restart don't carry
+-- over. env itself is kept, the sandbox's functions hold on to it
+function restoreState(stage)
+  functional:reset()
+
+  if snapshot ~= nil then
+    for i in pairs(env) do
+      env[i] = nil
+    end
+
+    local copies = {}
+
+    for i, v in pairs(snapshot) do
+      env[i] = deep_copy(v, copies)
+    end
+  end
+
+  init(stage)
+end
+
 function init(stage)
   env.stage = stage.hierarchy
 
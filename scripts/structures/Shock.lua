@@ -28,6 +28,7 @@ function BehaviorState(structParent)
   local wave = 0
   local parent = structParent
   local audio = game:GetSystem("Audio_Engine")
+  local attackSound = audio:GetSoundHandle("tower_splash_attack_slow.wav")
 
   -- Check if there is an enemy in the towers range
   local function EnemyInRange()
@@ -55,7 +56,7 @@ function BehaviorState(structParent)
     sw.ObjectStats.hp = range * 2 -- Dumb, but we're using hp to calculate shockwave range
     sw.Transform.scale = Vector2(0, 0)
     sw.Sprite.color = 0.25* fireColor
-    audio:PlaySounds("tower_splash_attack_slow.wav", -18)
+    audio:PlaySound(attackSound, -18)
 
     return sw.id
   end
@@ -29,6 +29,7 @@ function BehaviorState(structParent)
 
   local parent = structParent
   local audio = game:GetSystem("Audio_Engine")
+  local attackSound = audio:GetSoundHandle("tower_attack.wav")
 
   local function GetClosestEnemy()
     local enemies = stage:GetChildren("Enemy1")
@@ -60,7 +61,7 @@ function BehaviorState(structParent)
           proj.Physics.velocity = shotSpeed * dir
           proj.Physics.depthVelocity = -(proj.Transform.depth * 1.25) / time
           proj.ObjectStats.damage = damage
-          audio:PlaySounds("tower_attack.wav", -18)
+          audio:PlaySound(attackSound, -18)
           fire.Sprite.color = Color4(fireColor.r, fireColor.g, fireColor.b, 0)
 	  cooldown = cooldownTime
         end
@@ -0,0 +1,163 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+
+#include <iterator>
+#include <math.h>
+#include "../include/AudioBackend.h"
+#include "../include/SdlMixerBackend.h"
+#include "../include/Logger.h"
+#ifdef AUDIO_FMOD
+#include "../include/FmodBackend.h"
+#endif
+
+using namespace Logger;
+
+namespace
+{
+  /*! \brief
+   * Used when no audio device could be opened. Every sound opens at once and
+   * every voice ends right away (loops never do), so the engine above it
+   * behaves the same with or without sound.
+   */
+  class NullAudioBackend : public AudioBackend
+  {
+    public:
+      const char* GetName() const { return "null"; }
+      bool Init() { return true; }
+      void Update() {}
+
+      void OpenSound( SoundHandle hSound, const std::string&, bool, bool bLooping, bool )
+      {
+        if ( hSound >= static_cast<SoundHandle>( mvLooping.size() ) )
+        {
+          mvLooping.resize( hSound + 1, false );
+        }
+        mvLooping[hSound] = bLooping;
+        mvOpened.push_back( hSound );
+      }
+
+      void ReleaseSound( SoundHandle ) {}
+
+      void PollSounds( std::vector<SoundHandle>& vReady, std::vector<SoundHandle>& )
+      {
+        vReady.insert( vReady.end(), mvOpened.begin(), mvOpened.end() );
+        mvOpened.clear();
+      }
+
+      bool StartVoice( int nVoice, SoundHandle hSound, float, int, bool, const Vector3& )
+      {
+        if ( !mvLooping[hSound] )
+        {
+          mvFinished.push_back( nVoice );
+        }
+        return true;
+      }
+
+      void StopVoice( int ) {}
+      void SetVoiceVolume( int, float ) {}
+      void SetVoicePaused( int, bool ) {}
+      void SetVoicePriority( int, int ) {}
+      void SetVoicePosition( int, const Vector3& ) {}
+
+      void PollFinished( std::vector<int>& vVoices )
+      {
+        vVoices.insert( vVoices.end(), mvFinished.begin(), mvFinished.end() );
+        mvFinished.clear();
+      }
+
+    private:
+      std::vector<bool> mvLooping;
+      std::vector<SoundHandle> mvOpened;
+      std::vector<int> mvFinished;
+  };
+
+  AudioBackend* MakeBackend( const std::string& strName )
+  {
+#ifdef AUDIO_FMOD
+    if ( strName == "fmod" )
+    {
+      return new FmodBackend;
+    }
+#endif
+    if ( strName == "sdl" )
+    {
+      return new SdlMixerBackend;
+    }
+    if ( strName == "null" )
+    {
+      return new NullAudioBackend;
+    }
+    return NULL;
+  }
+}
+
+/*! \brief
+ * Makes and starts an audio backend. Falls back to the next one down the
+ * list (FMOD, then the SDL mixer, then silence) if it can't be started.
+ * \param strName
+ * "fmod", "sdl" or "null". Empty picks the best one for the platform.
+ * \return
+ * A started backend. Never NULL.
+ */
+AudioBackend* CreateAudioBackend( const std::string& strName )
+{
+#ifdef AUDIO_FMOD
+  const char* fallbacks[] = { "fmod", "sdl", "null" };
+#else
+  const char* fallbacks[] = { "sdl", "null" };
+#endif
+
+  std::vector<std::string> vNames;
+  if ( !strName.empty() )
+  {
+    vNames.push_back( strName );
+  }
+  vNames.insert( vNames.end(), std::begin( fallbacks ), std::end( fallbacks ) );
+
+  for ( size_t i = 0; i < vNames.size(); ++i )
+  {
+    AudioBackend* pBackend = MakeBackend( vNames[i] );
+    if ( !pBackend )
+    {
+      Log<Warning>("Unknown audio backend: %s", vNames[i].c_str());
+      continue;
+    }
+    if ( pBackend->Init() )
+    {
+      Log<Info>("Audio backend: %s", pBackend->GetName());
+      return pBackend;
+    }
+    Log<Warning>("Couldn't start the %s audio backend", pBackend->GetName());
+    delete pBackend;
+  }
+
+  // The null backend always starts, so this isn't reached.
+  return new NullAudioBackend;
+}
+
+/*! \brief
+ * Converts dB to volume.
+ * \param dB
+ * Input.
+ * \return
+ * Output volume value.
+ */
+float dbToVolume( float dB )
+{
+    return powf(10.0f, 0.05f * dB);
+}
+
+/*! \brief
+ * Converts volume to dB
+ * \param volume
+ * Input.
+ * \return
+ * Output dB value.
+ */
+float VolumeTodb( float volume )
+{
+    return 20.0f * log10f(volume);
+}
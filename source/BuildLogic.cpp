@@ -43,6 +43,52 @@ namespace Logic
     glm::vec3(0, 0, 1)
   });
 
+  /****************************************************************************/
+  /*!
+    \brief
+      Gets the face of an isometric block that a point local to the block is on
+  */
+  /****************************************************************************/
+  ClickedFace::Faces GetClickedFace(glm::vec2 mousePos)
+  {
+    if (topFace.PointInMesh(mousePos))
+      return ClickedFace::TOP;
+
+    if (rightFace.PointInMesh(mousePos))
+      return ClickedFace::RIGHT;
+
+    if (leftFace.PointInMesh(mousePos))
+      return ClickedFace::LEFT;
+
+    return ClickedFace::NONE;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Gets the clicked face of a block, using the face written by the GPU
+      picking pass when it picked this block and hit testing otherwise
+  */
+  /****************************************************************************/
+  ClickedFace::Faces GetClickedFace(GameInstance * block, glm::vec2 mousePos)
+  {
+    unsigned long pickedId;
+    unsigned pickedFace;
+
+    if (GSM::get().getRenderer().getPickResult(pickedId, pickedFace) && pickedId == block->getId())
+    {
+      switch (pickedFace)
+      {
+      case PF_TOP:   return ClickedFace::TOP;
+      case PF_LEFT:  return ClickedFace::LEFT;
+      case PF_RIGHT: return ClickedFace::RIGHT;
+      default: break;
+      }
+    }
+
+    return GetClickedFace(mousePos);
+  }
+
   void OnBlockClicked(GameInstance * block, const Packet & payload)
   {
     glm::vec2 mousePos = static_cast<const Message<glm::vec2> &>(payload).data;
@@ -53,13 +99,14 @@ namespace Logic
     float pi = glm::pi<float>();
 
     Engine::GameInstance * tile = nullptr;
+    ClickedFace::Faces face = GetClickedFace(block, mousePos);
 
-    if (topFace.PointInMesh(mousePos))
+    if (face == ClickedFace::TOP)
     {
       tile = &stage->getInstanceFromID(stage->GetGrid().at((int)gridPos.y).at((int)gridPos.x));
 
     }
-    else if (rightFace.PointInMesh(mousePos) && gridPos.x < stage->GetGrid().GetGridWidth())
+    else if (face == ClickedFace::RIGHT && gridPos.x < stage->GetGrid().GetGridWidth())
     {
       try
       {
@@ -78,7 +125,7 @@ namespace Logic
       }
       catch (const std::out_of_range &) {}
     }
-    else if (leftFace.PointInMesh(mousePos))
+    else if (face == ClickedFace::LEFT)
     {
       try
       {
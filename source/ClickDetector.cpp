@@ -15,6 +15,9 @@
 #include "Draw_fwd.h"
 #include "RMesh.h"
 
+#include <algorithm>
+#include <limits>
+
 using namespace Logger;
 using namespace DrawUtils;
 
@@ -31,82 +34,308 @@ namespace Engine
     meshId = obj.getComponentProperty<std::string>("ClickDetector", "MeshType");
   }
 
+  /****************************************************************************/
+  /*!
+    \brief
+      Switches the detector to a new draw element. Its bounds are recalculated
+      on the next update
+
+    \param token
+      The instance's new draw element
+  */
+  /****************************************************************************/
+  void ClickDetector::resetToken(const DrawToken & token)
+  {
+    token_ = token;
+    hasToken_ = true;
+    stamp_ = 0;
+  }
+
   ClickDetectorHandler::ClickDetectorHandler(Stage * stage) :
-    ComponentHandler(stage, "ClickDetector"), lastMousedOver_(0)
+    ComponentHandler(stage, "ClickDetector"), lastMousedOver_(0), indexedRevision_(0)
   {
     dependencies_ = { "Sprite" };
   }
 
+  /****************************************************************************/
+  /*!
+    \brief
+      Refreshes the cached inverse matrix and screen bounds of a detector if
+      its draw element's final matrix was rebuilt since the last refresh
+
+    \param detector
+      The detector to refresh
+
+    \param ar
+      Aspect ratio of the display, so the element's cached matrix is reused
+
+    \return
+      True if the detector's bounds changed
+  */
+  /****************************************************************************/
+  bool ClickDetectorHandler::refreshDetector(ClickDetector * detector, float ar)
+  {
+    if (!detector->hasToken_)
+    {
+      detector->token_ = detector->getParent().RequestData<DrawToken>("Graphic");
+      detector->hasToken_ = true;
+    }
+
+    glm::mat4 matrixFinal = detector->token_.getFinalMatrix(ar);
+    size_t stamp = detector->token_.getFinalStamp();
+
+    if (stamp == detector->stamp_)
+      return false;
+
+    detector->stamp_ = stamp;
+    detector->inverse_ = glm::inverse(matrixFinal);
+
+    const RMesh * detectorMesh = GSM::get().getRenderer().getMesh(detector->getMeshID());
+    detector->onScreen_ = false;
+
+    if (detectorMesh == nullptr || detectorMesh->verts.empty())
+      return true;
+
+    glm::vec2 min{ std::numeric_limits<float>::max() };
+    glm::vec2 max{ -std::numeric_limits<float>::max() };
+
+    for (auto & vert : detectorMesh->verts)
+    {
+      glm::vec4 point = matrixFinal * glm::vec4(vert.point.x, vert.point.y, 0, 1);
+
+      min = glm::min(min, glm::vec2(point.x, point.y));
+      max = glm::max(max, glm::vec2(point.x, point.y));
+    }
+
+    detector->min_ = min;
+    detector->max_ = max;
+    detector->onScreen_ = (max.x >= -1 && min.x <= 1 && max.y >= -1 && min.y <= 1);
+
+    return true;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Gets the range of picking grid cells covered by screen space bounds
+  */
+  /****************************************************************************/
+  void ClickDetectorHandler::getCellRange(const glm::vec2 & min, const glm::vec2 & max, 
+                                          int & x0, int & y0, int & x1, int & y1) const
+  {
+    auto toCell = [](float ndc)
+    {
+      int cell = static_cast<int>((ndc + 1) * 0.5f * PICK_GRID_SIZE);
+      return std::max(0, std::min(PICK_GRID_SIZE - 1, cell));
+    };
+
+    x0 = toCell(min.x);
+    y0 = toCell(min.y);
+    x1 = toCell(max.x);
+    y1 = toCell(max.y);
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Lists a detector in the picking grid cells its bounds overlap, if it is
+      on screen
+  */
+  /****************************************************************************/
+  void ClickDetectorHandler::insertIntoGrid(ClickDetector * detector)
+  {
+    if (!detector->onScreen_)
+      return;
+
+    getCellRange(detector->min_, detector->max_, 
+                 detector->cellX0_, detector->cellY0_, detector->cellX1_, detector->cellY1_);
+
+    for (int y = detector->cellY0_; y <= detector->cellY1_; ++y)
+      for (int x = detector->cellX0_; x <= detector->cellX1_; ++x)
+        pickGrid_[y * PICK_GRID_SIZE + x].push_back(detector);
+
+    detector->inGrid_ = true;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Takes a detector out of the picking grid cells it was listed in
+  */
+  /****************************************************************************/
+  void ClickDetectorHandler::removeFromGrid(ClickDetector * detector)
+  {
+    if (!detector->inGrid_)
+      return;
+
+    for (int y = detector->cellY0_; y <= detector->cellY1_; ++y)
+    {
+      for (int x = detector->cellX0_; x <= detector->cellX1_; ++x)
+      {
+        std::vector<ClickDetector *> & cell = pickGrid_[y * PICK_GRID_SIZE + x];
+        auto it = std::find(cell.begin(), cell.end(), detector);
+
+        if (it != cell.end())
+        {
+          *it = cell.back();
+          cell.pop_back();
+        }
+      }
+    }
+
+    detector->inGrid_ = false;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Rebuilds the picking grid from the cached bounds of every detector. Only
+      needed when detectors are added or removed, moved detectors are updated
+      in place
+  */
+  /****************************************************************************/
+  void ClickDetectorHandler::rebuildPickGrid()
+  {
+    pickGrid_.resize(PICK_GRID_SIZE * PICK_GRID_SIZE);
+
+    for (auto & cell : pickGrid_)
+      cell.clear();
+
+    for (auto & component : componentList_)
+    {
+      ClickDetector * detector = static_cast<ClickDetector *>(component);
+
+      detector->inGrid_ = false;
+      insertIntoGrid(detector);
+    }
+
+    indexedRevision_ = listRevision_;
+  }
+
+  // Drops the cached draw token when the instance's graphic is replaced
+  static void OnGraphicChanged(ClickDetector * detector, const Packet & payload)
+  {
+    detector->resetToken(payload.getData<DrawToken>());
+  }
+
   /*
   Mouse to screen (Camera->camera to world?)
   World to object (inverse transform matrix)
 
+  Detectors are bucketed into a screen space grid by the bounds of their mesh,
+  so only the ones under the cursor are hit tested. Bounds and inverse matrices
+  are only recalculated when a draw element's final matrix is rebuilt
 
-  Somewhat hacky way of doing this. Assumes all objects use the same square mesh and probably inefficient
+  With GPU picking on, the candidates are drawn into the renderer's id buffer
+  instead and the front one is taken from the id read back on a previous frame
   */
   void ClickDetectorHandler::update()
   {
 
     // Check for mouse exiting last object
     unsigned long frontClicked = 0; // Current front object
-    unsigned frontOrder = 0;                    // Draw order of the front object
+    size_t frontOrder = 0;                    // Draw order of the front object
     glm::vec2 clickPos;
 
-    Camera & cam = GSM::get().getCamera();
     DrawSystem & disp = GSM::get().getRenderer();
 
     int screenWidth = disp.getViewWidth();
     int screenHeight = disp.getViewHeight();
 
-    glm::mat4 camWorld = cam.CameraToWorld();
     glm::vec2 mousePos = InputSystem::MousePosition() -glm::vec2(disp.getViewOffsetX(), disp.getViewOffsetY());
     mousePos.x = (2 * (mousePos.x / screenWidth)) - 1;
     mousePos.y = (-2 * mousePos.y / screenHeight) + 1;
 
     glm::vec4 mouse4(mousePos.x, mousePos.y, 0, 1);
 
+    float ar = disp.getAspectRatio();
+
+    // Refresh detectors whose elements moved. Moved detectors change cells in
+    // place, the whole grid is only rebuilt when detectors come or go
+    bool rebuild = pickGrid_.empty() || indexedRevision_ != listRevision_;
+
     for (auto & component : componentList_)
     {
-      glm::vec4 mouse4temp{ mouse4 };
-
       ClickDetector * detector = static_cast<ClickDetector *>(component);
-      GameInstance & parent = component->getParent();
 
-      DrawToken obj = parent.RequestData<DrawToken>("Graphic");
-      glm::mat4 matrixFinal = obj.getFinalMatrix(1);
-      glm::mat4 invFinal = glm::inverse(matrixFinal);
+      if (refreshDetector(detector, ar) && !rebuild)
+      {
+        removeFromGrid(detector);
+        insertIntoGrid(detector);
+      }
+    }
+
+    if (rebuild)
+      rebuildPickGrid();
 
-      DrawLayer layer = parent.RequestData<DrawLayer>("DrawLayer");
-      //glm::mat4 layerTransInv = glm::inverse(disp.getDrawGroup(layer).getTransformation());
+    int cellX, cellY, unused;
+    getCellRange(mousePos, mousePos, cellX, cellY, unused, unused);
 
-      glm::vec4 mouseObj = invFinal * mouse4temp;
-      glm::vec2 mousePos(mouseObj.x, mouseObj.y);
+    bool mouseOnScreen = (mousePos.x >= -1 && mousePos.x <= 1 && mousePos.y >= -1 && mousePos.y <= 1);
 
-      const RMesh * detectorMesh = disp.getMesh(detector->getMeshID());
+    unsigned long pickedId = 0;
+    unsigned pickedFace;
+    bool gpuPicked = disp.isGPUPicking() && disp.getPickResult(pickedId, pickedFace);
 
+    disp.setPickPoint(mousePos);
 
-      // Transformation matrix for mouse
-      if (detectorMesh != nullptr && detectorMesh->pointInMesh(mousePos))
+    if (mouseOnScreen && disp.isGPUPicking())
+    {
+      for (ClickDetector * detector : pickGrid_[cellY * PICK_GRID_SIZE + cellX])
       {
-        size_t currOrder = detector->getParent().RequestData<size_t>("DrawOrder");
+        if (mousePos.x < detector->min_.x || mousePos.x > detector->max_.x ||
+            mousePos.y < detector->min_.y || mousePos.y > detector->max_.y)
+          continue;
 
-        //  /*
-        //    An object will be drawn first if it's draw order is higher than another.
-        //    That means that if an object has a higher draw order than another, it is in front of
-        //    it, and is likely what was clicked on
-        //  */
+        unsigned long id = detector->getParent().getId();
 
-        // Detect inside mesh
+        disp.queuePick(disp.getMesh(detector->getMeshID()), detector->token_.getFinalMatrix(ar),
+                       id, GetTokenDrawOrder(detector->token_));
 
-        if (frontClicked == 0 || currOrder >= frontOrder)
+        // Take the picked object only while it is still under the cursor
+        if (gpuPicked && id == pickedId)
         {
-          frontOrder = currOrder;
-          frontClicked = detector->getParent().getId();
+          glm::vec4 mouseObj = detector->inverse_ * mouse4;
+
+          frontClicked = id;
           clickPos = glm::vec2(mouseObj.x, mouseObj.y);
         }
-
       }
+    }
+    else if (mouseOnScreen)
+    {
+      for (ClickDetector * detector : pickGrid_[cellY * PICK_GRID_SIZE + cellX])
+      {
+        if (mousePos.x < detector->min_.x || mousePos.x > detector->max_.x ||
+            mousePos.y < detector->min_.y || mousePos.y > detector->max_.y)
+          continue;
+
+        glm::vec4 mouseObj = detector->inverse_ * mouse4;
+        glm::vec2 mouseLocal(mouseObj.x, mouseObj.y);
+
+        const RMesh * detectorMesh = disp.getMesh(detector->getMeshID());
 
+        // Transformation matrix for mouse
+        if (detectorMesh != nullptr && detectorMesh->pointInMesh(mouseLocal))
+        {
+          size_t currOrder = GetTokenDrawOrder(detector->token_);
+
+          //  /*
+          //    An object will be drawn first if it's draw order is higher than another.
+          //    That means that if an object has a higher draw order than another, it is in front of
+          //    it, and is likely what was clicked on
+          //  */
+
+          // Detect inside mesh
+
+          if (frontClicked == 0 || currOrder >= frontOrder)
+          {
+            frontOrder = currOrder;
+            frontClicked = detector->getParent().getId();
+            clickPos = mouseLocal;
+          }
+        }
+      }
     }
 
     if (frontClicked && InputSystem::Mouse1Clicked())
@@ -150,6 +379,10 @@ namespace Engine
   {
     Messenger & objMessenger = base_sub->getParent().getMessenger();
 
+    SUBSCRIBER_ACTION onGraphicChanged = std::bind(OnGraphicChanged, static_cast<ClickDetector *>(base_sub), std::placeholders::_1);
+
+    objMessenger.Subscribe(objMessenger, "GraphicChanged", onGraphicChanged);
+
     ScriptRouter & router = getStage()->getScriptEventRouter();
 
     std::vector<std::shared_ptr<ScriptEvent>> events;
@@ -6,7 +6,6 @@
 #include "../include/GameInstance.h"
 #include "../include/GSM.h"
 #include "../include/Logger.h"
-#include <fstream>
 
 using namespace Logger;
 
@@ -136,10 +135,8 @@ namespace Engine
 
   void Component::setBehaviorScript(const std::string & behavior) 
   { 
-    std::ifstream file(behavior);
-
     behaviorScript_ = behavior;
-    behaviorDefined_ = file.good();
+    behaviorDefined_ = Sandbox::ChunkExists(behavior);
 
 #ifdef _DEBUG
     //if(!behaviorDefined_)
@@ -168,7 +165,8 @@ namespace Engine
   */
   /****************************************************************************/
   ComponentHandler::ComponentHandler( Stage * owner, const std::string & type, bool pausable) :
-                                      stage_(owner), handlerType_(type), isPausable_(pausable)
+                                      listRevision_(0), stage_(owner), handlerType_(type), isPausable_(pausable),
+                                      preUpdateEvent_(type + "PreUpdate"), updateEvent_(type + "Update")
   {
     stage_->addHandler(this);
   }
@@ -216,6 +214,7 @@ namespace Engine
       {
         // Add the componnt to the list
         componentList_.push_back(registar);
+        ++listRevision_;
       }
       // Not enough space to register a new component (highly unlikely)
       catch (const std::bad_alloc &)
@@ -257,6 +256,7 @@ namespace Engine
          std::iter_swap(componentList_.begin() + i, componentList_.end() - 1);
 
          componentList_.pop_back();
+         ++listRevision_;
 
          return true; // Component was found in the handler
       }
@@ -336,15 +336,17 @@ namespace Engine
 
   void ComponentHandler::updateComponents()
   {
+    const float dt = GSM::get().getDisplay().GetFrameTime();
+
     for (auto * component : componentList_)
-      component->getParent().PostMessage(handlerType_ + "PreUpdate", GSM::get().getDisplay().GetFrameTime());
+      component->getParent().PostMessage(preUpdateEvent_, dt);
 
     // Calls C++ update function
     update();
 
     // Fires Component update, can be recieved by scripts
     for (auto * component : componentList_)
-      component->getParent().PostMessage(handlerType_ + "Update", GSM::get().getDisplay().GetFrameTime());
+      component->getParent().PostMessage(updateEvent_, dt);
   }
   // Exceptions
 
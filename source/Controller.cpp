@@ -9,6 +9,7 @@
 #include "../include/grid.h"
 #include "../include/audio_startup.h"
 #include "../include/BuildLogic.h"
+#include "../include/DrawUtils.h"
 #include <luabind/luabind.hpp>
 
 #include "../include/MenuButtons.h"
@@ -98,11 +99,21 @@ namespace Engine
     return &LoadedStructureList;
   }
 
+  STRUCT_INDEX * Controller::getStructureIndex()
+  {
+    return &LoadedStructureIndex;
+  }
+
   void Controller::LSLRequest(Packet & data)
   {
     data.setData(getParsedStructs());
   }
 
+  void Controller::LSIRequest(Packet & data)
+  {
+    data.setData(getStructureIndex());
+  }
+
   /****************************************************************************/
   /*!
   \brief
@@ -252,7 +263,8 @@ namespace Engine
   /****************************************************************************/
   Controller::Controller(GameInstance* owner) : Component(owner, "Controller") ,
     health_(5), walls_available_(5), godMode_(false), autoplay_(false), 
-    healthId_(0), ammoId_(0), progressId_(0), waveId_(0), waveTextId_(0), waveNum_(0), waveCount_(3)
+    healthId_(0), ammoId_(0), progressId_(0), waveId_(0), waveTextId_(0), waveNum_(0), waveCount_(3),
+    auto_timer_(&owner->getStage()->getClock()), regen_timer_(&owner->getStage()->getClock())
   {
     positions_.clear();
     ID_.clear();
@@ -281,15 +293,11 @@ namespace Engine
     walls_available_(obj.getComponentProperty<unsigned>("Controller", "walls")),
     godMode_(obj.getComponentProperty<bool>("Controller", "god")), autoplay_(false),
     healthId_(0), ammoId_(0), progressId_(0), waveId_(0), waveTextId_(0), waveNum_(0), waveCount_(10),
-    wavesRunning_(false)
+    wavesRunning_(false),
+    auto_timer_(&owner->getStage()->getClock()), regen_timer_(&owner->getStage()->getClock())
   {
     UpdateCount();
     regen_timer_.Reset();
-
-    if (!owner->getStage()->isStageRunning())
-      regen_timer_.Pause();
-    else
-      regen_timer_.UnPause();
   }
 
   void Controller::Begin()
@@ -461,6 +469,52 @@ namespace Engine
     UpdateCount();
   }
 
+  /****************************************************************************/
+  /*!
+  \brief
+  Shows a number over a HUD counter with a text label in place of its sprite
+
+  \param label
+  Label of the counter, made the first time it is needed
+
+  \param counter
+  Graphic of the counter
+
+  \param value
+  The number to show
+
+  \return
+  False if no HUD font is loaded, in which case the counter should fall back
+  to its texture frames
+  */
+  /****************************************************************************/
+  static bool SetCounterText(TextToken & label, DrawToken & counter, unsigned value)
+  {
+    DrawSystem & disp = GSM::get().getRenderer();
+
+    if (!label.isValid())
+    {
+      const Font * font = disp.getFont("HUD");
+
+      if (font == nullptr || !font->isLoaded())
+        return false;
+
+      label = disp.newText(DrawUtils::RL_HUD, "HUD");
+    }
+
+    glm::mat4 mat = counter.getFinalMatrix(disp.getAspectRatio());
+
+    // Centre the label on the counter and match its height
+    label.setPosition(glm::vec2{ mat[3].x, mat[3].y });
+    label.setSize(glm::length(glm::vec2{ mat[1].x, mat[1].y }));
+    label.setText(std::to_string(value));
+    label.setColor(counter.getShade());
+
+    counter.setVisible(false);
+
+    return true;
+  }
+
   /****************************************************************************/
   /*!
   \brief
@@ -474,8 +528,6 @@ namespace Engine
     {
       // get HUD element instance
       GameInstance & resCount = getParent().getStage()->getInstanceFromID(ammoId_);
-      // switch texture frames based on walls available
-      resCount.PostMessage("TextureFrameSet", Message<unsigned>((walls_available_ <= 16) ? walls_available_ : 16));
       DrawToken p = resCount.RequestData<DrawToken>("Graphic");
       static glm::vec4 orig_color = p.getShade(); // original color
       static Timer timer;
@@ -503,7 +555,10 @@ namespace Engine
         p.setShade(orig_color);
 		  blinks = 0;
 	  }
-      
+
+      // switch texture frames based on walls available if there's no font for the count
+      if (!SetCounterText(wallsText_, p, walls_available_))
+        resCount.PostMessage("TextureFrameSet", Message<unsigned>((walls_available_ <= 16) ? walls_available_ : 16));
     }
     catch (const std::out_of_range &)
     {
@@ -513,11 +568,16 @@ namespace Engine
     try
     {
       GameInstance & hpCount = getParent().getStage()->getInstanceFromID(healthId_);
-      unsigned hpFrame;
+      DrawToken p = hpCount.RequestData<DrawToken>("Graphic");
+
+      if (!SetCounterText(healthText_, p, health_))
+      {
+        unsigned hpFrame;
 
-      hpFrame = health_;
+        hpFrame = health_;
 
-      hpCount.PostMessage("TextureFrameSet", hpFrame);
+        hpCount.PostMessage("TextureFrameSet", hpFrame);
+      }
     }
     catch (const std::out_of_range &)
     {
@@ -884,13 +944,6 @@ namespace Engine
     //dynamic_cast<Message<OBJECT_BY_TILE_LIST>*>&>(data).data = &getBlocksAtTileList();
   }
 
-  void Controller::onStagePaused(const Packet & data)
-  {
-    bool paused = data.getData<bool>();
-
-    regen_timer_.Pause();
-  }
-
 
   void Controller::OnWavePaused(const Packet & payload)
   {
@@ -931,7 +984,6 @@ namespace Engine
     SUBSCRIBER_ACTION setWaveText = std::bind(OnMenuIDSet, sub, &Controller::SetWaveTextID, std::placeholders::_1);
     SUBSCRIBER_ACTION setWaveCount = std::bind(OnMenuIDSet, sub, &Controller::SetWaveCountID, std::placeholders::_1);
     SUBSCRIBER_ACTION waveChanged = std::bind(&Controller::onWaveChanged, sub, std::placeholders::_1);
-    SUBSCRIBER_ACTION onStagePaused = std::bind(&Controller::onStagePaused, sub, std::placeholders::_1);
     SUBSCRIBER_ACTION onBegin = std::bind(&Controller::OnWavePaused, sub, std::placeholders::_1);
  
     SUBSCRIBER_ACTION onWaveCountSet = [sub](const Packet& data) {sub->setWaveCount(data.getData<size_t>()); };
@@ -955,6 +1007,7 @@ namespace Engine
     REQUEST_ACTION hpIDReq = std::bind(HPIDRequest, sub, std::placeholders::_1);
     REQUEST_ACTION resIDReq = std::bind(ResourceIDRequest, sub, std::placeholders::_1);
     REQUEST_ACTION lslReq = std::bind(&Controller::LSLRequest, sub, std::placeholders::_1);
+    REQUEST_ACTION lsiReq = std::bind(&Controller::LSIRequest, sub, std::placeholders::_1);
     REQUEST_ACTION requestTilePos = std::bind(&Controller::tilePositionRequest, sub, std::placeholders::_1);
     REQUEST_ACTION reqBlocksOnTile = std::bind(&Controller::tileBlocksRequest, sub, std::placeholders::_1);
 
@@ -974,7 +1027,6 @@ namespace Engine
     objMessenger.Subscribe(objMessenger, "SetNumWaves", onWaveCountSet);
 
     objMessenger.Subscribe(getStage()->getMessenger(), "CurrentWave", waveChanged);
-    objMessenger.Subscribe(getStage()->getMessenger(), "STAGE_PAUSED", onStagePaused);
     objMessenger.Subscribe(getStage()->getMessenger(), "Begin", onBegin);
     objMessenger.Subscribe(getStage()->getMessenger(), "SetWavesRunning", wavesRunning);
     objMessenger.Subscribe(getStage()->getMessenger(), "SetSpaceVisible", spaceVisible);
@@ -988,6 +1040,7 @@ namespace Engine
     objMessenger.SetupRequest("ResourceCounterID", resIDReq);
     objMessenger.SetupRequest("HPCounterID", hpIDReq);
     objMessenger.SetupRequest("GetParsedStructureList", lslReq);
+    objMessenger.SetupRequest("GetStructureIndex", lsiReq);
     objMessenger.SetupRequest("TilePositionVector", requestTilePos);
     objMessenger.SetupRequest("BlocksOnTile", reqBlocksOnTile);
 
@@ -1078,15 +1131,18 @@ namespace Engine
           //The Won and Lost conditions prevent it from playing after the level is over.
           if ( i == 0 && !dynamic_cast<Controller*>(component)->isLost() && !dynamic_cast<Controller*>(component)->isWon())
           {
-            GetAudioEngine()->PlaySounds("ResourceGained.wav", Vector3(), -30.0f);
+            static const SoundHandle gainedSound = GetAudioEngine()->GetSoundHandle("ResourceGained.wav");
+            GetAudioEngine()->PlaySounds(gainedSound, Vector3(), -30.0f);
           }
           else if ( i == 1 )
           {
-            GetAudioEngine()->PlaySounds("ResourceGained2.wav", Vector3(), -30.0f);
+            static const SoundHandle gainedSound2 = GetAudioEngine()->GetSoundHandle("ResourceGained2.wav");
+            GetAudioEngine()->PlaySounds(gainedSound2, Vector3(), -30.0f);
           }
           else
           {
-            GetAudioEngine()->PlaySounds("ResourceGained3.wav", Vector3(), -30.0f);
+            static const SoundHandle gainedSound3 = GetAudioEngine()->GetSoundHandle("ResourceGained3.wav");
+            GetAudioEngine()->PlaySounds(gainedSound3, Vector3(), -30.0f);
           }
           // END OF SOUND CUE
         }
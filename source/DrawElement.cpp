@@ -17,6 +17,7 @@ void DrawElement::update() const
   scale_ = glm::scale(glm::vec3{ scale.x, scale.y, 1 });
 
   needsUpdate_ = false;
+  finalValid_ = false;
 }
 
 /**
@@ -36,7 +37,7 @@ bool DrawElement::doesNeedUpdate() const
 */
 const glm::mat4 DrawElement::getMatrix(float ar) const
 {
-  glm::mat4 & scaling = scale_;
+  glm::mat4 scaling = scale_;
 
   switch (ref)
   {
@@ -59,8 +60,11 @@ DrawElement::DrawElement(DrawGroup * parent,
   const RMesh * _mesh, const DrawSurface * _surface, 
   const glm::vec4 & _shade) :
   parent_(parent), shade(_shade), position(_pos), scale(_scale), rotation(_rot), 
-  frame{ 0 }, depth{ 0 },
+  ref{ ScaleReference::XY }, frame{ 0 }, depth{ 0 }, isoY{ 0 },
   surface(_surface), mesh(_mesh),
   visible{true},
-  needsUpdate_{ true }
+  needsUpdate_{ true },
+  finalAr_{ 0 }, finalEpoch_{ 0 }, finalStamp_{ 0 }, finalValid_{ false },
+  boundsMin_{ 0, 0 }, boundsMax_{ 0, 0 }, onScreen_{ true },
+  baked_{ false }
 {}
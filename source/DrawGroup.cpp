@@ -5,18 +5,30 @@
 // ---------------------------------------------------------------------------------
 #include "DrawGroup.h"
 #include "Renderer.h"
+#include "RenderQueue.h"
 #include "RMesh.h"
 #include "DrawSurface.h"
+#include "EngineCounters.h"
+#include "MemoryTracker.h"
+
+#include <limits>
+#include <algorithm>
+#include "glm/glm/common.hpp"
 
 using namespace Logger;
 
+// Source of final matrix stamps, shared by all groups so stamps stay unique
+// when an element moves between layers
+static size_t matrixStamp = 0;
+
 /**
 * \brief  Constructor for DrawGroups. Sets the sorting function and initializes ID values
 *
 * \param  sorter  The sorter
 */
 DrawGroup::DrawGroup(const COMPFUNC & sorter) :
-  total_{ 0 }, sorter_{ sorter }
+  orderDirty_{ false }, epoch_{ 0 }, total_{ 0 }, sorter_{ sorter },
+  keepOrder_{ false }, baked_{ false }, bakeDirty_{ false }, bakedRef_{ 0 }
 {}
 
 /**
@@ -42,6 +54,49 @@ void DrawGroup::setSortFunc(const COMPFUNC & func)
 void DrawGroup::setModFunc(const MODFUNC & func)
 {
   modifier_ = func;
+  ++epoch_;
+  bakeDirty_ = true;
+}
+
+/**
+* \brief  Sets whether the group's elements are baked into static batches.
+*         Meant for layers that rarely change, like the grid's tiles.
+*
+* \param  baked  Whether to bake the group
+*/
+void DrawGroup::setBaked(bool baked)
+{
+  baked_ = baked;
+  bakeDirty_ = true;
+
+  if (!baked_)
+  {
+    for (auto & object : objects_)
+      object.second.element.baked_ = false;
+
+    chunks_.clear();
+    chunkIds_.clear();
+    bakedSlots_.clear();
+    attributeDirty_.clear();
+    transformDirty_.clear();
+  }
+}
+
+bool DrawGroup::isBaked() const
+{
+  return baked_;
+}
+
+/**
+* \brief  Sets whether elements the sorter considers equal are drawn in the
+*         order they were created, instead of being grouped by texture and
+*         mesh. Meant for UI layers, where overlapping widgets share a depth.
+*
+* \param  keep  Whether to keep creation order
+*/
+void DrawGroup::setKeepOrder(bool keep)
+{
+  keepOrder_ = keep;
 }
 
 /**
@@ -52,6 +107,7 @@ void DrawGroup::setModFunc(const MODFUNC & func)
 void DrawGroup::setTransformation(const glm::mat4 & transfrom)
 {
   global_ = transfrom;
+  ++epoch_;
 }
 
 /**
@@ -68,11 +124,21 @@ void DrawGroup::setTransformation(const glm::mat4 & transfrom)
 */
 DrawToken DrawGroup::newElement(const glm::vec2 & pos, const glm::vec2 & scale, float rot, const RMesh * mesh, const DrawSurface * surface, const glm::vec4 & shade)
 {
+  // Usually called from component init, which would count it as ECS
+  Engine::MemoryTracker::Scope scope(Engine::MemoryTag::Render);
+
   size_t id = ++total_;
 
   drawOrder_.push_back(id);
+
+  if (!orderDirty_)
+    orderIndex_[id] = drawOrder_.size() - 1;
+
   objects_.insert(std::make_pair(id, DrawStruct{ this, pos, scale, rot, mesh, surface, shade }));
 
+  if (baked_)
+    bakeDirty_ = true;
+
   return DrawToken(this, id);
 }
 
@@ -90,43 +156,143 @@ DrawToken DrawGroup::newElement(const RMesh * mesh, const DrawSurface * surface)
 }
 
 /**
-* \brief  Draws all elements to the given renderer
+* \brief  Adds every visible element to a render queue in draw order
 *
-* \param [in,out] render  The render to draw to
+* \param [in,out] queue  The queue to add to
+* \param [in,out] render The renderer, used to build static batches
+* \param          layer  The layer this group is drawn on
 */
-void DrawGroup::draw(Renderer & render)
+void DrawGroup::collect(RenderQueue & queue, Renderer & render, DrawLayer layer)
 {
+  float ar = static_cast<float>(render.getWidth()) / render.getHeight();
+
   scrub();
+
+  // Rebuild matrices before sorting so iso sorting uses this frame's positions
+  updateFinalMatrices(ar);
   sort();
 
-  float ar = static_cast<float>(render.getWidth()) / render.getHeight();
+  // Baked after sorting, since batches follow the draw order
+  if (baked_)
+    updateBaked(ar);
+
+  uint32_t rank = 0;
+  size_t prevId = 0;
+  bool first = true;
+  size_t culled = 0;
+  size_t submitted = 0;
+  size_t chunksDrawn = 0;
+
   for (auto & elId : drawOrder_)
   {
-    const DrawElement & element = getElement(elId);
+    const DrawElement & element = peekElement(elId);
 
+    // A batch is drawn in place of its first element. The rest of its elements
+    // follow it in draw order, so nothing else can come between them
+    if (element.baked_)
+    {
+      const BakedSlot & slot = bakedSlots_.at(elId);
 
-    if (element.doesNeedUpdate())
-      element.update();
+      if (slot.index == 0)
+      {
+        if (!first && (keepOrder_ || !sorter_ || sorter_(getToken(prevId), getToken(elId))))
+          ++rank;
+
+        if (pushChunk(queue, layer, rank, slot.chunk))
+          ++chunksDrawn;
+
+        first = false;
+      }
+
+      prevId = elId;
+      continue;
+    }
     
-    if (element.visible)
+    if (!element.visible)
+      continue;
+
+    // Visibility is kept per element rather than in a spatial grid. Modifiers
+    // are arbitrary per element functions, so the screen can't be mapped back
+    // into group space to look cells up, and every element is already visited
+    // here and by the sort. Baked elements are culled per chunk instead
+    if (!element.onScreen_)
     {
-      const DrawToken token = getToken(elId);
-      glm::mat4 objectTrans{ token.getFinalMatrix(ar) };
-
-      render.draw(*element.mesh, objectTrans, element.shade, element.surface, element.frame);
+      ++culled;
+      continue;
     }
+
+    // Elements the sorter can't order share a rank unless the group keeps its
+    // order. Without a sorter, creation order is kept
+    if (!first && (keepOrder_ || !sorter_ || sorter_(getToken(prevId), getToken(elId))))
+      ++rank;
+
+    queue.push(layer, rank, element.mesh, element.surface, element.final_, element.shade, element.frame);
+    ++submitted;
+
+    prevId = elId;
+    first = false;
   }
+
+  Engine::EngineCounters::Add("Elements culled", static_cast<double>(culled));
+  Engine::EngineCounters::Add("Elements submitted", static_cast<double>(submitted));
+
+  if (baked_)
+    Engine::EngineCounters::Add("Static batches drawn", static_cast<double>(chunksDrawn));
 }
 
+/**
+* \brief  Gets the final matrix of an element, rebuilding it only if the element
+*         or the group transformation changed since it was last built
+*
+* \param  id  The identifier
+* \param  ar  The aspect ratio
+*
+* \return The final matrix.
+*/
+const glm::mat4 & DrawGroup::getFinalMatrix(size_t id, float ar)
+{
+  const DrawElement & element = peekElement(id);
+
+  if (element.doesNeedUpdate())
+    element.update();
+
+  if (!isFinalCurrent(element, ar))
+  {
+    glm::mat4 mod;
+    glm::mat4 local;
+
+    computeModifier(id, element, ar, mod, local);
+    storeFinal(element, global_ * mod * local, ar);
+  }
+
+  return element.final_;
+}
+
+/**
+* \brief  Gets the position of an element in the draw order
+*
+* \param  id  The identifier
+*
+* \return The draw order, or the group size if the element isn't drawn
+*/
 size_t DrawGroup::getDrawOrder(size_t id) const
 {
-  for (size_t i = 0; i < drawOrder_.size(); i++)
+  if (orderDirty_)
   {
-    if (drawOrder_[i] == id)
-      return i;
+    orderIndex_.clear();
+
+    for (size_t i = 0; i < drawOrder_.size(); i++)
+      orderIndex_[drawOrder_[i]] = i;
+
+    orderDirty_ = false;
   }
 
-  return drawOrder_.size();
+  auto found = orderIndex_.find(id);
+
+  if (found == orderIndex_.end())
+    return drawOrder_.size();
+
+  return found->second;
 }
 
 size_t DrawGroup::size() const
@@ -225,9 +391,467 @@ DrawElement & DrawGroup::getElement(size_t token)
 
   element.needsUpdate_ = true;
 
+  if (element.baked_)
+    transformDirty_.push_back(token);
+
+  return element;
+}
+
+/**
+* \brief  Gets an element to change its shade, frame or visibility. Unlike
+*         getElement, this doesn't flag the element's matrix for rebuilding,
+*         and baked elements only have their attributes updated.
+*
+* \exception  std::out_of_range Thrown when an invalid token is passed
+*
+* \param  token The token
+*
+* \return The element.
+*/
+DrawElement & DrawGroup::getElementAttributes(size_t token)
+{
+  auto it = objects_.find(token);
+
+  if (it == objects_.end())
+    throw std::out_of_range("Attempting to retrieve unknown draw element");
+
+  if (it->second.element.baked_)
+    attributeDirty_.push_back(token);
+
+  return it->second.element;
+}
+
+/**
+* \brief  Gets an element to change its mesh, surface or scale reference. These
+*         decide which static batch an element belongs in, if any, so baked
+*         groups are baked again.
+*
+* \exception  std::out_of_range Thrown when an invalid token is passed
+*
+* \param  token The token
+*
+* \return The element.
+*/
+DrawElement & DrawGroup::getElementBatch(size_t token)
+{
+  DrawElement & element = getElement(token);
+
+  if (baked_)
+    bakeDirty_ = true;
+
   return element;
 }
 
+/**
+* \brief  Gets an element without flagging its matrix for rebuilding
+*
+* \param  token The token
+*
+* \return The element.
+*/
+const DrawElement & DrawGroup::peekElement(size_t token) const
+{
+  return getElement(token);
+}
+
+/**
+* \brief  Determines if the cached final matrix of an element is still valid
+*
+* \param  element The element
+* \param  ar      The aspect ratio
+*
+* \return True if the cached matrix can be used.
+*/
+bool DrawGroup::isFinalCurrent(const DrawElement & element, float ar) const
+{
+  if (!element.finalValid_ || element.finalEpoch_ != epoch_)
+    return false;
+
+  // Only elements scaled against the screen depend on the aspect ratio
+  return element.ref == ScaleReference::XY || element.finalAr_ == ar;
+}
+
+/**
+* \brief  Runs the group modifier for an element
+*
+* \param        id      The identifier
+* \param        element The element
+* \param        ar      The aspect ratio
+* \param [out]  mod     The modification matrix
+* \param [out]  local   The element matrix, or identity if the modifier overrides it
+*/
+void DrawGroup::computeModifier(size_t id, const DrawElement & element, float ar, glm::mat4 & mod, glm::mat4 & local)
+{
+  bool ovride = false;
+
+  mod = glm::mat4();
+  local = glm::mat4();
+
+  if (modifier_)
+  {
+    auto res = modifier_(getToken(id));
+    mod = res.first;
+    ovride = res.second;
+  }
+
+  if (!ovride)
+    local = element.getMatrix(ar);
+}
+
+/**
+* \brief  Rebuilds the final matrices of every visible element that is out of
+*         date. The matrices are gathered into contiguous arrays and combined
+*         in one tight loop
+*
+* \param  ar  The aspect ratio
+*/
+void DrawGroup::updateFinalMatrices(float ar)
+{
+  dirtyIds_.clear();
+  modBatch_.clear();
+  localBatch_.clear();
+
+  for (auto & elId : drawOrder_)
+  {
+    const DrawElement & element = peekElement(elId);
+
+    if (!element.visible || element.baked_)
+      continue;
+
+    if (element.doesNeedUpdate())
+      element.update();
+
+    if (isFinalCurrent(element, ar))
+      continue;
+
+    dirtyIds_.push_back(elId);
+    modBatch_.emplace_back();
+    localBatch_.emplace_back();
+
+    computeModifier(elId, element, ar, modBatch_.back(), localBatch_.back());
+  }
+
+  size_t count = dirtyIds_.size();
+  const glm::mat4 global = global_;
+
+  // The product is written over the modifier batch
+  for (size_t i = 0; i < count; ++i)
+    modBatch_[i] = global * modBatch_[i] * localBatch_[i];
+
+  for (size_t i = 0; i < count; ++i)
+    storeFinal(peekElement(dirtyIds_[i]), modBatch_[i], ar);
+
+  Engine::EngineCounters::Add("Matrices rebuilt", static_cast<double>(count));
+}
+
+/**
+* \brief  Caches a rebuilt final matrix along with the screen bounds of the
+*         element's mesh. The screen never moves in NDC, so an element can only
+*         enter or leave it when its final matrix is rebuilt.
+*
+* \param  element The element
+* \param  final   The final matrix
+* \param  ar      The aspect ratio it was built with
+*/
+void DrawGroup::storeFinal(const DrawElement & element, const glm::mat4 & final, float ar)
+{
+  element.final_ = final;
+  element.finalAr_ = ar;
+  element.finalEpoch_ = epoch_;
+  element.finalStamp_ = ++matrixStamp;
+  element.finalValid_ = true;
+
+  if (element.mesh == nullptr || element.mesh->verts.empty())
+  {
+    element.onScreen_ = false;
+    return;
+  }
+
+  glm::vec2 min{ std::numeric_limits<float>::max() };
+  glm::vec2 max{ -std::numeric_limits<float>::max() };
+
+  for (auto & vert : element.mesh->verts)
+  {
+    glm::vec4 point = final * glm::vec4(vert.point.x, vert.point.y, 0, 1);
+
+    min = glm::min(min, glm::vec2(point.x, point.y));
+    max = glm::max(max, glm::vec2(point.x, point.y));
+  }
+
+  element.boundsMin_ = min;
+  element.boundsMax_ = max;
+  element.onScreen_ = (max.x >= -1 && min.x <= 1 && max.y >= -1 && min.y <= 1);
+}
+
+/**
+* \brief  Rebuilds the group's static batches. Runs of consecutive elements in
+*         draw order sharing a mesh and surface become one batch each, split
+*         every BAKE_CHUNK_SIZE elements.
+*
+* \param  ar  The aspect ratio
+*/
+void DrawGroup::bake(float ar)
+{
+  chunks_.clear();
+  chunkIds_.clear();
+  bakedSlots_.clear();
+  attributeDirty_.clear();
+  transformDirty_.clear();
+  bakeDirty_ = false;
+
+  glm::mat4 refMod;
+  bool hasRef = false;
+
+  std::vector<size_t> run;
+  const RMesh * runMesh = nullptr;
+  const DrawSurface * runSurface = nullptr;
+
+  auto closeRun = [&]()
+  {
+    if (run.empty())
+      return;
+
+    for (size_t i = 0; i < run.size(); ++i)
+      bakedSlots_[run[i]] = BakedSlot{ chunks_.size(), i };
+
+    chunks_.push_back(std::make_unique<StaticBatch>(runMesh, runSurface));
+    chunkIds_.push_back(std::move(run));
+    run.clear();
+  };
+
+  for (auto & elId : drawOrder_)
+  {
+    const DrawElement & element = peekElement(elId);
+
+    element.baked_ = false;
+
+    // Elements scaled against the screen change with the aspect ratio, so they
+    // aren't baked. Anything left out ends the run so batches keep draw order
+    if (element.mesh == nullptr || element.mesh->verts.empty() || element.ref != ScaleReference::XY)
+    {
+      closeRun();
+      continue;
+    }
+
+    if (element.doesNeedUpdate())
+      element.update();
+
+    glm::mat4 mod;
+    glm::mat4 local;
+
+    computeModifier(elId, element, ar, mod, local);
+
+    if (!hasRef)
+    {
+      refMod = mod;
+      bakedRef_ = elId;
+      hasRef = true;
+    }
+    else if (mod != refMod)
+    {
+      closeRun();
+      continue;
+    }
+
+    if (run.size() == BAKE_CHUNK_SIZE || element.mesh != runMesh || element.surface != runSurface)
+      closeRun();
+
+    runMesh = element.mesh;
+    runSurface = element.surface;
+    run.push_back(elId);
+    element.baked_ = true;
+  }
+
+  closeRun();
+
+  for (size_t chunk = 0; chunk < chunks_.size(); ++chunk)
+    rebuildChunk(chunk, refMod, ar);
+
+  Engine::EngineCounters::Add("Elements baked", static_cast<double>(bakedSlots_.size()));
+}
+
+/**
+* \brief  Uploads the transformations and attributes of one static batch
+*
+* \param  chunk   Index of the batch
+* \param  refMod  Modifier of the reference element
+* \param  ar      The aspect ratio
+*
+* \return False if an element no longer shares the reference element's
+*         modifier, in which case the group has to be baked again.
+*/
+bool DrawGroup::rebuildChunk(size_t chunk, const glm::mat4 & refMod, float ar)
+{
+  const std::vector<size_t> & ids = chunkIds_[chunk];
+
+  std::vector<glm::mat4> transforms;
+  std::vector<StaticAttributes> attributes;
+
+  transforms.reserve(ids.size());
+  attributes.reserve(ids.size());
+
+  glm::vec2 min{ std::numeric_limits<float>::max() };
+  glm::vec2 max{ -std::numeric_limits<float>::max() };
+
+  for (size_t id : ids)
+  {
+    const DrawElement & element = peekElement(id);
+
+    if (element.doesNeedUpdate())
+      element.update();
+
+    glm::mat4 mod;
+    glm::mat4 local;
+
+    computeModifier(id, element, ar, mod, local);
+
+    if (mod != refMod)
+      return false;
+
+    transforms.push_back(local);
+    attributes.push_back(getAttributes(element));
+
+    for (auto & vert : element.mesh->verts)
+    {
+      glm::vec4 point = local * glm::vec4(vert.point.x, vert.point.y, 0, 1);
+
+      min = glm::min(min, glm::vec2(point.x, point.y));
+      max = glm::max(max, glm::vec2(point.x, point.y));
+    }
+  }
+
+  chunks_[chunk]->boundsMin = min;
+  chunks_[chunk]->boundsMax = max;
+  chunks_[chunk]->build(transforms, attributes);
+
+  return true;
+}
+
+/**
+* \brief  Brings the static batches up to date. Only the batches of moved
+*         elements are rebuilt, unless the group has to be baked again.
+*
+* \param  ar  The aspect ratio
+*/
+void DrawGroup::updateBaked(float ar)
+{
+  if (bakeDirty_)
+    bake(ar);
+
+  if (chunks_.empty())
+    return;
+
+  const DrawElement & ref = peekElement(bakedRef_);
+
+  if (ref.doesNeedUpdate())
+    ref.update();
+
+  glm::mat4 refMod;
+  glm::mat4 refLocal;
+
+  computeModifier(bakedRef_, ref, ar, refMod, refLocal);
+
+  if (!transformDirty_.empty())
+  {
+    std::vector<bool> dirty(chunks_.size(), false);
+    size_t rebuilt = 0;
+
+    for (size_t id : transformDirty_)
+    {
+      // Every batch is drawn with the reference element's modifier
+      if (id == bakedRef_)
+      {
+        bake(ar);
+        return updateBaked(ar);
+      }
+
+      auto slot = bakedSlots_.find(id);
+
+      if (slot != bakedSlots_.end())
+        dirty[slot->second.chunk] = true;
+    }
+
+    transformDirty_.clear();
+
+    for (size_t chunk = 0; chunk < chunks_.size(); ++chunk)
+    {
+      if (!dirty[chunk])
+        continue;
+
+      if (!rebuildChunk(chunk, refMod, ar))
+      {
+        bake(ar);
+        return updateBaked(ar);
+      }
+
+      ++rebuilt;
+    }
+
+    Engine::EngineCounters::Add("Static batches rebuilt", static_cast<double>(rebuilt));
+  }
+
+  for (size_t id : attributeDirty_)
+  {
+    auto slot = bakedSlots_.find(id);
+
+    if (slot != bakedSlots_.end())
+      chunks_[slot->second.chunk]->setAttributes(slot->second.index, getAttributes(peekElement(id)));
+  }
+
+  attributeDirty_.clear();
+
+  // Every baked element shares the reference element's modifier
+  bakedGroup_ = global_ * refMod;
+}
+
+/**
+* \brief  Adds a static batch to a render queue if any of it is on screen
+*
+* \param [in,out] queue  The queue to add to
+* \param          layer  The layer this group is drawn on
+* \param          rank   Rank of the batch's first element
+* \param          chunk  Index of the batch
+*
+* \return True if the batch was added.
+*/
+bool DrawGroup::pushChunk(RenderQueue & queue, DrawLayer layer, uint32_t rank, size_t chunk) const
+{
+  const StaticBatch & batch = *chunks_[chunk];
+
+  glm::vec2 min{ std::numeric_limits<float>::max() };
+  glm::vec2 max{ -std::numeric_limits<float>::max() };
+
+  const glm::vec2 corners[4] = {
+    batch.boundsMin, batch.boundsMax,
+    glm::vec2(batch.boundsMin.x, batch.boundsMax.y),
+    glm::vec2(batch.boundsMax.x, batch.boundsMin.y)
+  };
+
+  for (auto & corner : corners)
+  {
+    glm::vec4 point = bakedGroup_ * glm::vec4(corner.x, corner.y, 0, 1);
+
+    min = glm::min(min, glm::vec2(point.x, point.y));
+    max = glm::max(max, glm::vec2(point.x, point.y));
+  }
+
+  if (max.x < -1 || min.x > 1 || max.y < -1 || min.y > 1)
+    return false;
+
+  queue.pushStatic(layer, rank, &batch, bakedGroup_);
+
+  return true;
+}
+
+/**
+* \brief  Gets the per instance values a baked element is drawn with. Hidden
+*         elements stay in their batch but are drawn fully transparent.
+*/
+StaticAttributes DrawGroup::getAttributes(const DrawElement & element) const
+{
+  return StaticAttributes{ element.visible ? element.shade : glm::vec4(0), element.frame };
+}
+
 /**   
 * \brief  Sorts the draw order for the group
 */
@@ -246,6 +870,11 @@ void DrawGroup::sort()
     while (swp > 0 && sorter_(getToken(drawOrder_[swp]), getToken(drawOrder_[swp - 1])))
     {
       std::swap(drawOrder_[swp], drawOrder_[swp - 1]);
+      orderDirty_ = true;
+
+      // Batches are runs in draw order
+      if (baked_)
+        bakeDirty_ = true;
       --swp;
     }
 
@@ -264,7 +893,13 @@ void DrawGroup::scrub()
   while (it != drawOrder_.end())
   {
     if (objects_.find(*it) == objects_.end())
+    {
+      if (bakedSlots_.count(*it))
+        bakeDirty_ = true;
+
       it = drawOrder_.erase(it);
+      orderDirty_ = true;
+    }
     else
       ++it;
   }
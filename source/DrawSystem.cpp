@@ -23,7 +23,7 @@ void loadResource(DrawSystem::RES_MAP<KEYTYPE, RESTYPE> & resMap, const KEYTYPE
 }
 
 DrawSystem::DrawSystem(SDL_Window * disp, size_t x, size_t y, size_t width, size_t height) :
-  render_(disp, x, y, width, height)
+  render_(disp, x, y, width, height), gpuPicking_{ false }
 {}
 
 const Texture * DrawSystem::getTexture(const std::string & name) const
@@ -46,8 +46,22 @@ const RMesh * DrawSystem::getMesh(const std::string & name) const
   return it->second.get();
 }
 
+const Font * DrawSystem::getFont(const std::string & name) const
+{
+  auto it = fonts_.find(name);
+
+  if (it == fonts_.end())
+    return nullptr;
+
+  return it->second.get();
+}
+
 void DrawSystem::loadMesh(const std::string & name, const RMesh & mesh)
 {
+  const RMesh * old = getMesh(name);
+
+  render_.releaseMesh(old);
+  picker_.releaseMesh(old);
   loadResource(meshes_, name, mesh);
 }
 
@@ -59,6 +73,25 @@ void DrawSystem::loadTexture(const std::string & name, const std::string & path,
   loadResource(textures_, name, path, frames);
 }
 
+/**
+* \brief  Loads a font and builds its glyph atlas. Labels already using a font
+*         with the same name keep the old one, so fonts should be loaded before
+*         any text is made.
+*/
+void DrawSystem::loadFont(const std::string & name, const std::string & path, unsigned pixelSize)
+{
+  if (name == "")
+    throw std::runtime_error("Invalid font name given");
+
+  if (getFont(name))
+  {
+    Log<RenderWarning>("Font %s is already loaded", name.c_str());
+    return;
+  }
+
+  loadResource(fonts_, name, path, pixelSize);
+}
+
 void DrawSystem::loadVertexShader(const std::string & name, const std::string & path)
 {
   loadResource(vertexShaders_, name, path, GL_VERTEX_SHADER);
@@ -135,6 +168,15 @@ size_t DrawSystem::getViewHeight() const
   return render_.getHeight();
 }
 
+/**
+* \brief  Gets the aspect ratio elements are drawn with. Final matrices should
+*         be requested with this so the cached ones can be reused
+*/
+float DrawSystem::getAspectRatio() const
+{
+  return static_cast<float>(render_.getWidth()) / render_.getHeight();
+}
+
 size_t DrawSystem::getViewOffsetX() const 
 {
   return render_.getX();
@@ -148,6 +190,7 @@ size_t DrawSystem::getViewOffsetY() const
 void DrawSystem::resize(size_t x, size_t y, size_t width, size_t height)
 {
   render_.resize(x, y, width, height);
+  picker_.resize(width, height);
 }
 
 DrawGroup & DrawSystem::getDrawGroup(DrawLayer layer)
@@ -188,12 +231,66 @@ DrawToken DrawSystem::newElement(DrawLayer layer, const std::string & mesh, cons
   return element;
 }
 
+/**
+* \brief  Loads the shaders text is drawn with. Text is skipped if they fail to
+*         load or link.
+*/
+bool DrawSystem::loadTextShaders(const std::string & vertexPath, const std::string & fragmentPath)
+{
+  loadVertexShader("TEXT_VERTEX", vertexPath);
+  loadFragmentShader("TEXT_FRAGMENT", fragmentPath);
+
+  return render_.useTextShaders(*vertexShaders_.at("TEXT_VERTEX"), *fragmentShaders_.at("TEXT_FRAGMENT"));
+}
+
+/**
+* \brief  Makes a new text label
+*
+* \param  layer  Layer the label is drawn on, after the layer's elements
+* \param  font   Name of a loaded font
+*
+* \return A token for the label
+*/
+TextToken DrawSystem::newText(DrawLayer layer, const std::string & font)
+{
+  const Font * fnt = getFont(font);
+
+  if (fnt == nullptr)
+    Log<RenderWarning>("Text made with unknown font %s", font.c_str());
+
+  auto it = text_.find(layer);
+
+  if (it == text_.end())
+    it = text_.insert(std::make_pair(layer, std::make_unique<TextBatch>())).first;
+
+  return it->second->newLabel(fnt);
+}
+
 void DrawSystem::update()
 {
+  queue_.clear();
+
   for (auto & layer : layers_)
   {
-    layer.second->draw(render_);
+    layer.second->collect(queue_, render_, layer.first);
+  }
+
+  float ar = getAspectRatio();
+
+  for (auto & text : text_)
+  {
+    auto layer = layers_.find(text.first);
+    glm::mat4 group = (layer != layers_.end()) ? layer->second->getTransformation() : glm::mat4();
+
+    text.second->layout(ar);
+    queue_.pushText(text.first, text.second.get(), group);
   }
+
+  queue_.sort();
+  queue_.submit(render_);
+
+  if (gpuPicking_)
+    picker_.render(render_);
 }
 
 void DrawSystem::swap(float r, float g, float b, float a)
@@ -201,5 +298,66 @@ void DrawSystem::swap(float r, float g, float b, float a)
   render_.swap(r, g, b, a);
 }
 
+/**
+* \brief  Loads the shaders for the id picking pass. GPU picking stays
+*         unavailable if they fail to load or link.
+*/
+bool DrawSystem::loadPickShaders(const std::string & vertexPath, const std::string & fragmentPath)
+{
+  loadVertexShader("PICK_VERTEX", vertexPath);
+  loadFragmentShader("PICK_FRAGMENT", fragmentPath);
+
+  auto lock = makeCurrent();
+
+  return picker_.init(*vertexShaders_.at("PICK_VERTEX"), *fragmentShaders_.at("PICK_FRAGMENT"),
+    render_.getWidth(), render_.getHeight());
+}
+
+/**
+* \brief  Switches click detection between the id picking pass and CPU hit testing
+*/
+void DrawSystem::setGPUPicking(bool enabled)
+{
+  if (enabled && !picker_.isReady())
+  {
+    Log<RenderWarning>("GPU picking requested but the picking pass is unavailable");
+    return;
+  }
+
+  gpuPicking_ = enabled;
+}
+
+bool DrawSystem::isGPUPicking() const
+{
+  return gpuPicking_;
+}
+
+void DrawSystem::setPickPoint(const glm::vec2 & ndc)
+{
+  picker_.setPoint(ndc);
+}
+
+void DrawSystem::queuePick(const RMesh * mesh, const glm::mat4 & mat, unsigned long id, size_t order)
+{
+  if (gpuPicking_)
+    picker_.queue(mesh, mat, static_cast<unsigned>(id), order);
+}
+
+/**
+* \brief  Gets the instance id and block face under the cursor from the last
+*         completed picking pass. An id of 0 means nothing was hit.
+*/
+bool DrawSystem::getPickResult(unsigned long & id, unsigned & face) const
+{
+  unsigned pickedId;
+
+  if (!gpuPicking_ || !picker_.getResult(pickedId, face))
+    return false;
+
+  id = pickedId;
+
+  return true;
+}
+
 
 
@@ -69,40 +69,38 @@ bool DrawToken::operator==(const DrawToken & rhs) const
 
 ScaleReference DrawToken::getScaleReference() const
 {
-  return  parent_->getElement(id_).ref;
+  return  element().ref;
 }
 
 bool DrawToken::isVisible() const
 {
-  return  parent_->getElement(id_).visible;
+  return  element().visible;
 }
 
 glm::mat4 DrawToken::getMatrix(float ar) const
 {
-  return  parent_->getElement(id_).getMatrix(ar);
+  const DrawElement & el = element();
+
+  if (el.doesNeedUpdate())
+    el.update();
+
+  return el.getMatrix(ar);
 }
 
 glm::mat4 DrawToken::getFinalMatrix(float ar) const
 {
-  MODFUNC modFunc = parent_->modifier_;
-
-  glm::mat4 mod;
-  glm::mat4 objectTrans;
-  bool ovride = false;
-
-  if (modFunc)
-  {
-    auto res = modFunc(*this);
-    mod = res.first;
-    ovride = res.second;
-  }
-
-  if (ovride)
-    objectTrans = mod;
-  else
-    objectTrans = mod * getMatrix(ar);
+  return parent_->getFinalMatrix(id_, ar);
+}
 
-  return parent_->global_ * objectTrans;
+/**
+* \brief  Gets the stamp of the final matrix. It changes every time the matrix
+*         is rebuilt, so it is only meaningful after calling getFinalMatrix
+*
+* \return The stamp.
+*/
+size_t DrawToken::getFinalStamp() const
+{
+  return element().finalStamp_;
 }
 
 /**
@@ -112,7 +110,7 @@ glm::mat4 DrawToken::getFinalMatrix(float ar) const
 */
 glm::vec4 DrawToken::getShade() const
 {
-  return parent_->getElement(id_).shade;
+  return element().shade;
 }
 
 /**
@@ -122,7 +120,7 @@ glm::vec4 DrawToken::getShade() const
 */
 glm::vec2 DrawToken::getPosition() const
 {
-  return parent_->getElement(id_).position;
+  return element().position;
 }
 
 glm::vec2 DrawToken::getFinalPosition(float ar) const
@@ -142,7 +140,7 @@ glm::vec2 DrawToken::getFinalPosition(float ar) const
 */
 glm::vec2 DrawToken::getScale() const
 {
-  return parent_->getElement(id_).scale;
+  return element().scale;
 }
 
 size_t DrawToken::getDrawOrder() const
@@ -152,12 +150,12 @@ size_t DrawToken::getDrawOrder() const
 
 unsigned DrawToken::getFrame() const
 {
-  return parent_->getElement(id_).frame;
+  return element().frame;
 }
 
 DrawLayer DrawToken::getLayer() const
 {
-  return parent_->getElement(id_).layer;
+  return element().layer;
 }
 
 /**
@@ -167,17 +165,17 @@ DrawLayer DrawToken::getLayer() const
 */
 float DrawToken::getRotation() const
 {
-  return parent_->getElement(id_).rotation;
+  return element().rotation;
 }
 
 float DrawToken::getDepth() const
 {
-  return parent_->getElement(id_).depth;
+  return element().depth;
 }
 
 float DrawToken::getIsoY() const
 {
-  return  parent_->getElement(id_).isoY;
+  return  element().isoY;
 }
 
 /**
@@ -187,7 +185,7 @@ float DrawToken::getIsoY() const
 */
 const RMesh * DrawToken::getMesh() const
 {
-  return parent_->getElement(id_).mesh;
+  return element().mesh;
 }
 
 /**
@@ -197,7 +195,7 @@ const RMesh * DrawToken::getMesh() const
 */
 const DrawSurface * DrawToken::getDrawSurface() const
 {
-  return parent_->getElement(id_).surface;
+  return element().surface;
 }
 
 /**
@@ -242,12 +240,12 @@ void DrawToken::translate(const glm::vec2 & amount)
 
 void DrawToken::setScaleReference(ScaleReference ref)
 {
-  parent_->getElement(id_).ref = ref;
+  parent_->getElementBatch(id_).ref = ref;
 }
 
 void DrawToken::setVisible(bool visible)
 {
-  parent_->getElement(id_).visible = visible;
+  parent_->getElementAttributes(id_).visible = visible;
 }
 
 /**
@@ -257,7 +255,7 @@ void DrawToken::setVisible(bool visible)
 */
 void DrawToken::setShade(const glm::vec4 & shade)
 {
-  parent_->getElement(id_).shade = shade;
+  parent_->getElementAttributes(id_).shade = shade;
 }
 
 /**
@@ -292,7 +290,7 @@ void DrawToken::setScale(float scale)
 
 void DrawToken::setFrame(unsigned frame)
 {
-  parent_->getElement(id_).frame = frame;
+  parent_->getElementAttributes(id_).frame = frame;
 }
 
 /**
@@ -317,7 +315,7 @@ void DrawToken::setDepth(float depth)
 */
 void DrawToken::setMesh(const RMesh * mesh)
 {
-  parent_->getElement(id_).mesh = mesh;
+  parent_->getElementBatch(id_).mesh = mesh;
 }
 
 /**
@@ -327,12 +325,12 @@ void DrawToken::setMesh(const RMesh * mesh)
 */
 void DrawToken::setDrawSurface(const DrawSurface * surface)
 {
-  parent_->getElement(id_).surface = surface;
+  parent_->getElementBatch(id_).surface = surface;
 }
 
 void DrawToken::setIsoY(float y) const
 {
-  parent_->getElement(id_).isoY = y;
+  element().isoY = y;
 }
 
 MODFUNC DrawToken::getModFunc() const
@@ -340,6 +338,17 @@ MODFUNC DrawToken::getModFunc() const
   return parent_->modifier_;
 }
 
+/**
+* \brief  Gets the element for reading. Unlike the setters, this doesn't flag the
+*         element's matrices for rebuilding
+*
+* \return The element.
+*/
+const DrawElement & DrawToken::element() const
+{
+  return static_cast<const DrawGroup *>(parent_)->getElement(id_);
+}
+
 /**
 * \brief  Constructor.
 *
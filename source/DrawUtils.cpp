@@ -55,17 +55,31 @@ namespace DrawUtils
     sys.newDrawGroup(RL_BACKGROUND);
     DrawGroup & tile = sys.newDrawGroup(RL_TILE);
     DrawGroup & world = sys.newDrawGroup(RL_WORLD, R_YComp);
-    sys.newDrawGroup(RL_HUD, R_DepthComp);
-    sys.newDrawGroup(RL_MENU, R_DepthComp);
+    DrawGroup & hud = sys.newDrawGroup(RL_HUD, R_DepthComp);
+    DrawGroup & menu = sys.newDrawGroup(RL_MENU, R_DepthComp);
 
     tile.setModFunc(R_IsoTransformTiles);
+    tile.setBaked(true);
     world.setModFunc(R_IsoTransformWorld);
+    hud.setKeepOrder(true);
+    menu.setKeepOrder(true);
   }
 
   void R_InitShaders(DrawSystem & sys)
   {
     sys.loadAndUseFragmentShader("BASIC_FRAGMENT", "res/fragment.fs");
     sys.loadAndUseVertexShader("BASIC_VERTEX", "res/vertex.fs");
+
+    if (!sys.loadPickShaders("res/pick_vertex.fs", "res/pick_fragment.fs"))
+      Logger::Log<RenderWarning>("Picking shaders failed to load, using CPU hit testing");
+
+    if (!sys.loadTextShaders("res/text_vertex.fs", "res/text_fragment.fs"))
+      Logger::Log<RenderWarning>("Text shaders failed to load, text will not be drawn");
+  }
+
+  void R_LoadFonts(DrawSystem & sys)
+  {
+    sys.loadFont("HUD", "fonts/FreeSansBold.ttf");
   }
 
   void R_LoadMeshes(DrawSystem & sys)
@@ -35,8 +35,7 @@ namespace DrawUtils
   template<typename T>
   void ElementMatrixRequest(const T * sub, Packet & data)
   {
-    float ar = static_cast<float>(GSM::get().getRenderer().getViewWidth()) / GSM::get().getRenderer().getViewWidth();
-    data.setData<glm::mat4>(sub->getItem().getMatrix(ar));
+    data.setData<glm::mat4>(sub->getItem().getMatrix(GSM::get().getRenderer().getAspectRatio()));
   }
 
   template<typename T>
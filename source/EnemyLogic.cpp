@@ -7,7 +7,6 @@
 #include "../include/EnemyLogic.h"
 #include "../include/object_stats.h"
 #include "../include/Physics.h"
-#include "../include/GraphicsPipeline.h"
 #include "../include/audio_startup.h"
 #include "../include/EnemyCombat.h"
 #include "../include/EnemyPathing.h"
@@ -17,22 +16,48 @@
 
 namespace Engine
 {
+  /* Velocity changes smaller than this (units per second) aren't 
+     posted. Steering toward the centre of a tile nudges the velocity a little 
+     every frame, so without it every moving enemy would post every frame. */
+  static const float PATH_POST_TOLERANCE = 1.0f;
+
+  /* Whether a new steering velocity is worth posting. An axis coming to a stop 
+     is always posted, so enemies don't creep along at a leftover speed. Only 
+     velocity gets the tolerance; acceleration ramps by exactly one per frame 
+     and is posted whenever it changes. */
+  static bool PathChanged(const glm::vec2& current, const glm::vec2& wanted)
+  {
+    if (wanted == current)
+    {
+      return false;
+    }
+
+    if ((wanted.x == 0 && current.x != 0) || (wanted.y == 0 && current.y != 0))
+    {
+      return true;
+    }
+
+    return glm::length(wanted - current) > PATH_POST_TOLERANCE;
+  }
+
   /* Constructor for EnemyLogicHandler */
-  EnemyLogicHandler::EnemyLogicHandler(Stage* stage) : ComponentHandler( stage, "EnemyLogic" )
+  EnemyLogicHandler::EnemyLogicHandler(Stage* stage) : ComponentHandler( stage, "EnemyLogic" ),
+    xmax_(0), gridRevision_(0), levelCached_(false)
   {
   }
 
   /* Updates all of the EnemyLogic components in the stage */
   void EnemyLogicHandler::update()
   {
-    for (unsigned long i = 0; i < componentList_.size(); ++i)
+    if (componentList_.empty())
     {
-      if (componentList_[i]->getComponentType() == "EnemyLogic")
-      {
-        EnemyLogic * Enemy = dynamic_cast<EnemyLogic *>(componentList_[i]);
-        Pathing( *Enemy );
-      }
+      return;
     }
+
+    UpdateLevelConstants();
+    GatherPathing();
+    RunPathing();
+    ApplyPathing();
   }
 
   /*
@@ -73,93 +98,167 @@ namespace Engine
     objMessenger.SetupRequest("EnemyPathingFlag", pathingflagRequest);
   }
 
-  /* Changes the flags present in EnemyLogic Pathing flag. */
-  void EnemyLogicHandler::Pathing(EnemyLogic& Enemy)
+  /* Recomputes where enemies finish, only when the grid has been resized or redrawn. */
+  void EnemyLogicHandler::UpdateLevelConstants()
   {
-    GameInstance& parent = Enemy.getParent();
-
-    // Current movement information
-    glm::vec2 velocity = parent.RequestData<glm::vec2>("Velocity");
-    glm::vec2 acceleration = parent.RequestData<glm::vec2>("Acceleration");
-    movement data(velocity, acceleration);
-
-    unsigned EnemyPathingFlag = Enemy.GetEnemyPathingFlag();
-    //EnemyPathingFlag = 1;
+    Grid& grid = getStage()->GetGrid();
 
-    //*****************************************//
-    /* If there is no pathing, stop everything.*/
-    if ( EnemyPathingFlag & ENEMYPATHINGNULL )
+    if (levelCached_ && gridRevision_ == grid.GetLayoutRevision())
     {
-      // Set velocity to zero.
-      velocity.x = 0;
-      velocity.y = 0;
-      acceleration.x = 0;
-      acceleration.y = 0;
-      data.first = velocity;
-      data.second = acceleration;
-      parent.PostMessage("SetVelocity", Message<glm::vec2>(data.first));
-      parent.PostMessage("SetAcceleration", Message<glm::vec2>(data.second));
       return;
     }
-    //*****************************************//
-    // Has the enemy reached the other side ?
-    //*****************************************//
-    glm::vec2 pos = parent.RequestData<glm::vec2>("Position");
-    Grid& grid = getStage()->GetGrid();
+
     float scale = getStage()->getInstanceFromID(grid[0][0]).RequestData<glm::vec2>("TileScale").x / 2;
     // xmax = grid width * x scale of tiles
-    int xmax = (grid.GetGridWidth() + grid.GetRowOffset()) * scale;
-   
-    if ( pos.x >= xmax )
-    {
-      /* Hurt the player! */
-      GameInstance * pc = Enemy.getParent().getStage()->getMessenger().Request<GameInstance *>("PlayerController");
-      pc->PostMessage("PlayerTakeDamage", Message<int>(1));
-      Audio_Engine* AEngine = GetAudioEngine();
-      AEngine->PlaySounds("player_hurt.wav", Vector3(), -15.0f);
-      Enemy.Die();
-    }
+    xmax_ = static_cast<float>(static_cast<int>((grid.GetGridWidth() + grid.GetRowOffset()) * scale));
+
+    gridRevision_ = grid.GetLayoutRevision();
+    levelCached_ = true;
+  }
+
+  /* Copies every enemy's pathing state into the pathing arrays. */
+  void EnemyLogicHandler::GatherPathing()
+  {
+    size_t count = componentList_.size();
 
-    //*****************************************//
-    /* Prioritize BUMP over all else. */
-    if (EnemyPathingFlag & ENEMYPATHINGBUMP )
+    pathEnemies_.resize(count);
+    pathPhysics_.resize(count);
+    pathFlags_.resize(count);
+    pathPositions_.resize(count);
+    pathMovement_.resize(count);
+    pathReachedEnd_.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
     {
-      data = PathBump( data );
-      if (data.first.x == 0 && data.second.x == 0)
+      EnemyLogic * enemy = static_cast<EnemyLogic *>(componentList_[i]);
+      Physics * physics = enemy->GetPhysics();
+      Transform * transform = enemy->GetTransform();
+
+      pathEnemies_[i] = enemy;
+      pathPhysics_[i] = physics;
+      pathFlags_[i] = enemy->GetEnemyPathingFlag();
+
+      /* Enemies that can't move are treated as having no pathing */
+      if (!physics || !transform)
       {
-        Enemy.SetEnemyPathingFlag(EnemyPathingFlag & ~ENEMYPATHINGBUMP);
+        pathFlags_[i] |= ENEMYPATHINGNULL;
+        continue;
       }
 
+      pathPositions_[i] = transform->getPos();
+      pathMovement_[i] = movement(physics->getVelocity(), physics->getAcceleration());
     }
-    else
+  }
+
+  /* Runs the Path* functions over every enemy. Only touches the pathing arrays. */
+  void EnemyLogicHandler::RunPathing()
+  {
+    const Grid& grid = getStage()->GetGrid();
+    size_t count = pathFlags_.size();
+
+    for (size_t i = 0; i < count; ++i)
     {
-      if (EnemyPathingFlag & ENEMYPATHINGSWITCH)
+      unsigned flags = pathFlags_[i];
+      movement data = pathMovement_[i];
+
+      //*****************************************//
+      /* If there is no pathing, stop everything.*/
+      if (flags & ENEMYPATHINGNULL)
       {
-        data = PathSwitchLane(data);
+        pathMovement_[i] = movement(glm::vec2(0), glm::vec2(0));
+        pathReachedEnd_[i] = false;
+        continue;
+      }
+
+      // Has the enemy reached the other side ?
+      pathReachedEnd_[i] = pathPositions_[i].x >= xmax_;
 
-        /* Removes the switch flag upon completing the switch */
-        if (data.first.y == 0 && data.second.y == 0)
+      //*****************************************//
+      /* Prioritize BUMP over all else. */
+      if (flags & ENEMYPATHINGBUMP)
+      {
+        data = PathBump(data);
+        if (data.first.x == 0 && data.second.x == 0)
         {
-          Enemy.SetEnemyPathingFlag(EnemyPathingFlag & ~ENEMYPATHINGSWITCH);
+          flags &= ~ENEMYPATHINGBUMP;
         }
       }
+      else
+      {
+        // Follow the grid's flow field around any blocks in the way
+        glm::vec2 forward = grid.SampleFlow(pathPositions_[i]);
 
-      if (EnemyPathingFlag & ENEMYPATHINGFAST)
+        if (flags & ENEMYPATHINGSWITCH)
+        {
+          data = PathSwitchLane(data);
+
+          /* Removes the switch flag upon completing the switch */
+          if (data.first.y == 0 && data.second.y == 0)
+          {
+            flags &= ~ENEMYPATHINGSWITCH;
+          }
+        }
+
+        if (flags & ENEMYPATHINGFAST)
+        {
+          data = PathFast(data, forward);
+        }
+        if (flags & ENEMYPATHINGACCEL)
+        {
+          data = PathAccel(data, forward);
+        }
+        if (flags & ENEMYPATHINGNORMAL)
+        {
+          data = PathNormal(data, forward);
+        }
+      }
+
+      pathFlags_[i] = flags;
+      pathMovement_[i] = data;
+    }
+  }
+
+  /* Writes the results back, only messaging enemies whose state changed. */
+  void EnemyLogicHandler::ApplyPathing()
+  {
+    size_t count = pathEnemies_.size();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      EnemyLogic & enemy = *pathEnemies_[i];
+      Physics * physics = pathPhysics_[i];
+      const movement & data = pathMovement_[i];
+
+      if (!physics)
       {
-        data = PathFast(data);
+        continue;
       }
-      if (EnemyPathingFlag & ENEMYPATHINGACCEL)
+
+      if (pathFlags_[i] != enemy.GetEnemyPathingFlag())
       {
-        data = PathAccel(data);
+        enemy.SetEnemyPathingFlag(pathFlags_[i]);
       }
-      if (EnemyPathingFlag & ENEMYPATHINGNORMAL)
+
+      if (PathChanged(physics->getVelocity(), data.first))
       {
-        data = PathNormal(data);
+        enemy.getParent().PostMessage("SetVelocity", Message<glm::vec2>(data.first));
+      }
+      if (physics->getAcceleration() != data.second)
+      {
+        enemy.getParent().PostMessage("SetAcceleration", Message<glm::vec2>(data.second));
       }
-    }
 
-    parent.PostMessage("SetVelocity", Message<glm::vec2>(data.first));
-    parent.PostMessage("SetAcceleration", Message<glm::vec2>(data.second));
+      if (pathReachedEnd_[i])
+      {
+        /* Hurt the player! */
+        GameInstance * pc = enemy.getParent().getStage()->getMessenger().Request<GameInstance *>("PlayerController");
+        pc->PostMessage("PlayerTakeDamage", Message<int>(1));
+        Audio_Engine* AEngine = GetAudioEngine();
+        static const SoundHandle hurtSound = AEngine->GetSoundHandle("player_hurt.wav");
+        AEngine->PlaySounds(hurtSound, Vector3(), -15.0f);
+        enemy.Die();
+      }
+    }
   }
 
 /***********************************************************************************/
@@ -189,13 +288,13 @@ namespace Engine
 /***********************************************************************************/
 /***********************************************************************************/
   EnemyLogic::EnemyLogic( GameInstance* owner ) :
-              Component( owner, "EnemyLogic")
+              Component( owner, "EnemyLogic"), physics_(nullptr), transform_(nullptr)
   {
   }
 
   /* Used with .json serialization */
   EnemyLogic::EnemyLogic(GameInstance * owner, const ParsedObject & obj) :
-              Component( owner, "EnemyLogic")
+              Component( owner, "EnemyLogic"), physics_(nullptr), transform_(nullptr)
   {
     EnemyAttackFlag = obj.getComponentProperty<unsigned>("EnemyLogic", "EnemyAttackFlag");
     EnemyHealthFlag = obj.getComponentProperty<unsigned>("EnemyLogic", "EnemyHealthFlag");
@@ -244,7 +343,8 @@ namespace Engine
         int dmg = objother->GetDamage();
         OurHp -= dmg;
         Audio_Engine* AEngine = GetAudioEngine();
-        AEngine->PlaySounds("attack.wav", Vector3(), -10.0f);
+        static const SoundHandle attackSound = AEngine->GetSoundHandle("attack.wav");
+        AEngine->PlaySounds(attackSound, Vector3(), -10.0f);
         getParent().PostMessage("HpSet", Message<int>(OurHp));
       }
 
@@ -351,6 +451,22 @@ namespace Engine
     return EnemyPathingFlag;
   }
 
+  Physics * EnemyLogic::GetPhysics()
+  {
+    if (!physics_)
+      physics_ = dynamic_cast<Physics *>(getParent().getComponent("Physics"));
+
+    return physics_;
+  }
+
+  Transform * EnemyLogic::GetTransform()
+  {
+    if (!transform_)
+      transform_ = dynamic_cast<Transform *>(getParent().getComponent("Transform"));
+
+    return transform_;
+  }
+
 /*******************************************************************************************/
   // Setters for data in the class.
 /*******************************************************************************************/
@@ -441,17 +557,20 @@ namespace Engine
     DrawToken wowlookatthatgraphic = enemy.RequestData<DrawToken>("Graphic");
     if ( enemydata[3] == ENEMYPATHINGNORMAL )
     {
-      GetAudioEngine()->PlaySounds("EnemySpawn.wav", Vector3(), 0.5f);
+      static const SoundHandle spawnSound = GetAudioEngine()->GetSoundHandle("EnemySpawn.wav");
+      GetAudioEngine()->PlaySounds(spawnSound, Vector3(), 0.5f);
     }
     if ( enemydata[3] == ENEMYPATHINGFAST)
     {
       wowlookatthatgraphic.setShade( glm::vec4(0.2f, 0.9f, 0.9f, 1) );
-      GetAudioEngine()->PlaySounds("EnemySpawn2.wav", Vector3(), -3.0f);
+      static const SoundHandle spawnSound2 = GetAudioEngine()->GetSoundHandle("EnemySpawn2.wav");
+      GetAudioEngine()->PlaySounds(spawnSound2, Vector3(), -3.0f);
     }
     if ( enemydata[3] == ENEMYPATHINGACCEL)
     {
       wowlookatthatgraphic.setShade(glm::vec4{ 0.85f, 0.2f, 0.2f, 1});
-      GetAudioEngine()->PlaySounds("EnemySpawn3.wav", Vector3(), -10.0f);
+      static const SoundHandle spawnSound3 = GetAudioEngine()->GetSoundHandle("EnemySpawn3.wav");
+      GetAudioEngine()->PlaySounds(spawnSound3, Vector3(), -10.0f);
     }
 
     glm::vec2 mov;
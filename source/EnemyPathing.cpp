@@ -8,24 +8,30 @@
 
 namespace Engine
 {
-  /* Only ensures the object is moving in the X direction,
-     and eliminates any acceleration in that direction.
+  /* Gets how fast the object is going along its path, 0 if it's going backwards. 
+     Turning keeps the speed, so it doesn't bleed off on corners. */
+  static float PathSpeed(const glm::vec2& velocity, const glm::vec2& forward)
+  {
+    if (glm::dot(velocity, forward) <= 0)
+    {
+      return 0;
+    }
+    return glm::length(velocity);
+  }
+
+  /* Only ensures the object is moving along its path,
+     and eliminates any acceleration.
   */
-  movement PathNormal(const movement& data)
+  movement PathNormal(const movement& data, const glm::vec2& forward)
   {
-    glm::vec2 velocity = data.first;
-    glm::vec2 acceleration = data.second;
+    float speed = PathSpeed(data.first, forward);
     /* Makes sure the object is going forwards */
-    if (velocity.x <= 0)
+    if (speed <= 0)
     {
-      velocity.x = 50;
+      speed = 50;
     }
     /* Makes sure there is no acceleration */
-    if (acceleration.x != 0)
-    {
-      acceleration.x = 0;
-    }
-    return movement(velocity, acceleration);
+    return movement(forward * speed, glm::vec2(0));
   }
 
   /* Changes lane in +Y direction. "Magic number" implementation. */
@@ -50,32 +56,27 @@ namespace Engine
   }
 
   /* Moves more quickly than normal. */
-  movement PathFast(const movement& data)
+  movement PathFast(const movement& data, const glm::vec2& forward)
   {
-    glm::vec2 velocity = data.first;
-    glm::vec2 acceleration = data.second;
+    float speed = PathSpeed(data.first, forward);
     /* Makes sure the object is going forwards */
-    if (velocity.x <= 0)
+    if (speed <= 0)
     {
-      velocity.x = 100;
+      speed = 100;
     }
     /* Makes sure there is no acceleration */
-    if (acceleration.x != 0)
-    {
-      acceleration.x = 0;
-    }
-    return movement(velocity, acceleration);
+    return movement(forward * speed, glm::vec2(0));
   }
 
-  movement PathAccel(const movement& data)
+  movement PathAccel(const movement& data, const glm::vec2& forward)
   {
-    glm::vec2 velocity = data.first;
-    glm::vec2 acceleration = data.second;
+    float speed = PathSpeed(data.first, forward);
+    float accel = PathSpeed(data.second, forward);
     /* Makes sure there is constant acceleration */
     
-    acceleration.x = 1 + acceleration.x;
+    accel = 1 + accel;
     
-    return movement(velocity, acceleration);
+    return movement(forward * speed, forward * accel);
   }
 
   /* Changes lane in +Y direction. "Magic number" implementation. */
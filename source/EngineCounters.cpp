@@ -0,0 +1,90 @@
+// Primary Author : agent
+//
+// © Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright © Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include "../include/EngineCounters.h"
+
+namespace Engine
+{
+  EngineCounters & EngineCounters::get()
+  {
+    static EngineCounters counters;
+
+    return counters;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Zeroes all counters. Called once at the start of every frame. Counters
+      are kept in the list so they don't flicker out of the debug panel
+  */
+  /****************************************************************************/
+  void EngineCounters::NewFrame()
+  {
+    for (auto & counter : get().counters_)
+      counter.second = 0;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Adds onto a counter for this frame
+
+    \param name
+      Name of the counter
+
+    \param value
+      Amount to add
+  */
+  /****************************************************************************/
+  void EngineCounters::Add(const std::string & name, double value)
+  {
+    get().counters_[name] += value;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Overwrites the value of a counter for this frame
+
+    \param name
+      Name of the counter
+
+    \param value
+      New value of the counter
+  */
+  /****************************************************************************/
+  void EngineCounters::Set(const std::string & name, double value)
+  {
+    get().counters_[name] = value;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Gets the current value of a counter
+
+    \param name
+      Name of the counter
+
+    \return
+      Value of the counter, 0 if nothing has reported it
+  */
+  /****************************************************************************/
+  double EngineCounters::Get(const std::string & name)
+  {
+    auto found = get().counters_.find(name);
+
+    if (found == get().counters_.end())
+      return 0;
+
+    return found->second;
+  }
+
+  const std::map<std::string, double> & EngineCounters::GetAll()
+  {
+    return get().counters_;
+  }
+}
@@ -0,0 +1,343 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include <algorithm>
+#include <functional>
+#include "../include/FlowField.h"
+
+namespace Engine
+{
+  // Checked in this order, so ties keep enemies walking straight ahead
+  static const int dx[] = { 1, 0, 0, -1 };
+  static const int dy[] = { 0, 1, -1, 0 };
+
+  const int FlowField::UNREACHABLE;
+  const unsigned char FlowField::NO_DIRECTION;
+
+  FlowField::FlowField() : width_(0), height_(0), cycles_(0), updateId_(0)
+  {}
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Recomputes the whole field
+
+    \param width
+      Width of the grid in tiles
+
+    \param height
+      Height of the grid in tiles
+
+    \param heights
+      Blocks on each tile, row major. Tiles with any blocks are impassable
+  */
+  /****************************************************************************/
+  void FlowField::Rebuild(int width, int height, const std::vector<int> & heights)
+  {
+    width_ = width;
+    height_ = height;
+
+    int cells = width * height;
+
+    distance_.assign(cells, UNREACHABLE);
+    direction_.assign(cells, NO_DIRECTION);
+    blocked_.assign(cells, false);
+    touchedMark_.assign(cells, 0);
+    touched_.clear();
+
+    ++updateId_;
+    cycles_ = 0;
+
+    std::vector<QueueEntry> queue;
+
+    for (int cell = 0; cell < cells; ++cell)
+    {
+      blocked_[cell] = heights[cell] > 0;
+
+      if (!blocked_[cell] && IsGoal(cell))
+      {
+        distance_[cell] = 0;
+        queue.push_back(QueueEntry(0, cell));
+      }
+    }
+
+    Propagate(queue);
+
+    for (int cell = 0; cell < cells; ++cell)
+      UpdateDirection(cell);
+
+    touched_.clear();
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Blocks or clears a tile. Blocking only reroutes the tiles whose path
+      went through it, and clearing only spreads outward as far as paths get
+      shorter
+
+    \param x
+      The x position of the tile
+
+    \param y
+      The y position of the tile
+
+    \param blocked
+      Whether the tile can be walked through
+  */
+  /****************************************************************************/
+  void FlowField::SetBlocked(int x, int y, bool blocked)
+  {
+    if (x < 0 || x >= width_ || y < 0 || y >= height_)
+      return;
+
+    int cell = CellIndex(x, y);
+
+    if (blocked_[cell] == blocked)
+      return;
+
+    blocked_[cell] = blocked;
+
+    ++updateId_;
+    cycles_ = 0;
+    touched_.clear();
+
+    std::vector<QueueEntry> queue;
+
+    if (blocked)
+    {
+      // Find every tile whose route stepped through the blocked tile
+      std::vector<int> stack(1, cell);
+      std::vector<int> lost;
+
+      Touch(cell);
+
+      while (!stack.empty())
+      {
+        int current = stack.back();
+        stack.pop_back();
+        lost.push_back(current);
+
+        for (int i = 0; i < 4; ++i)
+        {
+          int next = Neighbor(current, i);
+
+          if (next < 0 || touchedMark_[next] == updateId_ || blocked_[next])
+            continue;
+
+          if (Neighbor(next, direction_[next]) == current)
+          {
+            Touch(next);
+            stack.push_back(next);
+          }
+        }
+      }
+
+      for (int lostCell : lost)
+        distance_[lostCell] = UNREACHABLE;
+
+      // Reroute them from the tiles around them that kept their routes
+      for (int lostCell : lost)
+      {
+        if (blocked_[lostCell])
+          continue;
+
+        int best = UNREACHABLE;
+
+        for (int i = 0; i < 4; ++i)
+        {
+          int next = Neighbor(lostCell, i);
+
+          if (next >= 0 && !blocked_[next] && distance_[next] != UNREACHABLE)
+            best = std::min(best, distance_[next] + 1);
+        }
+
+        if (best != UNREACHABLE)
+        {
+          distance_[lostCell] = best;
+          queue.push_back(QueueEntry(best, lostCell));
+        }
+      }
+    }
+    else
+    {
+      Touch(cell);
+
+      int best = IsGoal(cell) ? 0 : UNREACHABLE;
+
+      for (int i = 0; i < 4 && best != 0; ++i)
+      {
+        int next = Neighbor(cell, i);
+
+        if (next >= 0 && !blocked_[next] && distance_[next] != UNREACHABLE)
+          best = std::min(best, distance_[next] + 1);
+      }
+
+      if (best != UNREACHABLE)
+      {
+        distance_[cell] = best;
+        queue.push_back(QueueEntry(best, cell));
+      }
+    }
+
+    Propagate(queue);
+    UpdateTouchedDirections();
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Gets the step to take from a tile
+
+    \return
+      Offset to the next tile. Blocked tiles, tiles with no way out and tiles
+      outside the field step straight ahead
+  */
+  /****************************************************************************/
+  glm::ivec2 FlowField::GetDirection(int x, int y) const
+  {
+    if (x < 0 || x >= width_ || y < 0 || y >= height_)
+      return glm::ivec2(1, 0);
+
+    unsigned char direction = direction_[CellIndex(x, y)];
+
+    if (direction == NO_DIRECTION)
+      return glm::ivec2(1, 0);
+
+    return glm::ivec2(dx[direction], dy[direction]);
+  }
+
+  int FlowField::GetDistance(int x, int y) const
+  {
+    if (x < 0 || x >= width_ || y < 0 || y >= height_)
+      return UNREACHABLE;
+
+    return distance_[CellIndex(x, y)];
+  }
+
+  bool FlowField::IsBlocked(int x, int y) const
+  {
+    if (x < 0 || x >= width_ || y < 0 || y >= height_)
+      return true;
+
+    return blocked_[CellIndex(x, y)];
+  }
+
+  // Gets the index of the tile next to a cell, -1 if it's off the grid
+  int FlowField::Neighbor(int cell, int direction) const
+  {
+    if (direction >= 4)
+      return -1;
+
+    int x = cell % width_ + dx[direction];
+    int y = cell / width_ + dy[direction];
+
+    if (x < 0 || x >= width_ || y < 0 || y >= height_)
+      return -1;
+
+    return CellIndex(x, y);
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Spreads distances out from the queued tiles, lowering every open tile
+      that can be reached in fewer steps. Each queued tile must already have
+      its distance set to the queued value
+  */
+  /****************************************************************************/
+  void FlowField::Propagate(std::vector<QueueEntry> & queue)
+  {
+    std::greater<QueueEntry> order;
+
+    std::make_heap(queue.begin(), queue.end(), order);
+
+    while (!queue.empty())
+    {
+      std::pop_heap(queue.begin(), queue.end(), order);
+      QueueEntry entry = queue.back();
+      queue.pop_back();
+
+      int cell = entry.second;
+
+      // Already reached through a shorter route
+      if (entry.first != distance_[cell])
+        continue;
+
+      Touch(cell);
+
+      for (int i = 0; i < 4; ++i)
+      {
+        int next = Neighbor(cell, i);
+
+        if (next < 0 || blocked_[next] || distance_[next] <= entry.first + 1)
+          continue;
+
+        distance_[next] = entry.first + 1;
+        queue.push_back(QueueEntry(distance_[next], next));
+        std::push_heap(queue.begin(), queue.end(), order);
+      }
+    }
+  }
+
+  void FlowField::Touch(int cell)
+  {
+    ++cycles_;
+
+    if (touchedMark_[cell] == updateId_)
+      return;
+
+    touchedMark_[cell] = updateId_;
+    touched_.push_back(cell);
+  }
+
+  // Points a tile at its neighbor closest to the edge
+  void FlowField::UpdateDirection(int cell)
+  {
+    direction_[cell] = NO_DIRECTION;
+
+    if (blocked_[cell] || distance_[cell] == UNREACHABLE)
+      return;
+
+    // Tiles on the edge walk off of it
+    if (distance_[cell] == 0)
+    {
+      direction_[cell] = 0;
+      return;
+    }
+
+    int best = distance_[cell];
+
+    for (int i = 0; i < 4; ++i)
+    {
+      int next = Neighbor(cell, i);
+
+      if (next >= 0 && !blocked_[next] && distance_[next] < best)
+      {
+        best = distance_[next];
+        direction_[cell] = static_cast<unsigned char>(i);
+      }
+    }
+  }
+
+  // Touched tiles can change which way their neighbors should step
+  void FlowField::UpdateTouchedDirections()
+  {
+    for (int cell : touched_)
+    {
+      UpdateDirection(cell);
+
+      for (int i = 0; i < 4; ++i)
+      {
+        int next = Neighbor(cell, i);
+
+        if (next >= 0)
+          UpdateDirection(next);
+      }
+    }
+
+    touched_.clear();
+  }
+}
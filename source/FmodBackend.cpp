@@ -0,0 +1,460 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+
+#include "../include/FmodBackend.h"
+
+#ifdef AUDIO_FMOD
+#include "../include/Logger.h"
+#include "../include/MemoryTracker.h"
+
+using std::string;
+using namespace Logger;
+
+// FMOD's own heap, counted as audio memory.
+static void* F_CALLBACK FmodAlloc( unsigned int size, FMOD_MEMORY_TYPE, const char* )
+{
+  return Engine::MemoryTracker::Allocate( size, Engine::MemoryTag::Audio );
+}
+
+static void* F_CALLBACK FmodRealloc( void* ptr, unsigned int size, FMOD_MEMORY_TYPE, const char* )
+{
+  return Engine::MemoryTracker::Reallocate( ptr, size, Engine::MemoryTag::Audio );
+}
+
+static void F_CALLBACK FmodFree( void* ptr, FMOD_MEMORY_TYPE, const char* )
+{
+  Engine::MemoryTracker::Free( ptr );
+}
+
+FmodBackend::FmodBackend() : mpStudioSystem(NULL), mpSystem(NULL)
+{
+  for ( int i = 0; i < AUDIO_MAX_VOICES; ++i )
+  {
+    mChannels[i] = NULL;
+  }
+}
+
+/*! \brief
+ * Cleans up the information being used/stored and shuts down FMOD.
+ */
+FmodBackend::~FmodBackend()
+{
+  if ( mpStudioSystem )
+  {
+    ErrorCheck( mpStudioSystem->unloadAll() );
+    ErrorCheck( mpStudioSystem->release() );
+  }
+}
+
+/*! \brief
+ * Creates and initializes the FMOD Studio system.
+ * \return
+ * False if FMOD couldn't start.
+ */
+bool FmodBackend::Init()
+{
+  // Has to happen before FMOD allocates anything, and only once.
+  static bool bMemoryHooked = false;
+  if ( !bMemoryHooked )
+  {
+    ErrorCheck( FMOD::Memory_Initialize( NULL, 0, FmodAlloc, FmodRealloc, FmodFree ) );
+    bMemoryHooked = true;
+  }
+
+  if ( ErrorCheck( FMOD::Studio::System::create( &mpStudioSystem ) ) )
+  {
+    mpStudioSystem = NULL;
+    return false;
+  }
+  if ( ErrorCheck( mpStudioSystem->initialize( 200, FMOD_STUDIO_INIT_LIVEUPDATE, FMOD_INIT_PROFILE_ENABLE, NULL ) ) ||
+       ErrorCheck( mpStudioSystem->getLowLevelSystem( &mpSystem ) ) )
+  {
+    ErrorCheck( mpStudioSystem->release() );
+    mpStudioSystem = NULL;
+    return false;
+  }
+  return true;
+}
+
+/*! \brief
+ * Lets FMOD do its work. Channels that end during this report themselves
+ * through EndOfSound.
+ */
+void FmodBackend::Update()
+{
+  ErrorCheck( mpStudioSystem->update() );
+}
+
+/*! \brief
+ * Starts opening a sound on FMOD's loading thread.
+ * \param hSound
+ * Handle the sound will be known by.
+ * \param strPath
+ * File to open.
+ * \param b3d
+ * Loads a sound with 3D position properties. (Channel setPan won't work here)
+ * \param bLooping
+ * Loads the sounds as a loop.
+ * \param bStream
+ * Open sound file/URL so it decompresses/reads at runtime.
+ */
+void FmodBackend::OpenSound( SoundHandle hSound, const string& strPath, bool b3d, bool bLooping, bool bStream )
+{
+  FMOD_MODE eMode = FMOD_DEFAULT | FMOD_NONBLOCKING;
+  eMode |= bLooping ? FMOD_LOOP_NORMAL : FMOD_DEFAULT;
+  eMode |= b3d ? FMOD_3D : FMOD_2D;
+  eMode |= bStream ? FMOD_CREATESTREAM : FMOD_CREATECOMPRESSEDSAMPLE;
+
+  if ( hSound >= static_cast<SoundHandle>( mSounds.size() ) )
+  {
+    mSounds.resize( hSound + 1, NULL );
+  }
+
+  FMOD::Sound* pSound = NULL;
+  // Searches in directory for a sound and gives it the desired playmodes.
+  ErrorCheck( mpSystem->createSound( strPath.c_str(), eMode, NULL, &pSound ) );
+  mSounds[hSound] = pSound;
+  mOpening.push_back( hSound );
+}
+
+/*! \brief
+ * Unloads a sound. Voices playing it must already be stopped.
+ */
+void FmodBackend::ReleaseSound( SoundHandle hSound )
+{
+  if ( hSound < static_cast<SoundHandle>( mSounds.size() ) && mSounds[hSound] )
+  {
+    ErrorCheck( mSounds[hSound]->release() );
+    mSounds[hSound] = NULL;
+  }
+}
+
+/*! \brief
+ * Checks on the sounds still loading in the background.
+ * \param vReady
+ * Gets the sounds that can be played now.
+ * \param vFailed
+ * Gets the sounds that couldn't be opened.
+ */
+void FmodBackend::PollSounds( std::vector<SoundHandle>& vReady, std::vector<SoundHandle>& vFailed )
+{
+  size_t nKept = 0;
+  for ( size_t i = 0; i < mOpening.size(); ++i )
+  {
+    SoundHandle hSound = mOpening[i];
+    FMOD::Sound* pSound = mSounds[hSound];
+    FMOD_OPENSTATE eState = FMOD_OPENSTATE_ERROR;
+    if ( pSound )
+    {
+      pSound->getOpenState( &eState, NULL, NULL, NULL );
+    }
+
+    switch ( eState )
+    {
+    case FMOD_OPENSTATE_LOADING:
+    case FMOD_OPENSTATE_CONNECTING:
+      mOpening[nKept++] = hSound;
+      break;
+    case FMOD_OPENSTATE_ERROR:
+      ReleaseSound( hSound );
+      vFailed.push_back( hSound );
+      break;
+    default:
+      vReady.push_back( hSound );
+      break;
+    }
+  }
+  mOpening.resize( nKept );
+}
+
+/*! \brief
+ * Puts a sound into a channel and starts it.
+ * \param nVoice
+ * Slot in the voice pool the channel belongs to.
+ * \return
+ * False if FMOD couldn't play it.
+ */
+bool FmodBackend::StartVoice( int nVoice, SoundHandle hSound, float fVolumedB, int nPriority, bool bPaused, const Vector3& vPosition )
+{
+  StopVoice( nVoice );
+
+  FMOD::Sound* pSound = mSounds[hSound];
+  FMOD::Channel* pChannel = NULL;
+  // This plays the sound PAUSED.
+  if ( !pSound || ErrorCheck( mpSystem->playSound( pSound, NULL, true, &pChannel ) ) || !pChannel )
+  {
+    return false;
+  }
+
+  FMOD_MODE currMode;
+  pSound->getMode( &currMode );
+  if ( currMode & FMOD_3D )
+  {
+    FMOD_VECTOR position = VectorToFmod( vPosition );
+    ErrorCheck( pChannel->set3DAttributes( &position, NULL ) );
+  }
+  ErrorCheck( pChannel->setVolume( dbToVolume( fVolumedB ) ) );
+  ErrorCheck( pChannel->setPriority( nPriority ) );
+  pChannel->setUserData( this );
+  pChannel->setCallback( EndOfSound );
+  ErrorCheck( pChannel->setPaused( bPaused ) );
+  mChannels[nVoice] = pChannel;
+  return true;
+}
+
+/*! \brief
+ * Stops a channel without reporting it as finished.
+ */
+void FmodBackend::StopVoice( int nVoice )
+{
+  FMOD::Channel* pChannel = mChannels[nVoice];
+  if ( pChannel )
+  {
+    // Unhook the callback first so stopping it doesn't report it.
+    pChannel->setCallback( NULL );
+    pChannel->setUserData( NULL );
+    pChannel->stop();
+    mChannels[nVoice] = NULL;
+  }
+}
+
+void FmodBackend::SetVoiceVolume( int nVoice, float fVolumedB )
+{
+  if ( mChannels[nVoice] )
+  {
+    ErrorCheck( mChannels[nVoice]->setVolume( dbToVolume( fVolumedB ) ) );
+  }
+}
+
+void FmodBackend::SetVoicePaused( int nVoice, bool bPaused )
+{
+  if ( mChannels[nVoice] )
+  {
+    ErrorCheck( mChannels[nVoice]->setPaused( bPaused ) );
+  }
+}
+
+void FmodBackend::SetVoicePriority( int nVoice, int nPriority )
+{
+  if ( mChannels[nVoice] )
+  {
+    mChannels[nVoice]->setPriority( nPriority );
+  }
+}
+
+void FmodBackend::SetVoicePosition( int nVoice, const Vector3& vPosition )
+{
+  if ( mChannels[nVoice] )
+  {
+    FMOD_VECTOR position = VectorToFmod( vPosition );
+    ErrorCheck( mChannels[nVoice]->set3DAttributes( &position, NULL ) );
+  }
+}
+
+void FmodBackend::PollFinished( std::vector<int>& vVoices )
+{
+  vVoices.insert( vVoices.end(), mFinished.begin(), mFinished.end() );
+  mFinished.clear();
+}
+
+/* UNTESTED */
+void FmodBackend::SetListener( const Vector3& vPos )
+{
+  FMOD_VECTOR vFPos = VectorToFmod( vPos );
+  FMOD_VECTOR vFVel = VectorToFmod( Vector3() );
+  mpSystem->set3DListenerAttributes( 0, &vFPos, &vFVel, &vFVel, &vFVel );
+}
+
+/*! \brief
+ * Loads a bank from the map into the audio engine.
+ * \param strBankName
+ * Unique identifier for the bank.
+ * \flags
+ * Check FMOD help for info on these bank flags.
+ */
+void FmodBackend::LoadBank( const string& strBankName, unsigned flags )
+{
+  BankMap::iterator tFoundIt = mBanks.find( strBankName );
+  // Stop if the identifier string is already in use.
+  if ( tFoundIt != mBanks.end() )
+  {
+    Log<Info>("Already created bank: ", strBankName.c_str());
+    return;
+  }
+  FMOD::Studio::Bank* pBank = NULL;
+  // The part that puts it int
+  ErrorCheck( mpStudioSystem->loadBankFile( strBankName.c_str(), flags, &pBank ) );
+  if ( pBank )
+  {
+    mBanks[strBankName] = pBank;
+  }
+}
+
+/*! \brief
+ * Loads Event audio
+ * \param strEventName
+ * Unique identifier for the Event.
+ */
+void FmodBackend::LoadEvent( const string& strEventName )
+{
+  EventMap::iterator tFoundit = mEvents.find( strEventName );
+  // Stop if you found an event using the same name.
+  if ( tFoundit != mEvents.end() )
+  {
+    return;
+  }
+  FMOD::Studio::EventDescription* pEventDescription = NULL;
+  ErrorCheck( mpStudioSystem->getEvent( strEventName.c_str(), &pEventDescription ) );
+  if ( pEventDescription )
+  {
+    FMOD::Studio::EventInstance* pEventInstance = NULL;
+    ErrorCheck( pEventDescription->createInstance( &pEventInstance ) );
+    if ( pEventInstance )
+    {
+      mEvents[strEventName] = pEventInstance;
+    }
+  }
+}
+
+/*! \brief
+ * Starts playing an event.
+ * \param strEventName
+ * Specifies which event to play.
+ */
+void FmodBackend::PlayEvent( const string& strEventName )
+{
+  EventMap::iterator tFoundit = mEvents.find( strEventName );
+  // If we can't find it, try to load the event.
+  if ( tFoundit == mEvents.end() )
+  {
+    LoadEvent( strEventName );
+    tFoundit = mEvents.find( strEventName );
+    // If it can't be loaded in, stop.
+    if ( tFoundit == mEvents.end() )
+    {
+      return;
+    }
+  }
+  tFoundit->second->start();
+}
+
+/*! \brief
+ * Try to stop a playing event.
+ * \param strEventName
+ * Specifies which event to stop.
+ * \param bImmediate
+ * Allows sound to (true): stop instantly, (false): fade out.
+ */
+void FmodBackend::StopEvent( const string& strEventName, bool bImmediate )
+{
+  EventMap::iterator tFoundIt = mEvents.find( strEventName );
+  // Stop if we can't find the event.
+  if ( tFoundIt == mEvents.end() )
+  {
+    return;
+  }
+
+  // Instant or fade?
+  FMOD_STUDIO_STOP_MODE eMode = bImmediate ? FMOD_STUDIO_STOP_IMMEDIATE : FMOD_STUDIO_STOP_ALLOWFADEOUT;
+  ErrorCheck( tFoundIt->second->stop( eMode ) );
+}
+
+/*! \brief
+ * Sets the value of an Event parameter.
+ * \param strEventName
+ * Specifies the Event.
+ * \param strParameterName
+ * Specifies the parameter.
+ * \param fValue
+ * Parameter will be set to this value.
+ */
+void FmodBackend::SetEventParameter( const string& strEventName, const string& strParameterName, float fValue )
+{
+  EventMap::iterator tFoundIt = mEvents.find( strEventName );
+  // If you can't find it, stop.
+  if ( tFoundIt == mEvents.end() )
+  {
+    return;
+  }
+
+  FMOD::Studio::ParameterInstance* pParameter = NULL;
+  ErrorCheck( tFoundIt->second->getParameter( strParameterName.c_str(), &pParameter ) );
+  if ( pParameter )
+  {
+    ErrorCheck( pParameter->setValue( fValue ) );
+  }
+}
+
+/*! \brief
+ * Checks to see if FMOD encountered a problem.
+ * \param result
+ * Output from an FMOD function.
+ * \return
+ * Boolean, true is bad, false means everything is running smoothly.
+ */
+int FmodBackend::ErrorCheck( FMOD_RESULT result )
+{
+  if ( result != FMOD_OK )
+  {
+    Log<Error>("FMOD ERROR %d", result);
+    return 1;
+  }
+
+  return 0;
+}
+
+/*! \brief
+ * Called by FMOD during update. Reports channels whose sounds have ended.
+ */
+FMOD_RESULT F_CALLBACK FmodBackend::EndOfSound(FMOD_CHANNELCONTROL *chanControl,
+                                         FMOD_CHANNELCONTROL_TYPE controlType,
+                                         FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType,
+                                         void *commandData1,
+                                         void *commandData2)
+{
+  // Has the channel's sound ended?
+  if (controlType == FMOD_CHANNELCONTROL_CHANNEL && callbackType == FMOD_CHANNELCONTROL_CALLBACK_END)
+  {
+    FMOD::Channel *channel = (FMOD::Channel *)chanControl;
+    void* pUserData = NULL;
+    channel->getUserData( &pUserData );
+    FmodBackend* pBackend = static_cast<FmodBackend*>( pUserData );
+    if ( !pBackend )
+    {
+      return FMOD_OK;
+    }
+
+    // Find which voice it was.
+    for ( int i = 0; i < AUDIO_MAX_VOICES; ++i )
+    {
+      if ( pBackend->mChannels[i] == channel )
+      {
+        pBackend->mChannels[i] = NULL;
+        pBackend->mFinished.push_back( i );
+        break;
+      }
+    }
+  }
+
+  return FMOD_OK;
+}
+
+/*! \brief
+ * Converts float vector into FMOD vector.
+ * \param vPosition
+ * Input values.
+ * \return
+ * FMOD vector.
+ */
+FMOD_VECTOR VectorToFmod( const Vector3& vPosition )
+{
+  FMOD_VECTOR fVec;
+  fVec.x = vPosition.x;
+  fVec.y = vPosition.y;
+  fVec.z = vPosition.z;
+  return fVec;
+}
+#endif
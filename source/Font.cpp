@@ -0,0 +1,245 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include <GL/glew.h>
+#include <GL/GL.h>
+
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <cmath>
+
+#include "Font.h"
+
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "stb_truetype.h"
+
+using namespace Logger;
+
+static const int ATLAS_WIDTH = 512;
+
+/**
+* \brief  Builds a signed distance field from a coverage bitmap. Each pixel
+*         stores the distance to the nearest pixel on the other side of the
+*         edge, mapped so 128 lies on the edge and inside is brighter.
+*/
+static void BuildDistanceField(const std::vector<unsigned char> & coverage, int width, int height,
+                               int spread, std::vector<unsigned char> & field)
+{
+  field.resize(width * height);
+
+  auto inside = [&](int x, int y)
+  {
+    return x >= 0 && y >= 0 && x < width && y < height && coverage[y * width + x] >= 128;
+  };
+
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      bool in = inside(x, y);
+      float best = static_cast<float>(spread * spread);
+
+      for (int dy = -spread; dy <= spread; ++dy)
+      {
+        for (int dx = -spread; dx <= spread; ++dx)
+        {
+          float dist = static_cast<float>(dx * dx + dy * dy);
+
+          if (dist < best && inside(x + dx, y + dy) != in)
+            best = dist;
+        }
+      }
+
+      float signedDist = std::sqrt(best) / spread;
+
+      if (!in)
+        signedDist = -signedDist;
+
+      field[y * width + x] = static_cast<unsigned char>(std::max(0.f, std::min(255.f, 128 + signedDist * 127)));
+    }
+  }
+}
+
+/**
+* \brief  Loads a font and builds its distance field atlas
+*
+* \param  path       Path to a TrueType font
+* \param  pixelSize  Height glyphs are rasterized at before building the field
+*/
+Font::Font(const std::string & path, unsigned pixelSize) :
+  path_(path), pixelSize_(static_cast<float>(pixelSize)), ascent_(0), descent_(0),
+  atlasWidth_(ATLAS_WIDTH), atlasHeight_(0)
+{
+  Log<Info>("Loading Font : %s", path.c_str());
+
+  std::ifstream file(path, std::ios::binary);
+  std::vector<unsigned char> ttf{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+  stbtt_fontinfo info;
+
+  if (ttf.empty() || !stbtt_InitFont(&info, ttf.data(), stbtt_GetFontOffsetForIndex(ttf.data(), 0)))
+  {
+    Log<RenderError>("Failed to load font %s", path.c_str());
+    return;
+  }
+
+  float scale = stbtt_ScaleForPixelHeight(&info, pixelSize_);
+
+  int ascent, descent, lineGap;
+  stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
+
+  ascent_ = ascent * scale;
+  descent_ = descent * scale;
+
+  // Rasterize and shelf pack every glyph, padded by the spread of the field
+  struct Packed
+  {
+    std::vector<unsigned char> field;
+    int x, y, width, height;
+  };
+
+  std::vector<Packed> packed;
+  int penX = 0;
+  int penY = 0;
+  int shelfHeight = 0;
+
+  for (char c = FIRST_CHAR; c <= LAST_CHAR; ++c)
+  {
+    int advance, bearing;
+    stbtt_GetCodepointHMetrics(&info, c, &advance, &bearing);
+
+    int x0, y0, x1, y1;
+    stbtt_GetCodepointBitmapBox(&info, c, scale, scale, &x0, &y0, &x1, &y1);
+
+    int glyphW = std::max(0, x1 - x0);
+    int glyphH = std::max(0, y1 - y0);
+    int width = glyphW + 2 * SPREAD;
+    int height = glyphH + 2 * SPREAD;
+
+    std::vector<unsigned char> coverage(width * height, 0);
+
+    if (glyphW > 0 && glyphH > 0)
+      stbtt_MakeCodepointBitmap(&info, &coverage[SPREAD * width + SPREAD], glyphW, glyphH, width, scale, scale, c);
+
+    if (penX + width > atlasWidth_)
+    {
+      penX = 0;
+      penY += shelfHeight;
+      shelfHeight = 0;
+    }
+
+    Packed glyph;
+    BuildDistanceField(coverage, width, height, SPREAD, glyph.field);
+    glyph.x = penX;
+    glyph.y = penY;
+    glyph.width = width;
+    glyph.height = height;
+
+    packed.push_back(std::move(glyph));
+
+    Glyph metrics;
+    metrics.offset = glm::vec2(x0 - SPREAD, -(y0 - SPREAD));
+    metrics.size = glm::vec2(width, height);
+    metrics.advance = advance * scale;
+
+    glyphs_.push_back(metrics);
+
+    penX += width;
+    shelfHeight = std::max(shelfHeight, height);
+  }
+
+  atlasHeight_ = 1;
+
+  while (atlasHeight_ < penY + shelfHeight)
+    atlasHeight_ *= 2;
+
+  atlas_.assign(atlasWidth_ * atlasHeight_, 0);
+
+  for (size_t i = 0; i < packed.size(); ++i)
+  {
+    const Packed & glyph = packed[i];
+
+    for (int row = 0; row < glyph.height; ++row)
+      std::copy_n(&glyph.field[row * glyph.width], glyph.width, &atlas_[(glyph.y + row) * atlasWidth_ + glyph.x]);
+
+    glyphs_[i].uvMin = glm::vec2(static_cast<float>(glyph.x) / atlasWidth_, static_cast<float>(glyph.y) / atlasHeight_);
+    glyphs_[i].uvMax = glm::vec2(static_cast<float>(glyph.x + glyph.width) / atlasWidth_,
+                                 static_cast<float>(glyph.y + glyph.height) / atlasHeight_);
+  }
+}
+
+Font::~Font()
+{
+  if (texture_ != NULL)
+    glDeleteTextures(1, &texture_);
+}
+
+void Font::bind() const
+{
+  if (texture_ == NULL)
+    uploadAtlas();
+
+  glBindTexture(GL_TEXTURE_2D, texture_);
+}
+
+void Font::unbind() const
+{
+  glBindTexture(GL_TEXTURE_2D, NULL);
+}
+
+bool Font::isLoaded() const
+{
+  return !glyphs_.empty();
+}
+
+/**
+* \brief  Gets the metrics of a character, or nullptr if the font doesn't have it
+*/
+const Font::Glyph * Font::getGlyph(char c) const
+{
+  if (c < FIRST_CHAR || c > LAST_CHAR || glyphs_.empty())
+    return nullptr;
+
+  return &glyphs_[c - FIRST_CHAR];
+}
+
+float Font::getPixelSize() const
+{
+  return pixelSize_;
+}
+
+float Font::getAscent() const
+{
+  return ascent_;
+}
+
+float Font::getDescent() const
+{
+  return descent_;
+}
+
+/**
+* \brief  Sends the atlas to the GPU. The CPU copy is kept since it is small.
+*/
+void Font::uploadAtlas() const
+{
+  glActiveTexture(GL_TEXTURE0);
+
+  glGenTextures(1, &texture_);
+  glBindTexture(GL_TEXTURE_2D, texture_);
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasWidth_, atlasHeight_, 0, GL_RED, GL_UNSIGNED_BYTE, atlas_.data());
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  glBindTexture(GL_TEXTURE_2D, NULL);
+}
@@ -0,0 +1,384 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+#include "../include/FrameProfiler.h"
+
+namespace Engine
+{
+  // Twice the 60 FPS target, so single missed vsyncs don't fill the log
+  static const double DEFAULT_STUTTER_MS = 2000.0 / 60.0;
+
+  FrameHistogram::FrameHistogram()
+  {
+    Clear();
+  }
+
+  void FrameHistogram::Clear()
+  {
+    counts_.fill(0);
+    count_ = 0;
+    total_ = 0;
+    max_ = 0;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Adds a value to the histogram
+
+    \param micros
+      Duration in microseconds
+  */
+  /****************************************************************************/
+  void FrameHistogram::Record(uint64_t micros)
+  {
+    ++counts_[BucketIndex(micros)];
+    ++count_;
+    total_ += micros;
+    max_ = std::max(max_, micros);
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Gets the smallest value that the given percent of recorded values are at
+      or below
+
+    \param percent
+      Percentile to get, from 0 to 100
+
+    \return
+      The value in microseconds, 0 if nothing was recorded
+  */
+  /****************************************************************************/
+  uint64_t FrameHistogram::Percentile(double percent) const
+  {
+    if (count_ == 0)
+      return 0;
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(std::min(100.0, std::max(0.0, percent)) / 100 * count_));
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+
+    for (unsigned i = 0; i < BUCKET_COUNT; ++i)
+    {
+      seen += counts_[i];
+
+      if (seen >= target)
+        return std::min(BucketValue(i), max_);
+    }
+
+    return max_;
+  }
+
+  double FrameHistogram::Mean() const
+  {
+    return count_ ? static_cast<double>(total_) / count_ : 0;
+  }
+
+  unsigned FrameHistogram::BucketIndex(uint64_t micros)
+  {
+    unsigned shift = 0;
+
+    while ((micros >> shift) >= SUB_BUCKETS)
+      ++shift;
+
+    if (shift == 0)
+      return static_cast<unsigned>(micros);
+
+    if (shift > MAX_SHIFT)
+      shift = MAX_SHIFT;
+
+    unsigned sub = static_cast<unsigned>(std::min<uint64_t>(micros >> shift, SUB_BUCKETS - 1));
+
+    return SUB_BUCKETS + (shift - 1) * HALF_BUCKETS + (sub - HALF_BUCKETS);
+  }
+
+  // Highest value that lands in a bucket
+  uint64_t FrameHistogram::BucketValue(unsigned index)
+  {
+    if (index < SUB_BUCKETS)
+      return index;
+
+    unsigned shift = (index - SUB_BUCKETS) / HALF_BUCKETS + 1;
+    uint64_t sub = (index - SUB_BUCKETS) % HALF_BUCKETS + HALF_BUCKETS;
+
+    return ((sub + 1) << shift) - 1;
+  }
+
+  FrameProfiler::Section::Section(const char * name) :
+    name_{ name }, start_{ FrameProfiler::Now() }, running_{ true }
+  {}
+
+  FrameProfiler::Section::~Section()
+  {
+    Stop();
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Adds the time since the section started to the current frame. Does
+      nothing if the section was already stopped
+  */
+  /****************************************************************************/
+  void FrameProfiler::Section::Stop()
+  {
+    if (!running_)
+      return;
+
+    running_ = false;
+    FrameProfiler::AddSection(name_, FrameProfiler::Now() - start_);
+  }
+
+  FrameProfiler & FrameProfiler::get()
+  {
+    static FrameProfiler profiler;
+
+    return profiler;
+  }
+
+  FrameProfiler::FrameProfiler() :
+    frameCount_{ 0 }, stutterThreshold_{ static_cast<uint64_t>(DEFAULT_STUTTER_MS * 1000000) }
+  {
+    current_.frame = 0;
+    current_.total = 0;
+    current_.sections.fill(0);
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Reads the monotonic clock frames are timed with
+
+    \return
+      Nanoseconds since an arbitrary point
+  */
+  /****************************************************************************/
+  uint64_t FrameProfiler::Now()
+  {
+    using namespace std::chrono;
+
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Finishes the current frame, recording it along with every section added
+      since the last call. Called once per frame by the Display
+
+    \param frameNanos
+      How long the frame took
+  */
+  /****************************************************************************/
+  void FrameProfiler::EndFrame(uint64_t frameNanos)
+  {
+    FrameProfiler & prof = get();
+
+    prof.current_.frame = prof.frameCount_++;
+    prof.current_.total = frameNanos;
+
+    prof.lifetime_.Record(frameNanos / 1000);
+
+    prof.history_.push_back(prof.current_);
+
+    if (prof.history_.size() > HISTORY_SIZE)
+      prof.history_.pop_front();
+
+    if (frameNanos > prof.stutterThreshold_)
+    {
+      prof.stutters_.push_back(prof.current_);
+
+      if (prof.stutters_.size() > STUTTER_LOG_SIZE)
+        prof.stutters_.pop_front();
+    }
+
+    prof.current_.sections.fill(0);
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Adds time to a named section of the current frame. Sections beyond
+      MAX_SECTIONS are ignored
+
+    \param name
+      Name of the section
+
+    \param nanos
+      Time to add
+  */
+  /****************************************************************************/
+  void FrameProfiler::AddSection(const char * name, uint64_t nanos)
+  {
+    FrameProfiler & prof = get();
+
+    auto found = std::find(prof.sectionNames_.begin(), prof.sectionNames_.end(), name);
+    size_t index = found - prof.sectionNames_.begin();
+
+    if (found == prof.sectionNames_.end())
+    {
+      if (prof.sectionNames_.size() >= MAX_SECTIONS)
+        return;
+
+      prof.sectionNames_.push_back(name);
+    }
+
+    prof.current_.sections[index] += nanos;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Gets frame time statistics over the most recent frames
+
+    \param frames
+      Number of frames to look back over, capped at HISTORY_SIZE
+
+    \return
+      The statistics in milliseconds
+  */
+  /****************************************************************************/
+  FrameStats FrameProfiler::GetWindowStats(size_t frames)
+  {
+    FrameProfiler & prof = get();
+
+    frames = std::min(frames, prof.history_.size());
+
+    prof.window_.Clear();
+
+    for (auto it = prof.history_.end() - frames; it != prof.history_.end(); ++it)
+      prof.window_.Record(it->total / 1000);
+
+    return MakeStats(prof.window_);
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Gets frame time statistics over every frame since the stats were last
+      reset
+
+    \return
+      The statistics in milliseconds
+  */
+  /****************************************************************************/
+  FrameStats FrameProfiler::GetLifetimeStats()
+  {
+    return MakeStats(get().lifetime_);
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Clears the lifetime stats, frame history and stutter log
+  */
+  /****************************************************************************/
+  void FrameProfiler::ResetStats()
+  {
+    FrameProfiler & prof = get();
+
+    prof.lifetime_.Clear();
+    prof.history_.clear();
+    prof.stutters_.clear();
+  }
+
+  void FrameProfiler::SetStutterThreshold(double millis)
+  {
+    get().stutterThreshold_ = static_cast<uint64_t>(std::max(0.0, millis) * 1000000);
+  }
+
+  double FrameProfiler::GetStutterThreshold()
+  {
+    return get().stutterThreshold_ / 1000000.0;
+  }
+
+  const std::vector<std::string> & FrameProfiler::GetSectionNames()
+  {
+    return get().sectionNames_;
+  }
+
+  const std::deque<FrameProfiler::FrameSample> & FrameProfiler::GetHistory()
+  {
+    return get().history_;
+  }
+
+  const std::deque<FrameProfiler::FrameSample> & FrameProfiler::GetStutters()
+  {
+    return get().stutters_;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Writes the frame history and stutter log out as CSV, one frame per row
+      with a column for each section
+
+    \param framesPath
+      File to write the frame history to
+
+    \param stuttersPath
+      File to write the stutter log to
+
+    \return
+      True if both files were written
+  */
+  /****************************************************************************/
+  bool FrameProfiler::ExportCSV(const std::string & framesPath, const std::string & stuttersPath)
+  {
+    bool frames = WriteSamples(framesPath, get().history_);
+    bool stutters = WriteSamples(stuttersPath, get().stutters_);
+
+    return frames && stutters;
+  }
+
+  FrameStats FrameProfiler::MakeStats(const FrameHistogram & histogram)
+  {
+    return FrameStats{
+      static_cast<size_t>(histogram.Count()),
+      histogram.Mean() / 1000,
+      histogram.Percentile(50) / 1000.0,
+      histogram.Percentile(95) / 1000.0,
+      histogram.Percentile(99) / 1000.0,
+      histogram.Max() / 1000.0
+    };
+  }
+
+  bool FrameProfiler::WriteSamples(const std::string & path, const std::deque<FrameSample> & samples)
+  {
+    std::ofstream file(path);
+
+    if (!file)
+      return false;
+
+    const std::vector<std::string> & names = get().sectionNames_;
+
+    file << "frame,total_ms";
+
+    for (const std::string & name : names)
+      file << "," << name << "_ms";
+
+    file << "\n";
+
+    for (const FrameSample & sample : samples)
+    {
+      file << sample.frame << "," << sample.total / 1000000.0;
+
+      for (size_t i = 0; i < names.size(); ++i)
+        file << "," << sample.sections[i] / 1000000.0;
+
+      file << "\n";
+    }
+
+    return static_cast<bool>(file);
+  }
+}
@@ -9,6 +9,7 @@
 
 #include "../include/DrawUtils.h"
 #include "../include/Input.h"
+#include "../include/InputRecorder.h"
 #include "../include/camera.h"
 #include "../include/audio_test.h"
 //#include "../include/Texture.h"
@@ -24,6 +25,9 @@
 //#include "../include/MenuButtons.h"
 //#include "../include/Waves.h"
 #include "../include/Levels.h"
+#include "../include/EngineCounters.h"
+#include "../include/FrameProfiler.h"
+#include "../include/MemoryTracker.h"
 #include <functional>
 #include "RMesh.h"
 
@@ -42,7 +46,6 @@ namespace Engine
 
   //Display GSM_Display;
   //Shader Color_Shader;
-  //Text TestText;
 
   // Flag used to tell if the game is shutting down
   //static bool GSM_ENDING = false;
@@ -80,12 +83,16 @@ namespace Engine
   {
     using namespace DrawUtils;
 
+    MemoryTracker::Scope audioMemory{ MemoryTag::Audio };
     StartGameAudioSystem();
     Audio_Engine* AEngine = GetAudioEngine();
+    audioMemory.Stop();
 
 
     //InitializeComponentHandlers();
     disp_.Initialize(1280, 720, "Refactory");
+
+    MemoryTracker::Scope renderMemory{ MemoryTag::Render };
     renderer_ = std::make_unique<DrawSystem>(disp_.GetWindow(), 0, 0, 1280, 720);
 
     disp_.setEventHandler(&InputSystem::Update);
@@ -93,6 +100,8 @@ namespace Engine
     R_InitLayers(*renderer_);
     R_InitShaders(*renderer_);
     R_LoadMeshes(*renderer_);
+    R_LoadFonts(*renderer_);
+    renderMemory.Stop();
 
     cam_.Init();
 
@@ -100,7 +109,9 @@ namespace Engine
 
     mess_.Subscribe(mess_, "GSM_END", GSM::OnEnd);
 
+    MemoryTracker::Scope assetMemory{ MemoryTag::Assets };
     GenerateParsedObjects("Objects/Objects.json");
+    assetMemory.Stop();
 
     // Load textures
 
@@ -146,6 +157,7 @@ namespace Engine
     std::thread texLoader{ 
       [](DrawSystem * sys, LoadLock & lod) 
     {
+      MemoryTracker::Scope memory{ MemoryTag::Assets };
       R_LoadTextures(sys, "Objects/Textures.json");
       lod.done(sys->firstTexture());
     },
@@ -172,7 +184,7 @@ namespace Engine
 
         if (!lodStart && doneLoading)
         {
-          AEngine->PlaySounds("startup.wav", Vector3(), -15.0f);
+          AEngine->PlaySounds("startup.wav", Vector3(), -15.0f, 0);
           soundTimer.Reset();
           //++current;
           lodStart = true;
@@ -232,7 +244,8 @@ namespace Engine
         //renderer_->makeCurrent();
         //renderer_->resize(0, 0, disp.GetWidth(), disp.GetHeight());
 
-        //AEngine->Update();
+        // Starts sounds that finished loading in the background.
+        AEngine->Update();
         //  2.85 seconds -- done fading out
         //  2 seconds -- start fading out
 
@@ -260,6 +273,10 @@ namespace Engine
     if(testStage.isStageToggling())
       Stage::ToggleRunning(testStage);
 
+    // Credits are rebuilt every time they're opened, so get that done while
+    // they aren't showing
+    Stage::GetStage("Credits").setPreloadWhenIdle(true);
+
     loading_ = false; // done loading
   }
 
@@ -291,17 +308,21 @@ namespace Engine
 
     while (!ending_ && !disp_.IsClosed())
     {
+      EngineCounters::NewFrame();
+      MemoryTracker::NewFrame();
       InputSystem::Clean();
       disp_.Update();
+      InputRecorder::EndFrame(disp_);
+
+      FrameProfiler::Section audio{ "Audio" };
+      MemoryTracker::Scope audioMemory{ MemoryTag::Audio };
 
       if(soundflag && soundTimer.ElapsedTime() >= /*sound length*/ 12)
       {
         /* Do stuff */
         Audio_Engine* AEngine = GetAudioEngine();
         AEngine->LoadSound("menumelody_repeat.wav", false, true );
-        AEngine->PlaySounds("menumelody_repeat.wav", Vector3(), -15.0f);
-        int nChannelId = AEngine->FindSoundChannel("menumelody_repeat.wav");
-        AEngine->SetChannelPriority(nChannelId, 0);
+        AEngine->PlaySounds("menumelody_repeat.wav", Vector3(), -15.0f, 0);
         soundflag = false;
       }
   
@@ -310,9 +331,16 @@ namespace Engine
 
       Audio_Engine* AEngine = GetAudioEngine();
       AEngine->Update();
+      audioMemory.Stop();
+      audio.Stop();
+
+      FrameProfiler::Section camera{ "Camera" };
       cam_.Update();
+      camera.Stop();
 
+      FrameProfiler::Section imgui{ "ImGui" };
       UpdateImGui(disp_.GetWindow());
+      imgui.Stop();
 
       /*
 
@@ -321,12 +349,15 @@ namespace Engine
 
       */
       // Stage loop
+      FrameProfiler::Section stages{ "Stages" };
+      MemoryTracker::Scope ecsMemory{ MemoryTag::ECS };
       auto i = Stage::StageList.begin();
       while (i != Stage::StageList.end())
       {
         auto stage = i->second.begin();
         while (stage != i->second.end())
         {
+          Stage::UpdateLoading(**stage);
           (*stage)->update();
           Stage::CleanStage(**stage);
 
@@ -437,13 +468,23 @@ namespace Engine
       }
 
 
+      ecsMemory.Stop();
+      stages.Stop();
+
       // Post-stage logic
+      FrameProfiler::Section render{ "Render" };
+      MemoryTracker::Scope renderMemory{ MemoryTag::Render };
       renderer_->update();
       ImGui::Render();
+      renderMemory.Stop();
+      render.Stop();
+
+      // Includes waiting on vsync
+      FrameProfiler::Section swap{ "Swap" };
       renderer_->swap(0, 0, 0);
+      swap.Stop();
 
       //InputSystem::Update(); // I'm the one who does input around here, BUCKO! // Not today, BUSTER!!
-      //TestText.RenderText();
       // Post-stage logic
     }
   }
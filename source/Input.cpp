@@ -9,6 +9,7 @@
 #include <luabind/luabind.hpp>
 
 #include "../include/Input.h"
+#include "../include/InputRecorder.h"
 #include "../include/display.h"
 #include "../include/GSM.h"
 #include "../include/Logger.h"
@@ -73,7 +74,9 @@ namespace Engine
   {
     InputSystem & is = getMutable();
 
-
+    // Replays throw out live input, recordings keep a copy of it
+    if (InputRecorder::FilterEvent(event))
+      return true;
 
     switch (event.type)
     {
@@ -268,6 +271,10 @@ namespace Engine
   /****************************************************************************/
   bool InputSystem::KeyDown(SDL_Scancode key)
   {
+    // The keyboard state isn't recorded, only the events building it up
+    if (InputRecorder::IsRecording() || InputRecorder::IsReplaying())
+      return getMutable().keys_[key].held;
+
     const Uint8* keyboard = SDL_GetKeyboardState(NULL); // array of keyboard states (pressed or not)
     if (keyboard[key])
       return true;
@@ -289,6 +296,9 @@ namespace Engine
   /****************************************************************************/
   bool InputSystem::KeyUp(SDL_Scancode key)
   {
+    if (InputRecorder::IsRecording() || InputRecorder::IsReplaying())
+      return !getMutable().keys_[key].held;
+
     const Uint8* keyboard = SDL_GetKeyboardState(NULL); // array of keyboard states (pressed or not)
     if (!keyboard[key])
       return true;
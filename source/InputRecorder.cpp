@@ -0,0 +1,429 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+
+#include "../include/InputRecorder.h"
+#include "../include/Input.h"
+#include "../include/display.h"
+#include "../include/GSM.h"
+#include "../include/Stage.h"
+#include "../include/Timer.h"
+#include "../include/FrameProfiler.h"
+#include "../include/MemoryTracker.h"
+#include "../include/Logger.h"
+#include "temp_utils.hpp"
+
+using namespace Logger;
+
+namespace Engine
+{
+  static const char LOG_MAGIC[4] = { 'R', 'F', 'I', 'N' };
+  static const uint16_t LOG_VERSION = 1;
+
+  // Size of a frame's fixed part: frame ns, dt, seed, event count
+  static const size_t FRAME_HEADER_SIZE = 14;
+
+  enum RecordedEvent : uint8_t
+  {
+    EVENT_KEY_DOWN,
+    EVENT_KEY_UP,
+    EVENT_BUTTON_DOWN,
+    EVENT_BUTTON_UP,
+    EVENT_WHEEL,
+    EVENT_MOTION
+  };
+
+  // Bytes following the type of each event
+  static size_t EventSize(uint8_t type)
+  {
+    switch (type)
+    {
+    case EVENT_KEY_DOWN:
+    case EVENT_KEY_UP:      return 2;
+    case EVENT_BUTTON_DOWN:
+    case EVENT_BUTTON_UP:   return 1;
+    case EVENT_WHEEL:       return 2;
+    case EVENT_MOTION:      return 4;
+    default:                return 0;
+    }
+  }
+
+  static void Write16(std::vector<uint8_t> & out, uint16_t value)
+  {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+  }
+
+  static void Write32(std::vector<uint8_t> & out, uint32_t value)
+  {
+    Write16(out, static_cast<uint16_t>(value));
+    Write16(out, static_cast<uint16_t>(value >> 16));
+  }
+
+  static uint16_t Read16(const uint8_t * in)
+  {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+  }
+
+  static uint32_t Read32(const uint8_t * in)
+  {
+    return Read16(in) | (static_cast<uint32_t>(Read16(in + 2)) << 16);
+  }
+
+  // Mouse positions are stored as 16 bits, windows are never that big
+  static int16_t ClampCoord(int value)
+  {
+    return static_cast<int16_t>(std::max(-32768, std::min(32767, value)));
+  }
+
+  InputRecorder::InputRecorder() : mode_(IDLE), file_(nullptr), eventCount_(0),
+    applying_(false), lastClock_(0), replayClock_(0), exitWhenDone_(false)
+  {}
+
+  InputRecorder & InputRecorder::get()
+  {
+    static InputRecorder recorder;
+
+    return recorder;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Starts writing every frame's input to a log. Should be started before
+      the first frame of the main loop, so a replay starts from the same state
+
+    \param path
+      File to write the log to
+
+    \return
+      Whether the file could be opened
+  */
+  /****************************************************************************/
+  bool InputRecorder::StartRecording(const std::string & path)
+  {
+    InputRecorder & rec = get();
+
+    Stop();
+
+    rec.file_ = fopen(path.c_str(), "wb");
+
+    if (!rec.file_)
+    {
+      Log<Error>("Could not open input log '%s' for writing", path.c_str());
+      return false;
+    }
+
+    std::vector<uint8_t> header(LOG_MAGIC, LOG_MAGIC + 4);
+    Write16(header, LOG_VERSION);
+    Write16(header, 0);
+    fwrite(header.data(), 1, header.size(), rec.file_);
+
+    rec.mode_ = RECORDING;
+    rec.events_.clear();
+    rec.eventCount_ = 0;
+    rec.seeds_.seed(std::random_device()());
+    rec.lastClock_ = FrameClock::Now();
+
+    Log<Info>("Recording input to '%s'", path.c_str());
+
+    return true;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Starts playing back a recorded log. Live input is ignored until the log
+      runs out, then a summary of the frame times is logged
+
+    \param path
+      Log to play back
+
+    \param exitWhenDone
+      Ends the game once the log runs out
+
+    \return
+      Whether the log could be opened
+  */
+  /****************************************************************************/
+  bool InputRecorder::StartReplay(const std::string & path, bool exitWhenDone)
+  {
+    InputRecorder & rec = get();
+
+    Stop();
+
+    rec.file_ = fopen(path.c_str(), "rb");
+
+    if (!rec.file_)
+    {
+      Log<Error>("Could not open input log '%s' for reading", path.c_str());
+      return false;
+    }
+
+    uint8_t header[8];
+
+    if (fread(header, 1, sizeof(header), rec.file_) != sizeof(header) ||
+        memcmp(header, LOG_MAGIC, 4) != 0 || Read16(header + 4) != LOG_VERSION)
+    {
+      Log<Error>("'%s' is not an input log this version can play", path.c_str());
+      fclose(rec.file_);
+      rec.file_ = nullptr;
+      return false;
+    }
+
+    rec.mode_ = REPLAYING;
+    rec.exitWhenDone_ = exitWhenDone;
+    rec.replayClock_ = FrameClock::Now();
+    rec.lastClock_ = FrameProfiler::Now();
+    rec.frameTimes_.Clear();
+
+    Log<Info>("Replaying input from '%s'", path.c_str());
+
+    return true;
+  }
+
+  void InputRecorder::Stop()
+  {
+    InputRecorder & rec = get();
+
+    if (rec.file_)
+      fclose(rec.file_);
+
+    rec.file_ = nullptr;
+    rec.mode_ = IDLE;
+  }
+
+  bool InputRecorder::IsRecording()
+  {
+    return get().mode_ == RECORDING;
+  }
+
+  bool InputRecorder::IsReplaying()
+  {
+    return get().mode_ == REPLAYING;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Called by the input system for every SDL event. Records input events
+      while recording, and throws out live input while replaying
+
+    \param event
+      The event
+
+    \return
+      True if the input system should ignore the event
+  */
+  /****************************************************************************/
+  bool InputRecorder::FilterEvent(const SDL_Event & event)
+  {
+    InputRecorder & rec = get();
+
+    if (rec.mode_ == IDLE || rec.applying_)
+      return false;
+
+    uint8_t type;
+    std::vector<uint8_t> data;
+
+    switch (event.type)
+    {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      type = event.type == SDL_KEYDOWN ? EVENT_KEY_DOWN : EVENT_KEY_UP;
+      Write16(data, static_cast<uint16_t>(event.key.keysym.scancode));
+      break;
+
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      type = event.type == SDL_MOUSEBUTTONDOWN ? EVENT_BUTTON_DOWN : EVENT_BUTTON_UP;
+      data.push_back(event.button.button);
+      break;
+
+    case SDL_MOUSEWHEEL:
+      type = EVENT_WHEEL;
+      Write16(data, static_cast<uint16_t>(ClampCoord(event.wheel.y)));
+      break;
+
+    case SDL_MOUSEMOTION:
+      type = EVENT_MOTION;
+      Write16(data, static_cast<uint16_t>(ClampCoord(event.motion.x)));
+      Write16(data, static_cast<uint16_t>(ClampCoord(event.motion.y)));
+      break;
+
+    default:
+      // Window events still go through, they aren't part of the recording
+      return false;
+    }
+
+    if (rec.mode_ == REPLAYING)
+      return true;
+
+    rec.events_.push_back(type);
+    rec.events_.insert(rec.events_.end(), data.begin(), data.end());
+    ++rec.eventCount_;
+
+    return false;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Called once per frame after the display has handled its events. Writes
+      out the frame while recording, or feeds in the next recorded frame while
+      replaying. Either way, random numbers are reseeded for the frame
+
+    \param disp
+      The display, for the frame time
+  */
+  /****************************************************************************/
+  void InputRecorder::EndFrame(Display & disp)
+  {
+    InputRecorder & rec = get();
+
+    if (rec.mode_ == RECORDING)
+      rec.recordFrame(disp);
+    else if (rec.mode_ == REPLAYING)
+      rec.replayFrame(disp);
+  }
+
+  void InputRecorder::recordFrame(Display & disp)
+  {
+    uint64_t clock = FrameClock::Now();
+    uint32_t seed = seeds_();
+    float dt = disp.GetFrameTime();
+    uint32_t dtBits;
+
+    memcpy(&dtBits, &dt, sizeof(dtBits));
+
+    std::vector<uint8_t> frame;
+    frame.reserve(FRAME_HEADER_SIZE + events_.size());
+
+    Write32(frame, static_cast<uint32_t>(std::min<uint64_t>(clock - lastClock_, UINT32_MAX)));
+    Write32(frame, dtBits);
+    Write32(frame, seed);
+    Write16(frame, eventCount_);
+    frame.insert(frame.end(), events_.begin(), events_.end());
+
+    fwrite(frame.data(), 1, frame.size(), file_);
+
+    events_.clear();
+    eventCount_ = 0;
+    lastClock_ = clock;
+
+    Utils::seed_random(seed);
+    Stage::SeedLuaRandom(seed);
+  }
+
+  void InputRecorder::replayFrame(Display & disp)
+  {
+    uint64_t now = FrameProfiler::Now();
+    uint8_t header[FRAME_HEADER_SIZE];
+
+    if (fread(header, 1, sizeof(header), file_) != sizeof(header))
+    {
+      reportBenchmark();
+      Stop();
+
+      if (exitWhenDone_)
+        GSM::get().getMessenger().Post<std::string>("GSM_END", "Input replay finished");
+
+      return;
+    }
+
+    frameTimes_.Record((now - lastClock_) / 1000);
+    lastClock_ = now;
+
+    uint32_t frameNanos = Read32(header);
+    uint32_t dtBits = Read32(header + 4);
+    uint32_t seed = Read32(header + 8);
+    uint16_t events = Read16(header + 12);
+    float dt;
+
+    memcpy(&dt, &dtBits, sizeof(dt));
+
+    // Timers and frame time see the recorded frame, not how long it took now
+    replayClock_ += frameNanos;
+    FrameClock::Publish(replayClock_);
+    disp.OverrideFrameTime(dt);
+
+    Utils::seed_random(seed);
+    Stage::SeedLuaRandom(seed);
+
+    applying_ = true;
+
+    for (uint16_t i = 0; i < events; ++i)
+    {
+      uint8_t type;
+      uint8_t data[4];
+
+      if (fread(&type, 1, 1, file_) != 1 ||
+          EventSize(type) == 0 ||
+          fread(data, 1, EventSize(type), file_) != EventSize(type))
+      {
+        Log<Error>("Input log is corrupt, stopping the replay");
+        applying_ = false;
+        Stop();
+        return;
+      }
+
+      applyEvent(type, data);
+    }
+
+    applying_ = false;
+  }
+
+  // Rebuilds an SDL event from a recorded one and hands it to the input system
+  void InputRecorder::applyEvent(uint8_t type, const uint8_t * data)
+  {
+    SDL_Event event;
+    memset(&event, 0, sizeof(event));
+
+    switch (type)
+    {
+    case EVENT_KEY_DOWN:
+    case EVENT_KEY_UP:
+      event.type = type == EVENT_KEY_DOWN ? SDL_KEYDOWN : SDL_KEYUP;
+      event.key.keysym.scancode = static_cast<SDL_Scancode>(Read16(data));
+      break;
+
+    case EVENT_BUTTON_DOWN:
+    case EVENT_BUTTON_UP:
+      event.type = type == EVENT_BUTTON_DOWN ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+      event.button.button = data[0];
+      break;
+
+    case EVENT_WHEEL:
+      event.type = SDL_MOUSEWHEEL;
+      event.wheel.y = static_cast<int16_t>(Read16(data));
+      break;
+
+    case EVENT_MOTION:
+      event.type = SDL_MOUSEMOTION;
+      event.motion.x = static_cast<int16_t>(Read16(data));
+      event.motion.y = static_cast<int16_t>(Read16(data + 2));
+      break;
+    }
+
+    InputSystem::Update(event);
+  }
+
+  // Logs how long the replayed frames really took
+  void InputRecorder::reportBenchmark() const
+  {
+    if (frameTimes_.Count() == 0)
+      return;
+
+    FrameStats stats = FrameProfiler::MakeStats(frameTimes_);
+
+    Log<Info>("Replay done: %u frames in %.2f s. mean %.2f  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms",
+      static_cast<unsigned>(stats.frames), stats.mean * stats.frames / 1e3, stats.mean,
+      stats.p50, stats.p95, stats.p99, stats.max);
+
+    MemoryTracker::LogReport();
+  }
+}
@@ -27,6 +27,7 @@ namespace Engine
   {
     Json::Value property = object.get("objects", defValue);
     Json::Value index = object.get("index", defValue);
+    waves_ = object.get("waves", "").asString();
     Log<Info>("%s", name.c_str());
 
     // Object's component list is not properly deffined
@@ -47,11 +48,15 @@ namespace Engine
     //loadInstances(stage);
     loadInstances(stage);
 
+    // Resets are spread over several frames, one instance per load step
     auto resFunc = 
       [this](Stage* stg) 
     {
-      loadInstances(*stg);
-      Init_functions[index_](stg);
+      for (auto & instance : objects)
+        stg->queueLoadStep([instance](Stage * s) { s->addGameInstance(instance); });
+
+      int index = index_;
+      stg->queueLoadStep([index](Stage * s) { Init_functions[index](s); });
     };
 
     Stage::SetResetFunc(stage, std::function<void(Stage*)>(resFunc), false);
@@ -91,6 +96,9 @@ namespace Engine
         int j = Level::Levels[objectNames[i]]->index_;
         std::string s = Level::Levels[objectNames[i]]->name_;
         Init_functions[j](&Stage::GetStage(s));
+
+        // Freshly loaded, so the first reset has nothing to do
+        Stage::GetStage(s).setStagePreloaded(true);
       }
     }
     else
@@ -0,0 +1,349 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+#include "../include/MemoryTracker.h"
+#include "../include/Logger.h"
+
+namespace Engine
+{
+  // Stored in front of every tracked allocation. 16 bytes, so the memory
+  // handed out keeps malloc's alignment
+  struct AllocHeader
+  {
+    uint64_t size;
+    uint32_t tag;
+    uint32_t magic;
+  };
+
+  static_assert(sizeof(AllocHeader) == 16, "Allocation header has to keep 16 byte alignment");
+
+  static const uint32_t ALLOC_MAGIC = 0x4D454D54;
+
+  static const char * TAG_NAMES[] = { "Other", "ECS", "Render", "Scripting", "Assets", "Audio" };
+
+  static_assert(sizeof(TAG_NAMES) / sizeof(*TAG_NAMES) == MemoryTracker::TAG_COUNT, "Every memory tag needs a name");
+
+  // Written from any thread. Plain atomics so they are zeroed before any
+  // static constructor can allocate
+  struct TagCounters
+  {
+    std::atomic<int64_t> live;
+    std::atomic<int64_t> peak;
+    std::atomic<uint64_t> allocs;
+    std::atomic<uint64_t> frameAllocs;
+    std::atomic<uint64_t> frameFrees;
+    std::atomic<uint64_t> frameBytes;
+  };
+
+  static TagCounters counters[MemoryTracker::TAG_COUNT];
+
+  // Frame values of the last finished frame, only touched by the game thread
+  static MemoryStats lastFrame[MemoryTracker::TAG_COUNT];
+
+  static thread_local MemoryTag currentTag = MemoryTag::Other;
+
+  static void CountAlloc(uint32_t tag, uint64_t size)
+  {
+    TagCounters & tagCounters = counters[tag];
+
+    int64_t live = tagCounters.live.fetch_add(size, std::memory_order_relaxed) + size;
+    int64_t peak = tagCounters.peak.load(std::memory_order_relaxed);
+
+    while (live > peak && !tagCounters.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+      ;
+
+    tagCounters.allocs.fetch_add(1, std::memory_order_relaxed);
+    tagCounters.frameAllocs.fetch_add(1, std::memory_order_relaxed);
+    tagCounters.frameBytes.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  static void CountFree(uint32_t tag, uint64_t size)
+  {
+    counters[tag].live.fetch_sub(size, std::memory_order_relaxed);
+    counters[tag].frameFrees.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // The memory has to come from Allocate
+  static AllocHeader * GetHeader(void * ptr)
+  {
+    AllocHeader * header = static_cast<AllocHeader *>(ptr) - 1;
+
+    assert(header->magic == ALLOC_MAGIC && "Memory didn't come from the tracker, or was freed twice");
+
+    return header;
+  }
+
+  MemoryTracker::Scope::Scope(MemoryTag tag) : previous_{ currentTag }, running_{ true }
+  {
+    currentTag = tag;
+  }
+
+  MemoryTracker::Scope::~Scope()
+  {
+    Stop();
+  }
+
+  void MemoryTracker::Scope::Stop()
+  {
+    if (!running_)
+      return;
+
+    currentTag = previous_;
+    running_ = false;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Allocates memory and counts it under a subsystem
+
+    \param size
+      Bytes to allocate
+
+    \param tag
+      Subsystem to count the memory under
+
+    \return
+      The memory, or null if there wasn't enough
+  */
+  /****************************************************************************/
+  void * MemoryTracker::Allocate(size_t size, MemoryTag tag)
+  {
+    AllocHeader * header = static_cast<AllocHeader *>(malloc(sizeof(AllocHeader) + size));
+
+    if (!header)
+      return nullptr;
+
+    header->size = size;
+    header->tag = static_cast<uint32_t>(tag);
+    header->magic = ALLOC_MAGIC;
+
+    CountAlloc(header->tag, size);
+
+    return header + 1;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Resizes memory from Allocate. The memory moves to the given tag
+
+    \param ptr
+      Memory to resize, null allocates new memory
+
+    \param size
+      New size in bytes
+
+    \param tag
+      Subsystem to count the memory under
+
+    \return
+      The memory, or null if there wasn't enough. The old memory is left
+      alone in that case
+  */
+  /****************************************************************************/
+  void * MemoryTracker::Reallocate(void * ptr, size_t size, MemoryTag tag)
+  {
+    if (!ptr)
+      return Allocate(size, tag);
+
+    AllocHeader * old = GetHeader(ptr);
+    uint32_t oldTag = old->tag;
+    uint64_t oldSize = old->size;
+
+    AllocHeader * header = static_cast<AllocHeader *>(realloc(old, sizeof(AllocHeader) + size));
+
+    if (!header)
+      return nullptr;
+
+    CountFree(oldTag, oldSize);
+
+    header->size = size;
+    header->tag = static_cast<uint32_t>(tag);
+
+    CountAlloc(header->tag, size);
+
+    return header + 1;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Frees memory from Allocate or Reallocate
+
+    \param ptr
+      Memory to free, may be null
+  */
+  /****************************************************************************/
+  void MemoryTracker::Free(void * ptr)
+  {
+    if (!ptr)
+      return;
+
+    AllocHeader * header = GetHeader(ptr);
+
+    CountFree(header->tag, header->size);
+
+    // So a double free trips the assert
+    header->magic = 0;
+    free(header);
+  }
+
+  MemoryTag MemoryTracker::CurrentTag()
+  {
+    return currentTag;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Keeps the frame values of the frame that just finished, and starts
+      counting the next one. Called once at the start of every frame
+  */
+  /****************************************************************************/
+  void MemoryTracker::NewFrame()
+  {
+    for (size_t i = 0; i < TAG_COUNT; ++i)
+    {
+      lastFrame[i].frameAllocs = counters[i].frameAllocs.exchange(0, std::memory_order_relaxed);
+      lastFrame[i].frameFrees = counters[i].frameFrees.exchange(0, std::memory_order_relaxed);
+      lastFrame[i].frameBytes = counters[i].frameBytes.exchange(0, std::memory_order_relaxed);
+    }
+  }
+
+  MemoryStats MemoryTracker::GetStats(MemoryTag tag)
+  {
+    size_t i = static_cast<size_t>(tag);
+    MemoryStats stats = lastFrame[i];
+
+    stats.live = counters[i].live.load(std::memory_order_relaxed);
+    stats.peak = counters[i].peak.load(std::memory_order_relaxed);
+    stats.allocs = counters[i].allocs.load(std::memory_order_relaxed);
+
+    return stats;
+  }
+
+  const char * MemoryTracker::GetTagName(MemoryTag tag)
+  {
+    return TAG_NAMES[static_cast<size_t>(tag)];
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Logs the memory use of every subsystem, one line each
+  */
+  /****************************************************************************/
+  void MemoryTracker::LogReport()
+  {
+    for (size_t i = 0; i < TAG_COUNT; ++i)
+    {
+      MemoryStats stats = GetStats(static_cast<MemoryTag>(i));
+
+      Logger::Log<Logger::Info>("Memory %s: live %.1f KB  peak %.1f KB  %llu allocs  last frame %llu allocs %llu frees %.1f KB",
+        TAG_NAMES[i], stats.live / 1024.0, stats.peak / 1024.0, static_cast<unsigned long long>(stats.allocs),
+        static_cast<unsigned long long>(stats.frameAllocs), static_cast<unsigned long long>(stats.frameFrees),
+        stats.frameBytes / 1024.0);
+    }
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Writes the memory use of every subsystem out as CSV, one row each
+
+    \param path
+      File to write to
+
+    \return
+      True if the file was written
+  */
+  /****************************************************************************/
+  bool MemoryTracker::ExportCSV(const std::string & path)
+  {
+    std::ofstream file(path);
+
+    if (!file)
+      return false;
+
+    file << "tag,live_bytes,peak_bytes,allocs,frame_allocs,frame_frees,frame_bytes\n";
+
+    for (size_t i = 0; i < TAG_COUNT; ++i)
+    {
+      MemoryStats stats = GetStats(static_cast<MemoryTag>(i));
+
+      file << TAG_NAMES[i] << "," << stats.live << "," << stats.peak << "," << stats.allocs << ","
+        << stats.frameAllocs << "," << stats.frameFrees << "," << stats.frameBytes << "\n";
+    }
+
+    return static_cast<bool>(file);
+  }
+}
+
+#ifndef ENGINE_NO_MEMORY_TRACKING
+
+// Every new and delete in the game goes through the tracker
+void * operator new(size_t size)
+{
+  void * ptr = Engine::MemoryTracker::Allocate(size, Engine::MemoryTracker::CurrentTag());
+
+  if (!ptr)
+    throw std::bad_alloc();
+
+  return ptr;
+}
+
+void * operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+  return Engine::MemoryTracker::Allocate(size, Engine::MemoryTracker::CurrentTag());
+}
+
+void * operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+  return Engine::MemoryTracker::Allocate(size, Engine::MemoryTracker::CurrentTag());
+}
+
+void operator delete(void * ptr) noexcept
+{
+  Engine::MemoryTracker::Free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+  Engine::MemoryTracker::Free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept
+{
+  Engine::MemoryTracker::Free(ptr);
+}
+
+void operator delete[](void * ptr, size_t) noexcept
+{
+  Engine::MemoryTracker::Free(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept
+{
+  Engine::MemoryTracker::Free(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept
+{
+  Engine::MemoryTracker::Free(ptr);
+}
+
+#endif
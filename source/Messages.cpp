@@ -216,18 +216,17 @@ namespace Engine
 
   void Messenger::PostMsg(const std::string & eventType, const Packet & payload)
   {
-    try
+    auto subscribers = subscriberList_.find(eventType);
+
+    // No event listeners exist for that type, no need to do anything
+    if (subscribers == subscriberList_.end())
+      return;
+
+    // Get each subscriber listening for the given event type
+    for (auto & subscriber_entry : subscribers->second)
     {
-      //auto subscribers = subscriberList_.at(eventType);
-      // Get each subscriber listening for the given event type
-      for (auto & subscriber_entry : subscriberList_.at(eventType))
-      {
-        for(auto & sub : subscriber_entry.second)
-          sub.second(payload); // Call the event function with the given payload
-      }
+      for(auto & sub : subscriber_entry.second)
+        sub.second(payload); // Call the event function with the given payload
     }
-    // No event listeners exist for that type, no need to do anything
-    catch (std::out_of_range &)
-    {}
   }
 }
@@ -0,0 +1,369 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include <SDL2/SDL.h>
+
+#include <GL/glew.h>
+#include <GL/GL.h>
+
+#include <algorithm>
+
+#include "PickBuffer.h"
+#include "Renderer.h"
+#include "RMesh.h"
+#include "Shader.h"
+
+using namespace Logger;
+
+PickBuffer::PickBuffer() :
+  width_{ 0 }, height_{ 0 }, point_{ 0, 0 },
+  program_{ NULL }, fbo_{ NULL }, target_{ NULL }, pbo_{ NULL, NULL }, fence_{ nullptr, nullptr },
+  slot_{ 0 }, transformLocation_{ -1 }, idLocation_{ -1 },
+  resultId_{ 0 }, resultFace_{ PF_NONE }, hasResult_{ false }
+{}
+
+PickBuffer::~PickBuffer()
+{
+  clean();
+}
+
+/**
+* \brief  Links the picking program and creates the id target and pixel buffers
+*
+* \return Whether the picking pass can be used
+*/
+bool PickBuffer::init(const Shader & vertex, const Shader & fragment, size_t width, size_t height)
+{
+  clean();
+
+  if (!vertex.isShaderLoaded() || !fragment.isShaderLoaded())
+    return false;
+
+  program_ = glCreateProgram();
+
+  glAttachShader(program_, vertex.location());
+  glAttachShader(program_, fragment.location());
+  glLinkProgram(program_);
+
+  GLint status;
+  glGetProgramiv(program_, GL_LINK_STATUS, &status);
+
+  if (!status)
+  {
+    Log<RenderError>("Failed to link the picking program");
+
+    glDeleteProgram(program_);
+    program_ = NULL;
+
+    return false;
+  }
+
+  transformLocation_ = glGetUniformLocation(program_, "transform");
+  idLocation_ = glGetUniformLocation(program_, "pickId");
+
+  glGenBuffers(2, pbo_);
+
+  for (GLuint pbo : pbo_)
+  {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, 2 * sizeof(GLuint), nullptr, GL_STREAM_READ);
+  }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, NULL);
+
+  width_ = width;
+  height_ = height;
+  createTarget();
+
+  return true;
+}
+
+void PickBuffer::clean()
+{
+  destroyTarget();
+
+  for (auto & buffers : buffers_)
+  {
+    glDeleteBuffers(1, &buffers.second.vbo);
+    glDeleteBuffers(1, &buffers.second.ibo);
+    glDeleteVertexArrays(1, &buffers.second.vao);
+  }
+
+  buffers_.clear();
+
+  for (unsigned i = 0; i < 2; ++i)
+  {
+    if (fence_[i])
+      glDeleteSync(fence_[i]);
+
+    fence_[i] = nullptr;
+  }
+
+  if (pbo_[0] != NULL)
+    glDeleteBuffers(2, pbo_);
+
+  pbo_[0] = pbo_[1] = NULL;
+
+  if (program_ != NULL)
+    glDeleteProgram(program_);
+
+  program_ = NULL;
+  hasResult_ = false;
+  queue_.clear();
+}
+
+void PickBuffer::resize(size_t width, size_t height)
+{
+  width_ = width;
+  height_ = height;
+
+  if (program_ == NULL)
+    return;
+
+  destroyTarget();
+  createTarget();
+}
+
+/**
+* \brief  Sets the point to resolve on the next pass, in normalized device coordinates
+*/
+void PickBuffer::setPoint(const glm::vec2 & ndc)
+{
+  point_ = ndc;
+}
+
+/**
+* \brief  Queues a mesh to be drawn into the id target on the next pass. Meshes
+*         with a higher draw order are drawn last and win the pixel.
+*/
+void PickBuffer::queue(const RMesh * mesh, const glm::mat4 & mat, unsigned id, size_t order)
+{
+  if (program_ == NULL || mesh == nullptr || mesh->tris.empty())
+    return;
+
+  queue_.push_back(PickItem{ mesh, mat, id, order });
+}
+
+/**
+* \brief  Draws the queued meshes into the id target, starts reading back the
+*         cursor pixel and collects the pixel that was read on the previous pass
+*/
+void PickBuffer::render(const Renderer & render)
+{
+  if (program_ == NULL)
+  {
+    queue_.clear();
+    return;
+  }
+
+  unsigned prev = slot_ ^ 1;
+
+  // Only the pixel under the cursor matters, so everything else is scissored away
+  GLint px = static_cast<GLint>((point_.x + 1) * 0.5f * width_);
+  GLint py = static_cast<GLint>((point_.y + 1) * 0.5f * height_);
+  bool inside = px >= 0 && py >= 0 && px < static_cast<GLint>(width_) && py < static_cast<GLint>(height_);
+
+  // Off target the cleared corner pixel is read instead, which reports no hit
+  if (!inside)
+    px = py = 0;
+
+  std::stable_sort(queue_.begin(), queue_.end(), [](const PickItem & lhs, const PickItem & rhs)
+  {
+    return lhs.order < rhs.order;
+  });
+
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+  glViewport(0, 0, static_cast<GLsizei>(width_), static_cast<GLsizei>(height_));
+  glDisable(GL_BLEND);
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(px, py, 1, 1);
+
+  const GLuint clear[4] = { 0, 0, 0, 0 };
+  glClearBufferuiv(GL_COLOR, 0, clear);
+
+  if (inside)
+  {
+    glUseProgram(program_);
+
+    for (auto & item : queue_)
+    {
+      const MeshBuffers & buffers = getBuffers(item.mesh);
+
+      glUniformMatrix4fv(transformLocation_, 1, GL_FALSE, &item.mat[0][0]);
+      glUniform1ui(idLocation_, item.id);
+
+      glBindVertexArray(buffers.vao);
+      glDrawElements(item.mesh->drawMode, buffers.count, GL_UNSIGNED_INT, 0);
+    }
+
+    glBindVertexArray(NULL);
+  }
+
+  // Start the readback for this pass
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[slot_]);
+  glReadBuffer(GL_COLOR_ATTACHMENT0);
+  glReadPixels(px, py, 1, 1, GL_RG_INTEGER, GL_UNSIGNED_INT, 0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, NULL);
+
+  if (fence_[slot_])
+    glDeleteSync(fence_[slot_]);
+
+  fence_[slot_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  glDisable(GL_SCISSOR_TEST);
+  glEnable(GL_BLEND);
+  glBindFramebuffer(GL_FRAMEBUFFER, NULL);
+  glViewport(static_cast<GLint>(render.getX()), static_cast<GLint>(render.getY()),
+    static_cast<GLsizei>(render.getWidth()), static_cast<GLsizei>(render.getHeight()));
+
+  // Collect the previous pass, if it has finished
+  readResult(prev);
+
+  queue_.clear();
+  slot_ = prev;
+}
+
+/**
+* \brief  Gets the id and face that were under the cursor on the last completed pass
+*
+* \return False if no pass has completed yet
+*/
+bool PickBuffer::getResult(unsigned & id, unsigned & face) const
+{
+  if (!hasResult_)
+    return false;
+
+  id = resultId_;
+  face = resultFace_;
+
+  return true;
+}
+
+bool PickBuffer::isReady() const
+{
+  return program_ != NULL;
+}
+
+void PickBuffer::createTarget()
+{
+  if (width_ == 0 || height_ == 0)
+    return;
+
+  glGenTextures(1, &target_);
+  glBindTexture(GL_TEXTURE_2D, target_);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, static_cast<GLsizei>(width_), static_cast<GLsizei>(height_),
+    0, GL_RG_INTEGER, GL_UNSIGNED_INT, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindTexture(GL_TEXTURE_2D, NULL);
+
+  glGenFramebuffers(1, &fbo_);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target_, 0);
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    Log<RenderError>("Picking framebuffer is incomplete");
+
+  glBindFramebuffer(GL_FRAMEBUFFER, NULL);
+}
+
+void PickBuffer::destroyTarget()
+{
+  if (fbo_ != NULL)
+    glDeleteFramebuffers(1, &fbo_);
+
+  if (target_ != NULL)
+    glDeleteTextures(1, &target_);
+
+  fbo_ = NULL;
+  target_ = NULL;
+}
+
+/**
+* \brief  Frees the buffers uploaded for a mesh and drops any queued picks of
+*         it. Must be called before a mesh is destroyed or replaced.
+*/
+void PickBuffer::releaseMesh(const RMesh * mesh)
+{
+  queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+    [mesh](const PickItem & item) { return item.mesh == mesh; }), queue_.end());
+
+  auto it = buffers_.find(mesh);
+
+  if (it == buffers_.end())
+    return;
+
+  glDeleteBuffers(1, &it->second.vbo);
+  glDeleteBuffers(1, &it->second.ibo);
+  glDeleteVertexArrays(1, &it->second.vao);
+
+  buffers_.erase(it);
+}
+
+/**
+* \brief  Gets the buffers for a mesh, uploading it the first time it is picked
+*/
+const PickBuffer::MeshBuffers & PickBuffer::getBuffers(const RMesh * mesh)
+{
+  auto it = buffers_.find(mesh);
+
+  if (it != buffers_.end())
+    return it->second;
+
+  MeshBuffers buffers;
+
+  glGenVertexArrays(1, &buffers.vao);
+  glGenBuffers(1, &buffers.vbo);
+  glGenBuffers(1, &buffers.ibo);
+  buffers.count = static_cast<GLsizei>(3 * mesh->tris.size());
+
+  glBindVertexArray(buffers.vao);
+
+  glBindBuffer(GL_ARRAY_BUFFER, buffers.vbo);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * mesh->verts.size(), &mesh->verts[0], GL_STATIC_DRAW);
+
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, point));
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.ibo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh->tris.size() * sizeof(Tri), &mesh->tris.front(), GL_STATIC_DRAW);
+
+  glBindVertexArray(NULL);
+
+  return buffers_.insert(std::make_pair(mesh, buffers)).first->second;
+}
+
+/**
+* \brief  Maps a pixel buffer whose readback has completed. If the GPU is still
+*         behind, the last result is kept rather than waiting on it.
+*/
+void PickBuffer::readResult(unsigned slot)
+{
+  if (!fence_[slot])
+    return;
+
+  GLenum state = glClientWaitSync(fence_[slot], 0, 0);
+
+  if (state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED)
+    return;
+
+  glDeleteSync(fence_[slot]);
+  fence_[slot] = nullptr;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[slot]);
+
+  const GLuint * pixel = static_cast<const GLuint *>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, 2 * sizeof(GLuint), GL_MAP_READ_BIT));
+
+  if (pixel)
+  {
+    resultId_ = pixel[0];
+    resultFace_ = pixel[1];
+    hasResult_ = true;
+
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, NULL);
+}
@@ -0,0 +1,237 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include "RenderQueue.h"
+#include "RMesh.h"
+#include "DrawSurface.h"
+#include "EngineCounters.h"
+#include "StaticBatch.h"
+#include "TextBatch.h"
+
+using namespace Engine;
+
+static const unsigned SHADER_BITS = 4;
+static const unsigned TEXTURE_BITS = 12;
+static const unsigned MESH_BITS = 8;
+
+static const unsigned MESH_SHIFT = 0;
+static const unsigned TEXTURE_SHIFT = MESH_SHIFT + MESH_BITS;
+static const unsigned SHADER_SHIFT = TEXTURE_SHIFT + TEXTURE_BITS;
+static const unsigned RANK_SHIFT = SHADER_SHIFT + SHADER_BITS;
+static const unsigned LAYER_SHIFT = 56;
+
+// Shader field values
+static const unsigned SHADER_BASIC = 0;
+static const unsigned SHADER_TEXT = 1;
+
+RenderQueue::RenderQueue()
+{}
+
+void RenderQueue::clear()
+{
+  keys_.clear();
+  packets_.clear();
+  instances_.clear();
+  order_.clear();
+}
+
+/**
+* \brief  Adds a packet to the queue
+*
+* \param  layer    Layer the packet is drawn on, lower layers are drawn first
+* \param  rank     Position in the layer's draw order
+* \param  mesh     The mesh
+* \param  surface  The surface, or nullptr
+* \param  mat      Final transformation of the packet
+* \param  shade    Color the packet is shaded with
+* \param  frame    Animation frame of the surface
+*/
+void RenderQueue::push(DrawLayer layer, uint32_t rank,
+  const RMesh * mesh, const DrawSurface * surface,
+  const glm::mat4 & mat, const glm::vec4 & shade, unsigned frame)
+{
+  if (mesh == nullptr)
+    return;
+
+  keys_.push_back(makeKey(layer, rank, SHADER_BASIC, mesh, surface));
+  packets_.push_back(DrawPacket{ mesh, surface, nullptr, nullptr });
+  instances_.push_back(DrawInstance{ mat, shade, frame });
+}
+
+/**
+* \brief  Adds a static batch to the queue. Its instances are already on the GPU,
+*         so only the transformation shared by all of them is queued.
+*
+* \param  layer  Layer the batch is drawn on
+* \param  rank   Position in the layer's draw order
+* \param  batch  The batch
+* \param  group  Transformation applied to every instance of the batch
+*/
+void RenderQueue::pushStatic(DrawLayer layer, uint32_t rank, const StaticBatch * batch, const glm::mat4 & group)
+{
+  if (batch == nullptr || batch->size() == 0)
+    return;
+
+  keys_.push_back(makeKey(layer, rank, SHADER_BASIC, batch->getMesh(), batch->getSurface()));
+  packets_.push_back(DrawPacket{ batch->getMesh(), batch->getSurface(), batch, nullptr });
+  instances_.push_back(DrawInstance{ group, glm::vec4(1), 0 });
+}
+
+/**
+* \brief  Adds a layer's text to the queue. It is ranked after every element of
+*         the layer so labels stay on top of the sprites they annotate.
+*
+* \param  layer  Layer the text is drawn on
+* \param  text   The laid out text
+* \param  group  Transformation applied to every label
+*/
+void RenderQueue::pushText(DrawLayer layer, const TextBatch * text, const glm::mat4 & group)
+{
+  if (text == nullptr || text->empty())
+    return;
+
+  keys_.push_back(makeKey(layer, UINT32_MAX, SHADER_TEXT, nullptr, nullptr));
+  packets_.push_back(DrawPacket{ nullptr, nullptr, nullptr, text });
+  instances_.push_back(DrawInstance{ group, glm::vec4(1), 0 });
+}
+
+/**
+* \brief  Sorts the packets by key with a stable LSD radix sort, skipping any
+*         byte that is the same across every key
+*/
+void RenderQueue::sort()
+{
+  size_t count = keys_.size();
+
+  sortKeys_ = keys_;
+  keyScratch_.resize(count);
+  order_.resize(count);
+  orderScratch_.resize(count);
+
+  for (size_t i = 0; i < count; ++i)
+    order_[i] = static_cast<uint32_t>(i);
+
+  for (unsigned shift = 0; shift < 64; shift += 8)
+  {
+    size_t buckets[256] = { 0 };
+
+    for (uint64_t key : sortKeys_)
+      ++buckets[(key >> shift) & 0xFF];
+
+    if (buckets[(sortKeys_.empty() ? 0 : sortKeys_[0] >> shift) & 0xFF] == count)
+      continue;
+
+    size_t offset = 0;
+
+    for (size_t & bucket : buckets)
+    {
+      size_t size = bucket;
+      bucket = offset;
+      offset += size;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      size_t dest = buckets[(sortKeys_[i] >> shift) & 0xFF]++;
+
+      keyScratch_[dest] = sortKeys_[i];
+      orderScratch_[dest] = order_[i];
+    }
+
+    sortKeys_.swap(keyScratch_);
+    order_.swap(orderScratch_);
+  }
+}
+
+/**
+* \brief  Uploads every instance in sorted order and draws runs of packets that
+*         share a mesh and surface with one call each
+*/
+void RenderQueue::submit(Renderer & render)
+{
+  if (order_.size() != packets_.size())
+    sort();
+
+  sorted_.resize(order_.size());
+
+  for (size_t i = 0; i < order_.size(); ++i)
+    sorted_[i] = instances_[order_[i]];
+
+  render.uploadInstances(sorted_.data(), sorted_.size());
+
+  size_t batches = 0;
+  size_t first = 0;
+
+  while (first < order_.size())
+  {
+    const DrawPacket & packet = packets_[order_[first]];
+    size_t last = first + 1;
+
+    if (packet.text)
+    {
+      packet.text->draw(render, sorted_[first].transform);
+      ++batches;
+      ++first;
+      continue;
+    }
+
+    if (packet.batch)
+    {
+      render.drawStatic(*packet.batch, sorted_[first].transform);
+      ++batches;
+      ++first;
+      continue;
+    }
+
+    while (last < order_.size() &&
+           packets_[order_[last]].batch == nullptr &&
+           packets_[order_[last]].text == nullptr &&
+           packets_[order_[last]].mesh == packet.mesh &&
+           packets_[order_[last]].surface == packet.surface)
+      ++last;
+
+    render.drawInstances(*packet.mesh, packet.surface, first, last - first, packet.mesh->drawMode);
+    ++batches;
+
+    first = last;
+  }
+
+  EngineCounters::Add("Draw packets", static_cast<double>(order_.size()));
+  EngineCounters::Add("Draw batches", static_cast<double>(batches));
+}
+
+size_t RenderQueue::size() const
+{
+  return packets_.size();
+}
+
+uint64_t RenderQueue::makeKey(DrawLayer layer, uint32_t rank, unsigned shader, const RMesh * mesh, const DrawSurface * surface)
+{
+  // Ids that outgrow their field only cost batching, packets are compared directly when submitted
+  uint64_t texture = getResourceId(textureIds_, surface) & ((1u << TEXTURE_BITS) - 1);
+  uint64_t meshId = getResourceId(meshIds_, mesh) & ((1u << MESH_BITS) - 1);
+
+  return (static_cast<uint64_t>(layer & 0xFF) << LAYER_SHIFT) |
+    (static_cast<uint64_t>(rank) << RANK_SHIFT) |
+    (static_cast<uint64_t>(shader & ((1u << SHADER_BITS) - 1)) << SHADER_SHIFT) |
+    (texture << TEXTURE_SHIFT) |
+    (meshId << MESH_SHIFT);
+}
+
+unsigned RenderQueue::getResourceId(std::unordered_map<const void *, unsigned> & ids, const void * res)
+{
+  if (res == nullptr)
+    return 0;
+
+  auto it = ids.find(res);
+
+  if (it != ids.end())
+    return it->second;
+
+  unsigned id = static_cast<unsigned>(ids.size()) + 1;
+  ids.insert(std::make_pair(res, id));
+
+  return id;
+}
@@ -9,6 +9,7 @@
 #include <GL/GL.h>
 
 #include <stdexcept>
+#include <algorithm>
 
 #include "glm/glm/mat4x4.hpp"
 
@@ -17,6 +18,8 @@
 #include "DrawSurface.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "StaticBatch.h"
+#include "Font.h"
 
 
 using namespace Logger;
@@ -24,7 +27,10 @@ using namespace Logger;
 static std::mutex LOCKER;
 
 Renderer::Renderer(SDL_Window * win, size_t x, size_t y, size_t width, size_t height) :
-  dev_{ nullptr }, devcon_{ nullptr }, compShader_{ NULL }
+  dev_{ nullptr }, devcon_{ nullptr }, compShader_{ NULL },
+  texturedLocation_{ -1 }, frameCountLocation_{ -1 }, groupLocation_{ -1 },
+  textShader_{ NULL }, textGroupLocation_{ -1 },
+  instanceBuffer_{ NULL }, instanceCapacity_{ 0 }
 {
   setWindow(win);
   init(x, y, width, height);
@@ -37,11 +43,35 @@ Renderer::~Renderer()
 
 void Renderer::clean()
 {
-  if (devcon_)
-    SDL_GL_DeleteContext(devcon_);
-  
+  for (auto & buffers : meshBuffers_)
+  {
+    glDeleteBuffers(1, &buffers.second.vbo);
+    glDeleteBuffers(1, &buffers.second.ibo);
+    glDeleteVertexArrays(1, &buffers.second.vao);
+  }
+
+  meshBuffers_.clear();
+
+  if (instanceBuffer_ != NULL)
+    glDeleteBuffers(1, &instanceBuffer_);
+
+  instanceBuffer_ = NULL;
+  instanceCapacity_ = 0;
+
   if (compShader_ != NULL)
     glDeleteProgram(compShader_);
+
+  compShader_ = NULL;
+
+  if (textShader_ != NULL)
+    glDeleteProgram(textShader_);
+
+  textShader_ = NULL;
+
+  if (devcon_)
+    SDL_GL_DeleteContext(devcon_);
+
+  devcon_ = nullptr;
 }
 
 void Renderer::setWindow(SDL_Window * win)
@@ -105,6 +135,8 @@ void Renderer::init(size_t x, size_t y, size_t width, size_t height)
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
   compShader_ = glCreateProgram();
+
+  glGenBuffers(1, &instanceBuffer_);
   
   //lock.unlock();
 
@@ -145,114 +177,302 @@ void Renderer::resize(size_t x, size_t y, size_t width, size_t height)
   glViewport(x, y, width, height);
 }
 
+/**
+* \brief  Draws a single mesh. Goes through the instance buffer, so it must not
+*         be called between uploading instances and drawing them.
+*/
 void Renderer::draw(const RMesh & mesh, const glm::mat4 & mat, const glm::vec4 & shade, const DrawSurface * tex, unsigned currFrame, GLenum drawMode)
+{
+  DrawInstance instance{ mat, shade, currFrame };
+
+  uploadInstances(&instance, 1);
+  drawInstances(mesh, tex, 0, 1, drawMode);
+}
+
+/**
+* \brief  Replaces the contents of the instance buffer
+*/
+void Renderer::uploadInstances(const DrawInstance * instances, size_t count)
 {
   makeCurrent();
-  GLuint vaoID;
-  glGenVertexArrays(1, &vaoID);
 
- /* if (count > 1)
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer_);
+
+  if (count > instanceCapacity_)
+    instanceCapacity_ = std::max(count, 2 * instanceCapacity_);
+
+  // Orphan the old storage so the upload doesn't wait on draws still using it
+  glBufferData(GL_ARRAY_BUFFER, sizeof(DrawInstance) * instanceCapacity_, nullptr, GL_STREAM_DRAW);
+
+  if (count)
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(DrawInstance) * count, instances);
+
+  glBindBuffer(GL_ARRAY_BUFFER, NULL);
+}
+
+/**
+* \brief  Draws a mesh once for each instance in a range of the instance buffer
+*
+* \param  mesh      The mesh
+* \param  tex       The surface shared by every instance, or nullptr
+* \param  first     First instance to draw
+* \param  count     Number of instances to draw
+* \param  drawMode  Primitive type
+*/
+void Renderer::drawInstances(const RMesh & mesh, const DrawSurface * tex, size_t first, size_t count, GLenum drawMode)
+{
+  if (count == 0 || mesh.tris.empty())
+    return;
+
+  makeCurrent();
+
+  // Bind textures before VAO
+  useProgram(tex, glm::mat4());
+
+  const MeshBuffers & buffers = getBuffers(mesh);
+
+  glBindVertexArray(buffers.vao);
+
+  glDrawElementsInstancedBaseInstance(drawMode, buffers.count, GL_UNSIGNED_INT, 0,
+    static_cast<GLsizei>(count), static_cast<GLuint>(first));
+
+  glBindVertexArray(NULL);
+
+  if (tex != nullptr)
+    tex->unbind();
+}
+
+/**
+* \brief  Draws every instance of a static batch
+*
+* \param  batch  The batch
+* \param  group  Transformation applied on top of each instance's own
+*/
+void Renderer::drawStatic(const StaticBatch & batch, const glm::mat4 & group)
+{
+  if (batch.size() == 0)
+    return;
+
+  makeCurrent();
+
+  const DrawSurface * tex = batch.getSurface();
+
+  useProgram(tex, group);
+
+  glBindVertexArray(batch.getVAO());
+
+  glDrawElementsInstanced(batch.getDrawMode(), batch.getIndexCount(), GL_UNSIGNED_INT, 0,
+    static_cast<GLsizei>(batch.size()));
+
+  glBindVertexArray(NULL);
+
+  if (tex != nullptr)
+    tex->unbind();
+}
+
+/**
+* \brief  Links the program text is drawn with
+*
+* \return True if the program linked
+*/
+bool Renderer::useTextShaders(const Shader & vertex, const Shader & fragment)
+{
+  if (!vertex.isShaderLoaded() || !fragment.isShaderLoaded())
+    return false;
+
+  makeCurrent();
+
+  if (textShader_ != NULL)
+    glDeleteProgram(textShader_);
+
+  textShader_ = glCreateProgram();
+
+  glAttachShader(textShader_, vertex.location());
+  glAttachShader(textShader_, fragment.location());
+  glLinkProgram(textShader_);
+
+  GLint status;
+  glGetProgramiv(textShader_, GL_LINK_STATUS, &status);
+
+  if (!status)
   {
-    Log<RenderInfo>("Frame count: %u \n Current frame: %u", count, currFrame);
-  }*/
+    Log<RenderError>("Text program failed to link");
+
+    glDeleteProgram(textShader_);
+    textShader_ = NULL;
+
+    return false;
+  }
+
+  textGroupLocation_ = glGetUniformLocation(textShader_, "group");
+
+  return true;
+}
+
+/**
+* \brief  Draws a range of laid out text
+*
+* \param  vao    Vertex array holding the text's quads
+* \param  font   Font the range was laid out with
+* \param  first  First index to draw
+* \param  count  Number of indices to draw
+* \param  group  Transformation applied to every vertex
+*/
+void Renderer::drawText(GLuint vao, const Font & font, size_t first, size_t count, const glm::mat4 & group)
+{
+  if (textShader_ == NULL || count == 0)
+    return;
+
+  makeCurrent();
+
+  font.bind();
+
+  glUseProgram(textShader_);
+  glUniformMatrix4fv(textGroupLocation_, 1, GL_FALSE, &group[0][0]);
+
+  glBindVertexArray(vao);
+  glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, (void*)(first * sizeof(unsigned)));
+  glBindVertexArray(NULL);
+
+  font.unbind();
+}
+
+/**
+* \brief  Binds a surface and the draw program and sets the per draw uniforms
+*/
+void Renderer::useProgram(const DrawSurface * tex, const glm::mat4 & group)
+{
   bool textured = tex != nullptr;
 
-  // Bind textures before VAO
   if (textured)
     tex->bind();
 
-  glBindVertexArray(vaoID);
-
   glUseProgram(compShader_);
 
-  GLuint vbo;
-  GLuint faces;
+  glUniform1i(texturedLocation_, textured);
+  glUniform1ui(frameCountLocation_, textured ? static_cast<const Texture *>(tex)->FrameCount() : 1);
+  glUniformMatrix4fv(groupLocation_, 1, GL_FALSE, &group[0][0]);
+}
 
-  // Generate vertex buffer
-  glGenBuffers(1, &vbo);
-  glGenBuffers(1, &faces);
+/**
+* \brief  Frees the buffers uploaded for a mesh. Must be called before a mesh is
+*         destroyed or replaced.
+*/
+void Renderer::releaseMesh(const RMesh * mesh)
+{
+  auto it = meshBuffers_.find(mesh);
 
-  if (vbo != NULL && faces != NULL)
-  {
-    GLint texturedLocation = glGetUniformLocation(compShader_, "textured");
-    GLint transformLocation = glGetUniformLocation(compShader_, "transform");
-    GLint colorLocation = glGetUniformLocation(compShader_, "shade");
-    GLint cFrame = glGetUniformLocation(compShader_, "currFrame");
-    GLint frameCount = glGetUniformLocation(compShader_, "frameCount");
+  if (it == meshBuffers_.end())
+    return;
 
-    //GLint currFrameLocation = GSM::get().getColorShader().getUniformLocation("currFrame");
-    //GLint frameCountLocation = GSM::get().getColorShader().getUniformLocation("frameCount");
+  makeCurrent();
 
-    // Send whether the object is textured
-    glUniform1i(texturedLocation, textured);
+  glDeleteBuffers(1, &it->second.vbo);
+  glDeleteBuffers(1, &it->second.ibo);
+  glDeleteVertexArrays(1, &it->second.vao);
 
-    // Send vertex transform information
-    glUniformMatrix4fv(transformLocation, 1, GL_FALSE, &mat[0][0]);
+  meshBuffers_.erase(it);
+}
 
-    glUniform4f(colorLocation, shade.r, shade.g, shade.b, shade.a);
+/**
+* \brief  Uploads a mesh's vertices and indices if they aren't already
+*/
+Renderer::MeshBuffers & Renderer::uploadMesh(const RMesh & mesh)
+{
+  auto it = meshBuffers_.find(&mesh);
 
-    glUniform1ui(cFrame, currFrame);
-    glUniform1ui(frameCount, (tex != nullptr) ? static_cast<const Texture *>(tex)->FrameCount() : 1);
+  if (it != meshBuffers_.end())
+    return it->second;
 
-    // Bind vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  MeshBuffers buffers{ NULL, NULL, NULL, static_cast<GLsizei>(3 * mesh.tris.size()) };
 
-    // send color data
-    //glUniform3f(ucolor_, );
+  glGenBuffers(1, &buffers.vbo);
+  glGenBuffers(1, &buffers.ibo);
 
-    // Send vertex data
-    glBufferData(GL_ARRAY_BUFFER,
-      sizeof(Vertex) * mesh.verts.size(), &(mesh.verts[0]),
-      GL_STATIC_DRAW);
+  // Send vertex data
+  glBindBuffer(GL_ARRAY_BUFFER, buffers.vbo);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * mesh.verts.size(), &(mesh.verts[0]), GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, NULL);
 
+  // Indices are sent when the buffer is bound to a VAO
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffers.ibo);
+  glBufferData(GL_COPY_WRITE_BUFFER, mesh.tris.size() * sizeof(Tri),
+    (unsigned *)(&mesh.tris.front()), GL_STATIC_DRAW);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, NULL);
 
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
+  return meshBuffers_.insert(std::make_pair(&mesh, buffers)).first->second;
+}
 
-    glVertexAttribPointer(0,                                  // Which index to use ( We enabled Attrib Array # 0 )
-      2,                                  // We have 3 data points (x and y, z, w)
-      GL_FLOAT,                           // Which are floats
-      GL_FALSE,                           // We don't want points to be normalized
-      sizeof(Vertex),
-      (void*)offsetof(Vertex, point));    // We send the offset before the data points used (position) within the Vertex struct
+/**
+* \brief  Binds a mesh's vertex attributes and indices to the current VAO. Meshes
+*         must outlive any VAO they were bound to.
+*/
+void Renderer::bindMesh(const RMesh & mesh)
+{
+  MeshBuffers & buffers = uploadMesh(mesh);
+
+  glBindBuffer(GL_ARRAY_BUFFER, buffers.vbo);
+
+  setVertexLayout();
 
-                                          // Send color data GPU
-    glVertexAttribPointer(1,                                  // Which index to use ( We enabled Attrib Array # 1 )
-      4,                                  // We have 4 data points (r, g, b, and a)
-      GL_FLOAT,                           // Which are GL unsigned bytes
-      GL_FALSE,                            // We want points to be normalized
-      sizeof(Vertex),                     // We send data a vertex at a time (3 floats and 4 GLuints)
-      (void*)offsetof(Vertex, color));    // We send the offset before the data points used (color) within the Vertex struct
-    
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.ibo);
+  glBindBuffer(GL_ARRAY_BUFFER, NULL);
+}
+
+/**
+* \brief  Points the vertex attributes of the current VAO at the Vertex structs
+*         in the bound array buffer
+*/
+void Renderer::setVertexLayout()
+{
+  glEnableVertexAttribArray(0);
+  glEnableVertexAttribArray(1);
+  glEnableVertexAttribArray(2);
 
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, point));  // Position (x, y)
+  glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));  // Color (r, g, b, a)
+  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));     // Texture coordinates
+}
 
-    glVertexAttribPointer(2,                                  // Which index to use ( We enabled Attrib Array # 1 )
-      2,                                  // We have 4 data points (r, g, b, and a)
-      GL_FLOAT,                           // Which are GL unsigned bytes
-      GL_FALSE,                            // We want points to be normalized
-      sizeof(Vertex),                     // We send data a vertex at a time (3 floats and 4 GLuints)
-      (void*)offsetof(Vertex, uv));    // We send the offset before the data points used (color) within the Vertex struct
+/**
+* \brief  Gets the buffers for a mesh, setting up a VAO with its vertex and
+*         instance attributes the first time it is drawn
+*/
+const Renderer::MeshBuffers & Renderer::getBuffers(const RMesh & mesh)
+{
+  MeshBuffers & buffers = uploadMesh(mesh);
 
+  if (buffers.vao != NULL)
+    return buffers;
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, faces);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.tris.size() * sizeof(Tri),
-      (unsigned *)(&mesh.tris.front()), GL_STATIC_DRAW);
+  glGenVertexArrays(1, &buffers.vao);
+  glBindVertexArray(buffers.vao);
 
-    glDrawElements(drawMode, 3 * mesh.tris.size(), GL_UNSIGNED_INT, 0);
-    //glDrawArrays(drawMode, 0, mesh.verts.size());
+  bindMesh(mesh);
 
-    
+  // Per instance data, one matrix column per attribute
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer_);
 
-    if (textured)
-      tex->unbind();
+  for (GLuint col = 0; col < 4; ++col)
+  {
+    glEnableVertexAttribArray(3 + col);
+    glVertexAttribPointer(3 + col, 4, GL_FLOAT, GL_FALSE, sizeof(DrawInstance),
+      (void*)(offsetof(DrawInstance, transform) + col * sizeof(glm::vec4)));
+    glVertexAttribDivisor(3 + col, 1);
   }
 
-  glDeleteBuffers(1, &vbo);
-  glDeleteBuffers(1, &faces);
-  glDeleteVertexArrays(1, &vaoID);
+  glEnableVertexAttribArray(7);
+  glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(DrawInstance), (void*)offsetof(DrawInstance, shade));
+  glVertexAttribDivisor(7, 1);
+
+  glEnableVertexAttribArray(8);
+  glVertexAttribIPointer(8, 1, GL_UNSIGNED_INT, sizeof(DrawInstance), (void*)offsetof(DrawInstance, frame));
+  glVertexAttribDivisor(8, 1);
 
   glBindVertexArray(NULL);
+  glBindBuffer(GL_ARRAY_BUFFER, NULL);
+
+  return buffers;
 }
 
 void Renderer::swap(float r, float g, float b, float a)
@@ -318,6 +538,10 @@ bool Renderer::reloadShader()
   //  std::cout << &log.front() << std::endl;
   //}
 
+  texturedLocation_ = glGetUniformLocation(compShader_, "textured");
+  frameCountLocation_ = glGetUniformLocation(compShader_, "frameCount");
+  groupLocation_ = glGetUniformLocation(compShader_, "group");
+
   //sampler_ = glGetUniformLocation(compShader_, "diffuse");
 
   //aposition_ = glGetAttribLocation(compShader_, "position");
@@ -5,10 +5,23 @@
 // ---------------------------------------------------------------------------------
 #include "../include/Logger.h"
 #include "../include/Script.h"
-#include <fstream>
+#include "../include/EngineCounters.h"
+#include "../include/MemoryTracker.h"
+#include <sys/stat.h>
+#include <chrono>
+#include <algorithm>
 
 using namespace Logger;
 
+std::unordered_map<std::string, Sandbox::Chunk> Sandbox::chunks_;
+
+// Default garbage collection time per frame (seconds)
+static const double GC_DEFAULT_BUDGET = 0.001;
+// Work done by a single collector step. Roughly KB of allocations
+static const int GC_STEP_SIZE = 16;
+// Heap growth over the last finished cycle that forces a full collection
+static const int GC_EMERGENCY_GROWTH = 4;
+
 // Script logging levels and functions
 struct ScriptInfo : Info
 {
@@ -31,15 +44,63 @@ int lua_logger(const char *strng)
   return Log<T>(strng);
 }
 
+// Cached replacement for loadfile. Returns the compiled chunk, or nil and an 
+// error message on failure
+static int lua_loadchunk(lua_State * L)
+{
+  const char * file = luaL_checkstring(L, 1);
+
+  if (Sandbox::LoadChunk(L, file))
+    return 1;
+
+  lua_pushnil(L);
+  lua_insert(L, -2);
+  return 2;
+}
+
+// lua_dump writer, appends the dumped bytecode onto a string
+static int chunk_writer(lua_State *, const void * data, size_t size, void * out)
+{
+  static_cast<std::string *>(out)->append(static_cast<const char *>(data), size);
+  return 0;
+}
+
+
+// Lua heap allocator, so script memory is counted under scripting no matter
+// which system runs the script
+static void * lua_alloc(void *, void * ptr, size_t, size_t nsize)
+{
+  using Engine::MemoryTracker;
+
+  if (nsize == 0)
+  {
+    MemoryTracker::Free(ptr);
+    return nullptr;
+  }
+
+  return MemoryTracker::Reallocate(ptr, nsize, Engine::MemoryTag::Scripting);
+}
+
+// Same as the panic function luaL_newstate sets
+static int lua_panic(lua_State * L)
+{
+  Log<ScriptError>("Unprotected error in call to Lua API (%s)", lua_tostring(L, -1));
+  return 0;
+}
 
 // Sandbox 
 Sandbox::Sandbox(const std::string & source) :
-  source_(source), state_(luaL_newstate())
+  source_(source), state_(lua_newstate(lua_alloc, nullptr)), 
+  gcBudget_(GC_DEFAULT_BUDGET), gcScaled_(false), gcBaseKB_(0)
 {
   using namespace luabind;
 
+  lua_atpanic(state_, lua_panic);
   luaL_openlibs(state_);
   open(state_);
+
+  // Collection is driven by update so it can't land in the middle of a frame
+  lua_gc(state_, LUA_GCSTOP, 0);
   
   module(state_)[
     namespace_("log")[
@@ -63,6 +124,7 @@ Sandbox::Sandbox(const std::string & source) :
         .def_readwrite("env", &Script::env)
   ];
 
+  lua_register(state_, "loadchunk", &lua_loadchunk);
 }
 
 Sandbox::~Sandbox()
@@ -76,9 +138,125 @@ void Sandbox::start()
     Log<Error>(lua_tostring(state_, -1));
 }
 
-void Sandbox::update(float dt)
+void Sandbox::snapshotState()
+{
+  try
+  {
+    luabind::call_function<void>(state_, "snapshotState");
+  }
+  catch (const std::exception & err)
+  {
+    Log<Error>(err.what());
+  }
+}
+
+/****************************************************************************/
+/*!
+  \brief
+    Seeds lua's math.random, which scripts draw from through the environment
+
+  \param seed
+    Seed to use
+*/
+/****************************************************************************/
+void Sandbox::seedRandom(unsigned seed)
+{
+  lua_getglobal(state_, "math");
+  lua_getfield(state_, -1, "randomseed");
+  // randomseed takes an int, keep the seed in range
+  lua_pushinteger(state_, static_cast<lua_Integer>(seed & 0x7fffffff));
+
+  if (lua_pcall(state_, 1, 0, 0))
+  {
+    Log<Error>(lua_tostring(state_, -1));
+    lua_pop(state_, 1);
+  }
+
+  lua_pop(state_, 1);
+}
+
+/****************************************************************************/
+/*!
+  \brief
+    Bursts all waiting scripts, then steps the garbage collector within the
+    sandbox's per frame budget
+
+  \param dt
+    Frame time
+
+  \param frameTimeLeft
+    Seconds left in the current frame. Only used if the GC budget is scaled
+    to the frame, ignored if negative
+*/
+/****************************************************************************/
+void Sandbox::update(float dt, double frameTimeLeft)
 {
   luabind::call_function<void>(state_, "update", dt);
+
+  stepCollector(frameTimeLeft);
+}
+
+/****************************************************************************/
+/*!
+  \brief
+    Sets how long the garbage collector may run each frame
+
+  \param seconds
+    Time budget for collection each frame
+
+  \param scaleToFrame
+    If true, the budget grows or shrinks with the time left in the frame
+*/
+/****************************************************************************/
+void Sandbox::setGCBudget(double seconds, bool scaleToFrame)
+{
+  gcBudget_ = seconds;
+  gcScaled_ = scaleToFrame;
+}
+
+void Sandbox::stepCollector(double frameTimeLeft)
+{
+  using namespace std::chrono;
+  using namespace Engine;
+
+  double budget = gcBudget_;
+
+  // Use up to half of whatever is left in the frame, but never starve the 
+  // collector completely or it will fall behind the allocations
+  if (gcScaled_ && frameTimeLeft >= 0)
+    budget = std::max(gcBudget_ * 0.25, std::min(frameTimeLeft * 0.5, gcBudget_ * 4));
+
+  auto start = steady_clock::now();
+  double elapsed = 0;
+
+  // Garbage is being made faster than it's collected, catch up now
+  if (gcBaseKB_ && lua_gc(state_, LUA_GCCOUNT, 0) > gcBaseKB_ * GC_EMERGENCY_GROWTH)
+  {
+    lua_gc(state_, LUA_GCCOLLECT, 0);
+    gcBaseKB_ = lua_gc(state_, LUA_GCCOUNT, 0);
+  }
+  else
+  {
+    do
+    {
+      // Returns 1 when a cycle finishes
+      if (lua_gc(state_, LUA_GCSTEP, GC_STEP_SIZE))
+      {
+        gcBaseKB_ = lua_gc(state_, LUA_GCCOUNT, 0);
+        break;
+      }
+
+      elapsed = duration<double>(steady_clock::now() - start).count();
+    } while (elapsed < budget);
+  }
+
+  // Stepping restarts the automatic collector in 5.1, stop it again
+  lua_gc(state_, LUA_GCSTOP, 0);
+
+  elapsed = duration<double>(steady_clock::now() - start).count();
+
+  EngineCounters::Add("Lua heap (KB)", lua_gc(state_, LUA_GCCOUNT, 0) + lua_gc(state_, LUA_GCCOUNTB, 0) / 1024.0);
+  EngineCounters::Add("Lua GC time (ms)", elapsed * 1000.0);
 }
 
 void Sandbox::unloadScript(SCRIPT_PTR script)
@@ -86,6 +264,97 @@ void Sandbox::unloadScript(SCRIPT_PTR script)
   luabind::call_function<void>(state_, "unloadScript", script.get());
 }
 
+/****************************************************************************/
+/*!
+  \brief
+    Pushes a freshly loaded function for the given script file onto the lua 
+    stack. The file is only parsed the first time it is requested (or when 
+    it has been modified since), after that the function is loaded back 
+    from its cached bytecode
+
+  \param L
+    Lua state to load the chunk into
+
+  \param file
+    Path of the script to load
+
+  \return
+    True if the chunk was loaded. On failure the error message is left on
+    the stack instead
+*/
+/****************************************************************************/
+bool Sandbox::LoadChunk(lua_State * L, const std::string & file)
+{
+  time_t modified;
+
+  if (!GetModifiedTime(file, modified))
+  {
+    lua_pushfstring(L, "cannot open %s", file.c_str());
+    return false;
+  }
+
+  auto found = chunks_.find(file);
+
+  if (found != chunks_.end() && found->second.modified == modified)
+  {
+    const std::string & code = found->second.bytecode;
+    return luaL_loadbuffer(L, code.data(), code.size(), ("@" + file).c_str()) == 0;
+  }
+
+  // Not compiled yet or out of date, parse the source
+  if (luaL_loadfile(L, file.c_str()) != 0)
+    return false;
+
+  Chunk & chunk = chunks_[file];
+  chunk.modified = modified;
+  chunk.bytecode.clear();
+
+  lua_dump(L, &chunk_writer, &chunk.bytecode);
+
+  return true;
+}
+
+/****************************************************************************/
+/*!
+  \brief
+    Checks if a script file exists without opening it
+
+  \param file
+    Path of the script
+
+  \return
+    True if the file has been compiled before or can be found on disk
+*/
+/****************************************************************************/
+bool Sandbox::ChunkExists(const std::string & file)
+{
+  time_t modified;
+
+  return chunks_.count(file) || GetModifiedTime(file, modified);
+}
+
+/****************************************************************************/
+/*!
+  \brief
+    Frees all cached chunks, forcing scripts to be recompiled on next load
+*/
+/****************************************************************************/
+void Sandbox::FlushChunks()
+{
+  chunks_.clear();
+}
+
+bool Sandbox::GetModifiedTime(const std::string & file, time_t & modified)
+{
+  struct stat info;
+
+  if (stat(file.c_str(), &info) != 0)
+    return false;
+
+  modified = info.st_mtime;
+  return true;
+}
+
 Script::Script(int scriptIndex, std::string src) :
 index(scriptIndex), file_(src), disabled_(false), 
 waiting_(true), waitTime_(0), elapsedTime_(0)
@@ -8,8 +8,8 @@
 namespace Engine
 {
   // Listeners
-  ScriptListener::ScriptListener(ScriptEvent * scriptEvent_, luabind::object _callFunction) :
-    callFunction(_callFunction), scriptEvent(scriptEvent_)
+  ScriptListener::ScriptListener(ScriptEvent * scriptEvent_, luabind::object _callFunction, ListenMode _mode) :
+    callFunction(_callFunction), mode(_mode), scriptEvent(scriptEvent_)
   {}
 
   ScriptListener::~ScriptListener()
@@ -26,8 +26,12 @@ namespace Engine
     }
   }
 
+  // Delivers the messages held this frame to batched and latest-only listeners
   void ScriptEvent::push()
   {
+    // Nothing was posted for deferred listeners this frame
+    if (totalObjects_ == 0 && !hasLatest_)
+      return;
 
     auto iter = listeners_.begin();
 
@@ -37,18 +41,30 @@ namespace Engine
         iter = listeners_.erase(iter);
       else
       {
-        luabind::call_function<void>(L, "pushEvent", iter->lock()->callFunction, dataTable);
+        SCRIPT_LISTENER_PTR listener = iter->lock();
+
+        if (listener->mode == ListenMode::Batched && totalObjects_ > 0)
+          luabind::call_function<void>(L, "pushEvent", listener->callFunction, dataTable);
+        else if (listener->mode == ListenMode::Latest && hasLatest_)
+          luabind::call_function<void>(L, "pushEvent", listener->callFunction, latest_);
+
         ++iter;
       }
     }
 
-    dataTable = luabind::newtable(L);
-    totalObjects_ = 0;
+    if (totalObjects_ > 0)
+    {
+      dataTable = luabind::newtable(L);
+      totalObjects_ = 0;
+    }
+
+    latest_ = luabind::object();
+    hasLatest_ = false;
   }
 
-  SCRIPT_LISTENER_PTR ScriptEvent::connect(luabind::object obj)
+  SCRIPT_LISTENER_PTR ScriptEvent::connect(luabind::object obj, ListenMode mode)
   {
-    SCRIPT_LISTENER_PTR ev(new ScriptListener(this, obj));
+    SCRIPT_LISTENER_PTR ev(new ScriptListener(this, obj, mode));
 
     listeners_.push_back(ev);
 
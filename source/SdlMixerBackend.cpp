@@ -0,0 +1,723 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "../include/SdlMixerBackend.h"
+#include "../include/Logger.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define AUDIO_SSE
+#endif
+
+using std::string;
+using namespace Logger;
+
+namespace
+{
+  const int MIX_RATE = 44100;
+  const size_t STREAM_CHUNK = 4096;         // Source frames decoded at a time.
+  const size_t STREAM_BUFFER = 1 << 15;     // Frames buffered ahead per streamed voice.
+
+  uint16_t ReadU16( const unsigned char* p )
+  {
+    return static_cast<uint16_t>( p[0] | ( p[1] << 8 ) );
+  }
+
+  uint32_t ReadU32( const unsigned char* p )
+  {
+    return static_cast<uint32_t>( p[0] ) | ( static_cast<uint32_t>( p[1] ) << 8 ) |
+           ( static_cast<uint32_t>( p[2] ) << 16 ) | ( static_cast<uint32_t>( p[3] ) << 24 );
+  }
+
+  /*! \brief
+   * Reads a WAV header and leaves the file at the start of the samples.
+   * \return
+   * False if it isn't a WAV file this mixer can play.
+   */
+  bool ReadWavFormat( FILE* pFile, SdlMixerBackend::WavFormat& format )
+  {
+    unsigned char header[12];
+    if ( fread( header, 1, 12, pFile ) != 12 || memcmp( header, "RIFF", 4 ) || memcmp( header + 8, "WAVE", 4 ) )
+    {
+      return false;
+    }
+
+    bool bHaveFormat = false;
+    unsigned char chunk[8];
+    while ( fread( chunk, 1, 8, pFile ) == 8 )
+    {
+      uint32_t nSize = ReadU32( chunk + 4 );
+      long lNext = ftell( pFile ) + static_cast<long>( nSize + ( nSize & 1 ) );
+
+      if ( !memcmp( chunk, "fmt ", 4 ) )
+      {
+        unsigned char fmt[26] = { 0 };
+        size_t nRead = fread( fmt, 1, std::min<size_t>( nSize, sizeof( fmt ) ), pFile );
+        if ( nRead < 16 )
+        {
+          return false;
+        }
+
+        uint16_t nTag = ReadU16( fmt );
+        // WAVE_FORMAT_EXTENSIBLE keeps the real format in its sub format.
+        if ( nTag == 0xFFFE && nRead >= 26 )
+        {
+          nTag = ReadU16( fmt + 24 );
+        }
+        format.nChannels = ReadU16( fmt + 2 );
+        format.nRate = static_cast<int>( ReadU32( fmt + 4 ) );
+        format.nBits = ReadU16( fmt + 14 );
+        format.bFloat = nTag == 3;
+        bHaveFormat = ( nTag == 1 && ( format.nBits == 8 || format.nBits == 16 || format.nBits == 24 ) ) ||
+                      ( nTag == 3 && format.nBits == 32 );
+        bHaveFormat = bHaveFormat && format.nChannels > 0 && format.nRate > 0;
+      }
+      else if ( !memcmp( chunk, "data", 4 ) )
+      {
+        // Don't trust the size past the end of the file.
+        format.lDataStart = ftell( pFile );
+        fseek( pFile, 0, SEEK_END );
+        long lEnd = ftell( pFile );
+        fseek( pFile, format.lDataStart, SEEK_SET );
+        format.nDataBytes = std::min<uint32_t>( nSize, static_cast<uint32_t>( std::max( 0L, lEnd - format.lDataStart ) ) );
+        return bHaveFormat;
+      }
+
+      fseek( pFile, lNext, SEEK_SET );
+    }
+    return false;
+  }
+
+  /*! \brief
+   * Turns raw WAV frames into stereo floats. Mono is copied to both sides,
+   * anything past the second channel is dropped.
+   * \param vOut
+   * Gets the frames added to its end.
+   */
+  void DecodeFrames( const unsigned char* pRaw, size_t nFrames, const SdlMixerBackend::WavFormat& format, std::vector<float>& vOut )
+  {
+    size_t nBytes = format.nBits / 8;
+    size_t nFrameBytes = nBytes * format.nChannels;
+    size_t nStart = vOut.size();
+    vOut.resize( nStart + nFrames * 2 );
+    float* pOut = &vOut[0] + nStart;
+
+    for ( size_t i = 0; i < nFrames; ++i )
+    {
+      const unsigned char* pFrame = pRaw + i * nFrameBytes;
+      float side[2];
+      for ( int c = 0; c < 2; ++c )
+      {
+        const unsigned char* p = pFrame + ( c < format.nChannels ? c : 0 ) * nBytes;
+        switch ( format.nBits )
+        {
+        case 8:
+          side[c] = ( static_cast<int>( p[0] ) - 128 ) / 128.0f;
+          break;
+        case 16:
+          side[c] = static_cast<int16_t>( ReadU16( p ) ) / 32768.0f;
+          break;
+        case 24:
+          side[c] = static_cast<int32_t>( ( static_cast<uint32_t>( p[0] ) << 8 ) | ( static_cast<uint32_t>( p[1] ) << 16 ) |
+                                          ( static_cast<uint32_t>( p[2] ) << 24 ) ) / 2147483648.0f;
+          break;
+        default:
+          {
+            uint32_t nBits = ReadU32( p );
+            memcpy( &side[c], &nBits, sizeof( float ) );
+          }
+          break;
+        }
+      }
+      pOut[i * 2] = side[0];
+      pOut[i * 2 + 1] = side[1];
+    }
+  }
+
+  /*! \brief
+   * Linear resampler for stereo floats that can be fed a piece at a time.
+   */
+  struct Resampler
+  {
+    explicit Resampler( double dStep ) : mdStep( dStep ), mdPos( 1.0 ), mbPrimed( false )
+    {
+      mfLast[0] = mfLast[1] = 0.0f;
+    }
+
+    void Run( const std::vector<float>& vIn, std::vector<float>& vOut )
+    {
+      size_t nIn = vIn.size() / 2;
+      if ( mdStep == 1.0 )
+      {
+        vOut.insert( vOut.end(), vIn.begin(), vIn.end() );
+        return;
+      }
+      if ( !nIn )
+      {
+        return;
+      }
+      if ( !mbPrimed )
+      {
+        mfLast[0] = vIn[0];
+        mfLast[1] = vIn[1];
+        mbPrimed = true;
+      }
+
+      // Frame 0 is the last frame of the previous piece, frame i is vIn[i - 1].
+      while ( mdPos < nIn )
+      {
+        size_t i = static_cast<size_t>( mdPos );
+        float t = static_cast<float>( mdPos - i );
+        const float* a = i ? &vIn[( i - 1 ) * 2] : mfLast;
+        const float* b = &vIn[i * 2];
+        vOut.push_back( a[0] + ( b[0] - a[0] ) * t );
+        vOut.push_back( a[1] + ( b[1] - a[1] ) * t );
+        mdPos += mdStep;
+      }
+      mdPos -= nIn;
+      mfLast[0] = vIn[( nIn - 1 ) * 2];
+      mfLast[1] = vIn[( nIn - 1 ) * 2 + 1];
+    }
+
+    double mdStep;   // Source frames per output frame.
+    double mdPos;
+    float mfLast[2];
+    bool mbPrimed;
+  };
+
+  /*! \brief
+   * Adds a buffer into the mix at the given gain.
+   */
+  void MixInto( float* pOut, const float* pIn, size_t nSamples, float fGain )
+  {
+    size_t i = 0;
+#ifdef AUDIO_SSE
+    __m128 gain = _mm_set1_ps( fGain );
+    for ( ; i + 4 <= nSamples; i += 4 )
+    {
+      __m128 mixed = _mm_add_ps( _mm_loadu_ps( pOut + i ), _mm_mul_ps( _mm_loadu_ps( pIn + i ), gain ) );
+      _mm_storeu_ps( pOut + i, mixed );
+    }
+#endif
+    for ( ; i < nSamples; ++i )
+    {
+      pOut[i] += pIn[i] * fGain;
+    }
+  }
+
+  /*! \brief
+   * Keeps the finished mix between -1 and 1.
+   */
+  void ClampMix( float* pOut, size_t nSamples )
+  {
+    size_t i = 0;
+#ifdef AUDIO_SSE
+    __m128 lo = _mm_set1_ps( -1.0f );
+    __m128 hi = _mm_set1_ps( 1.0f );
+    for ( ; i + 4 <= nSamples; i += 4 )
+    {
+      _mm_storeu_ps( pOut + i, _mm_max_ps( lo, _mm_min_ps( hi, _mm_loadu_ps( pOut + i ) ) ) );
+    }
+#endif
+    for ( ; i < nSamples; ++i )
+    {
+      pOut[i] = std::max( -1.0f, std::min( 1.0f, pOut[i] ) );
+    }
+  }
+}
+
+/**********************************************************************/
+/**********************************************************************/
+/*! \brief
+ * One voice's worth of a streamed sound. Update decodes into a ring the
+ * mixer reads from; the two sides never wait on each other.
+ */
+class SdlMixerBackend::Stream
+{
+  public:
+    Stream( const Sample& sample, int nDeviceRate ) : mpFile( NULL ), mFormat( sample.mFormat ),
+      mbLooping( sample.mbLooping ), mnBytesLeft( 0 ),
+      mResampler( static_cast<double>( sample.mFormat.nRate ) / nDeviceRate ),
+      mvRing( STREAM_BUFFER * 2 ), mnRead( 0 ), mnWrite( 0 ), mbEnded( false )
+    {
+      mpFile = fopen( sample.mstrPath.c_str(), "rb" );
+      Rewind();
+    }
+
+    ~Stream()
+    {
+      if ( mpFile )
+      {
+        fclose( mpFile );
+      }
+    }
+
+    bool IsOpen() const { return mpFile != NULL; }
+
+    /*! \brief
+     * Decodes until the ring is full or the file runs out. Audio thread only.
+     */
+    void Fill()
+    {
+      size_t nFrameBytes = mFormat.nChannels * ( mFormat.nBits / 8 );
+      // Low rates resample into many more frames, so the chunk is cut down
+      // until a whole resampled chunk still fits in the ring.
+      size_t nChunk = std::max<size_t>( 1, std::min<size_t>( STREAM_CHUNK,
+        static_cast<size_t>( ( STREAM_BUFFER - 2 ) * mResampler.mdStep ) ) );
+      // Room for a whole decoded chunk, with a frame to spare for rounding.
+      size_t nNeeded = static_cast<size_t>( nChunk / mResampler.mdStep ) + 2;
+
+      while ( !mbEnded.load( std::memory_order_relaxed ) &&
+              STREAM_BUFFER - ( mnWrite.load( std::memory_order_relaxed ) - mnRead.load( std::memory_order_acquire ) ) >= nNeeded )
+      {
+        if ( !mnBytesLeft && !( mbLooping && Rewind() ) )
+        {
+          mbEnded.store( true, std::memory_order_release );
+          break;
+        }
+
+        size_t nFrames = std::min<size_t>( nChunk, mnBytesLeft / nFrameBytes );
+        mvRaw.resize( nFrames * nFrameBytes );
+        size_t nRead = nFrames ? fread( &mvRaw[0], 1, mvRaw.size(), mpFile ) / nFrameBytes : 0;
+        // A short read means the file is shorter than its header says.
+        mnBytesLeft = nRead && nRead == nFrames ? mnBytesLeft - static_cast<unsigned>( nRead * nFrameBytes ) : 0;
+
+        mvDecoded.clear();
+        mvResampled.clear();
+        if ( nRead )
+        {
+          DecodeFrames( &mvRaw[0], nRead, mFormat, mvDecoded );
+        }
+        mResampler.Run( mvDecoded, mvResampled );
+        Write( mvResampled );
+      }
+    }
+
+    /*! \brief
+     * Takes decoded frames out of the ring. Mixer only.
+     * \return
+     * Frames actually read.
+     */
+    size_t Read( float* pOut, size_t nFrames )
+    {
+      size_t nRead = mnRead.load( std::memory_order_relaxed );
+      size_t nAvailable = mnWrite.load( std::memory_order_acquire ) - nRead;
+      nFrames = std::min( nFrames, nAvailable );
+      for ( size_t i = 0; i < nFrames; ++i )
+      {
+        size_t n = ( ( nRead + i ) & ( STREAM_BUFFER - 1 ) ) * 2;
+        pOut[i * 2] = mvRing[n];
+        pOut[i * 2 + 1] = mvRing[n + 1];
+      }
+      mnRead.store( nRead + nFrames, std::memory_order_release );
+      return nFrames;
+    }
+
+    // Nothing more is coming, so running dry means the sound is over.
+    bool IsDone() const { return mbEnded.load( std::memory_order_acquire ); }
+
+  private:
+    bool Rewind()
+    {
+      mnBytesLeft = 0;
+      if ( !mpFile || fseek( mpFile, mFormat.lDataStart, SEEK_SET ) )
+      {
+        return false;
+      }
+      mnBytesLeft = mFormat.nDataBytes;
+      return mnBytesLeft != 0;
+    }
+
+    void Write( const std::vector<float>& vFrames )
+    {
+      size_t nWrite = mnWrite.load( std::memory_order_relaxed );
+      size_t nFrames = vFrames.size() / 2;
+      for ( size_t i = 0; i < nFrames; ++i )
+      {
+        size_t n = ( ( nWrite + i ) & ( STREAM_BUFFER - 1 ) ) * 2;
+        mvRing[n] = vFrames[i * 2];
+        mvRing[n + 1] = vFrames[i * 2 + 1];
+      }
+      mnWrite.store( nWrite + nFrames, std::memory_order_release );
+    }
+
+    FILE* mpFile;
+    WavFormat mFormat;
+    bool mbLooping;
+    unsigned mnBytesLeft;
+    Resampler mResampler;
+
+    std::vector<unsigned char> mvRaw;
+    std::vector<float> mvDecoded;
+    std::vector<float> mvResampled;
+
+    std::vector<float> mvRing;
+    std::atomic<size_t> mnRead;   // Frames read so far. Written by the mixer.
+    std::atomic<size_t> mnWrite;  // Frames written so far. Written by Fill.
+    std::atomic<bool> mbEnded;
+};
+
+/**********************************************************************/
+/**********************************************************************/
+
+SdlMixerBackend::SdlMixerBackend() : mbSdlStarted(false), mDevice(0)
+{
+  SDL_zero( mSpec );
+  for ( int i = 0; i < AUDIO_MAX_VOICES; ++i )
+  {
+    std::vector<Stream*> vNone;
+    ClearVoice( mVoices[i], vNone );
+  }
+}
+
+SdlMixerBackend::~SdlMixerBackend()
+{
+  // Closing the device stops the mixer, so the voices are safe to touch.
+  if ( mDevice )
+  {
+    SDL_CloseAudioDevice( mDevice );
+  }
+  for ( int i = 0; i < AUDIO_MAX_VOICES; ++i )
+  {
+    delete mVoices[i].mpStream;
+  }
+  if ( mbSdlStarted )
+  {
+    SDL_QuitSubSystem( SDL_INIT_AUDIO );
+  }
+}
+
+/*! \brief
+ * Opens the default audio device as 44.1kHz stereo floats and starts the
+ * mixer.
+ * \return
+ * False if there is no device to play on.
+ */
+bool SdlMixerBackend::Init()
+{
+  if ( SDL_InitSubSystem( SDL_INIT_AUDIO ) )
+  {
+    Log<Error>("Couldn't start SDL audio: %s", SDL_GetError());
+    return false;
+  }
+  mbSdlStarted = true;
+
+  SDL_AudioSpec want;
+  SDL_zero( want );
+  want.freq = MIX_RATE;
+  want.format = AUDIO_F32SYS;
+  want.channels = 2;
+  want.samples = 512;
+  want.callback = MixCallback;
+  want.userdata = this;
+
+  // No changes allowed, SDL converts if the hardware wants something else.
+  mDevice = SDL_OpenAudioDevice( NULL, 0, &want, &mSpec, 0 );
+  if ( !mDevice )
+  {
+    Log<Error>("Couldn't open an audio device: %s", SDL_GetError());
+    return false;
+  }
+
+  mScratch.resize( mSpec.samples * 2 );
+  SDL_PauseAudioDevice( mDevice, 0 );
+  return true;
+}
+
+/*! \brief
+ * Keeps streamed voices fed and collects voices the mixer has finished.
+ */
+void SdlMixerBackend::Update()
+{
+  // Only this thread changes mpStream, so reading it unlocked is fine.
+  for ( int i = 0; i < AUDIO_MAX_VOICES; ++i )
+  {
+    if ( mVoices[i].mpStream )
+    {
+      mVoices[i].mpStream->Fill();
+    }
+  }
+
+  std::vector<Stream*> vStreams;
+  SDL_LockAudioDevice( mDevice );
+  for ( int i = 0; i < AUDIO_MAX_VOICES; ++i )
+  {
+    if ( mVoices[i].mpSample && mVoices[i].mbFinished )
+    {
+      ClearVoice( mVoices[i], vStreams );
+      mFinished.push_back( i );
+    }
+  }
+  SDL_UnlockAudioDevice( mDevice );
+
+  for ( size_t i = 0; i < vStreams.size(); ++i )
+  {
+    delete vStreams[i];
+  }
+}
+
+/*! \brief
+ * Reads a WAV file. Whole sounds are decoded now, streamed ones only have
+ * their header checked.
+ * \param hSound
+ * Handle the sound will be known by.
+ * \param strPath
+ * File to open.
+ * \param bLooping
+ * Loads the sounds as a loop.
+ * \param bStream
+ * Decode the file while it plays instead of all at once.
+ */
+void SdlMixerBackend::OpenSound( SoundHandle hSound, const string& strPath, bool /*b3d*/, bool bLooping, bool bStream )
+{
+  if ( hSound >= static_cast<SoundHandle>( mSamples.size() ) )
+  {
+    mSamples.resize( hSound + 1 );
+  }
+
+  std::unique_ptr<Sample> pSample( new Sample );
+  pSample->mstrPath = strPath;
+  pSample->mbLooping = bLooping;
+  pSample->mbStream = bStream;
+
+  FILE* pFile = fopen( strPath.c_str(), "rb" );
+  bool bOk = pFile && ReadWavFormat( pFile, pSample->mFormat );
+
+  if ( bOk && !bStream )
+  {
+    const WavFormat& format = pSample->mFormat;
+    size_t nFrameBytes = format.nChannels * ( format.nBits / 8 );
+    std::vector<unsigned char> vRaw( format.nDataBytes );
+    size_t nFrames = vRaw.empty() ? 0 : fread( &vRaw[0], 1, vRaw.size(), pFile ) / nFrameBytes;
+
+    std::vector<float> vDecoded;
+    if ( nFrames )
+    {
+      DecodeFrames( &vRaw[0], nFrames, format, vDecoded );
+    }
+    Resampler resampler( static_cast<double>( format.nRate ) / mSpec.freq );
+    resampler.Run( vDecoded, pSample->mvFrames );
+  }
+
+  if ( pFile )
+  {
+    fclose( pFile );
+  }
+
+  if ( !bOk )
+  {
+    Log<Error>("Couldn't read WAV file: %s", strPath.c_str());
+    mFailed.push_back( hSound );
+    return;
+  }
+
+  ReleaseSound( hSound );
+  mSamples[hSound] = std::move( pSample );
+  mReady.push_back( hSound );
+}
+
+/*! \brief
+ * Throws away a sound, stopping anything still playing it.
+ */
+void SdlMixerBackend::ReleaseSound( SoundHandle hSound )
+{
+  if ( hSound >= static_cast<SoundHandle>( mSamples.size() ) || !mSamples[hSound] )
+  {
+    return;
+  }
+
+  std::vector<Stream*> vStreams;
+  SDL_LockAudioDevice( mDevice );
+  for ( int i = 0; i < AUDIO_MAX_VOICES; ++i )
+  {
+    if ( mVoices[i].mpSample == mSamples[hSound].get() )
+    {
+      ClearVoice( mVoices[i], vStreams );
+    }
+  }
+  SDL_UnlockAudioDevice( mDevice );
+
+  for ( size_t i = 0; i < vStreams.size(); ++i )
+  {
+    delete vStreams[i];
+  }
+  mSamples[hSound].reset();
+}
+
+void SdlMixerBackend::PollSounds( std::vector<SoundHandle>& vReady, std::vector<SoundHandle>& vFailed )
+{
+  vReady.insert( vReady.end(), mReady.begin(), mReady.end() );
+  vFailed.insert( vFailed.end(), mFailed.begin(), mFailed.end() );
+  mReady.clear();
+  mFailed.clear();
+}
+
+/*! \brief
+ * Starts a sound on a voice. Streamed sounds are given their first piece
+ * before the mixer sees them.
+ * \return
+ * False if the sound isn't loaded or its file can't be opened again.
+ */
+bool SdlMixerBackend::StartVoice( int nVoice, SoundHandle hSound, float fVolumedB, int /*nPriority*/, bool bPaused, const Vector3& /*vPosition*/ )
+{
+  StopVoice( nVoice );
+
+  if ( hSound >= static_cast<SoundHandle>( mSamples.size() ) || !mSamples[hSound] )
+  {
+    return false;
+  }
+
+  const Sample* pSample = mSamples[hSound].get();
+  Stream* pStream = NULL;
+  if ( pSample->mbStream )
+  {
+    pStream = new Stream( *pSample, mSpec.freq );
+    if ( !pStream->IsOpen() )
+    {
+      delete pStream;
+      return false;
+    }
+    pStream->Fill();
+  }
+
+  SDL_LockAudioDevice( mDevice );
+  Voice& voice = mVoices[nVoice];
+  voice.mpSample = pSample;
+  voice.mpStream = pStream;
+  voice.mnFrame = 0;
+  voice.mfGain = dbToVolume( fVolumedB );
+  voice.mbPaused = bPaused;
+  voice.mbFinished = false;
+  SDL_UnlockAudioDevice( mDevice );
+  return true;
+}
+
+/*! \brief
+ * Stops a voice without reporting it as finished.
+ */
+void SdlMixerBackend::StopVoice( int nVoice )
+{
+  std::vector<Stream*> vStreams;
+  SDL_LockAudioDevice( mDevice );
+  ClearVoice( mVoices[nVoice], vStreams );
+  SDL_UnlockAudioDevice( mDevice );
+
+  for ( size_t i = 0; i < vStreams.size(); ++i )
+  {
+    delete vStreams[i];
+  }
+}
+
+void SdlMixerBackend::SetVoiceVolume( int nVoice, float fVolumedB )
+{
+  float fGain = dbToVolume( fVolumedB );
+  SDL_LockAudioDevice( mDevice );
+  mVoices[nVoice].mfGain = fGain;
+  SDL_UnlockAudioDevice( mDevice );
+}
+
+void SdlMixerBackend::SetVoicePaused( int nVoice, bool bPaused )
+{
+  SDL_LockAudioDevice( mDevice );
+  mVoices[nVoice].mbPaused = bPaused;
+  SDL_UnlockAudioDevice( mDevice );
+}
+
+void SdlMixerBackend::PollFinished( std::vector<int>& vVoices )
+{
+  vVoices.insert( vVoices.end(), mFinished.begin(), mFinished.end() );
+  mFinished.clear();
+}
+
+/*! \brief
+ * Frees a voice. The device must be locked; the voice's stream is handed
+ * back to be deleted once it isn't.
+ */
+void SdlMixerBackend::ClearVoice( Voice& voice, std::vector<Stream*>& vStreams )
+{
+  if ( voice.mpStream )
+  {
+    vStreams.push_back( voice.mpStream );
+  }
+  voice.mpSample = NULL;
+  voice.mpStream = NULL;
+  voice.mnFrame = 0;
+  voice.mfGain = 1.0f;
+  voice.mbPaused = false;
+  voice.mbFinished = false;
+}
+
+void SDLCALL SdlMixerBackend::MixCallback( void* pUserData, Uint8* pStream, int nBytes )
+{
+  static_cast<SdlMixerBackend*>( pUserData )->Mix( reinterpret_cast<float*>( pStream ), nBytes / static_cast<int>( 2 * sizeof( float ) ) );
+}
+
+/*! \brief
+ * Mixes every playing voice into the device's buffer. Runs on SDL's audio
+ * thread with the device locked.
+ */
+void SdlMixerBackend::Mix( float* pOut, int nFrames )
+{
+  std::fill( pOut, pOut + nFrames * 2, 0.0f );
+
+  for ( int v = 0; v < AUDIO_MAX_VOICES; ++v )
+  {
+    Voice& voice = mVoices[v];
+    if ( !voice.mpSample || voice.mbPaused || voice.mbFinished )
+    {
+      continue;
+    }
+
+    if ( voice.mpStream )
+    {
+      // Read through the scratch buffer a piece at a time.
+      size_t nMaxFrames = mScratch.size() / 2;
+      for ( size_t nDone = 0; nDone < static_cast<size_t>( nFrames ); )
+      {
+        size_t nWant = std::min( nMaxFrames, nFrames - nDone );
+        // Checked first, so a stream that ends mid read still gets played out.
+        bool bDone = voice.mpStream->IsDone();
+        size_t nGot = voice.mpStream->Read( &mScratch[0], nWant );
+        MixInto( pOut + nDone * 2, &mScratch[0], nGot * 2, voice.mfGain );
+        nDone += nGot;
+        // Came up short: either the sound is over, or Fill fell behind.
+        if ( nGot < nWant )
+        {
+          voice.mbFinished = bDone;
+          break;
+        }
+      }
+      continue;
+    }
+
+    const std::vector<float>& vFrames = voice.mpSample->mvFrames;
+    size_t nTotal = vFrames.size() / 2;
+    for ( size_t nDone = 0; nDone < static_cast<size_t>( nFrames ); )
+    {
+      if ( voice.mnFrame >= nTotal )
+      {
+        if ( !voice.mpSample->mbLooping || !nTotal )
+        {
+          voice.mbFinished = true;
+          break;
+        }
+        voice.mnFrame = 0;
+      }
+
+      size_t n = std::min( nFrames - nDone, nTotal - voice.mnFrame );
+      MixInto( pOut + nDone * 2, &vFrames[voice.mnFrame * 2], n * 2, voice.mfGain );
+      nDone += n;
+      voice.mnFrame += n;
+    }
+  }
+
+  ClampMix( pOut, nFrames * 2 );
+}
@@ -14,6 +14,7 @@
 #include "../include/Controller.h"
 #include "../include/audio_startup.h"
 #include "../include/WaveLoader.h"
+#include "../include/Levels.h"
 
 namespace Engine
 {
@@ -132,7 +133,7 @@ namespace Engine
       }
       else
       {
-        GetAudioEngine()->PlaySounds("menumelody_repeat.wav", Vector3(), -15.0f);
+        GetAudioEngine()->PlaySounds("menumelody_repeat.wav", Vector3(), -15.0f, 0);
       }
     }
 
@@ -428,16 +429,22 @@ namespace Engine
       GameInstance & wavCont = game->getFirstInstanceByName("WaveController");
       GameInstance & beginTxt = game->getFirstInstanceByName("SpaceBegin");
 
-      WaveLoader load{ "Waves/L1Waves.json" };
+      // Waves come from the level's "waves" entry in Levels.json. They're only
+      // parsed once, restarts reuse the copy kept in the stage's snapshot
+      const std::string & levelWaves = Level::Levels.at(game->getStageName())->waves_;
+      std::string waveFile = levelWaves.empty() ? "Waves/L1Waves.json" : levelWaves;
 
-      for (size_t waveNum = 0; waveNum < load.size(); waveNum++)
+      std::shared_ptr<WaveLoader> load = game->getSnapshot().load<WaveLoader>(waveFile,
+        [&waveFile]() { return new WaveLoader(waveFile); });
+
+      for (size_t waveNum = 0; waveNum < load->size(); waveNum++)
       {
-        Wave & wave = load.getWave(waveNum);
+        Wave & wave = load->getWave(waveNum);
 
         wavCont.PostMessage("AddWave", &wave);
       }
 
-      pc.PostMessage("SetNumWaves", load.size());
+      pc.PostMessage("SetNumWaves", load->size());
 
       using namespace std::placeholders;
 
@@ -463,14 +470,23 @@ namespace Engine
 
       game->setStageRunning(true);*/
 
-      Grid grid(game, 11, 10);
-      game->SetGrid(grid);
-      game->GetGrid().DrawGrid();
+      // Building the grid creates every tile, so it gets load steps of its
+      // own instead of landing on the same frame as the rest of the init
+      game->queueLoadStep([](Stage * stage) 
+      {
+        Grid grid(stage, 11, 10);
+        stage->SetGrid(grid);
+      });
+
+      game->queueLoadStep([](Stage * stage) { stage->GetGrid().DrawGrid(); });
 
-      game->GetGrid().LoadStructureData("Objects/Structures.json");
+      game->queueLoadStep([](Stage * stage) 
+      {
+        stage->GetGrid().LoadStructureData("Objects/Structures.json");
 
-      // Load lua sandbox environment
-      game->setStageRunning(true);
+        // Load lua sandbox environment
+        stage->setStageRunning(true);
+      });
     }
 
     void MenuInit(Stage * menu)
@@ -0,0 +1,61 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include "../include/StageSnapshot.h"
+#include "../include/Stage.h"
+
+namespace Engine
+{
+  StageSnapshot::StageSnapshot() : captured_(false), instanceCount_(0)
+  {}
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Records the stage as it is now. Should be called right after the
+      stage has finished loading
+
+    \param stage
+      Stage to capture
+  */
+  /****************************************************************************/
+  void StageSnapshot::capture(Stage & stage)
+  {
+    stage.snapshotLuaSandbox();
+
+    instanceCount_ = stage.GetGameObjectCount();
+    captured_ = true;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Puts the stage's lua sandbox back the way it was when captured. The
+      stage must already be cleared, and its reset function still has to run
+      afterwards to recreate the instances
+
+    \param stage
+      Stage to restore
+  */
+  /****************************************************************************/
+  void StageSnapshot::restore(Stage & stage)
+  {
+    stage.restoreLuaSandbox();
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Throws away the snapshot and everything loaded into it, so the next
+      reset rebuilds the stage from scratch
+  */
+  /****************************************************************************/
+  void StageSnapshot::invalidate()
+  {
+    data_.clear();
+    captured_ = false;
+    instanceCount_ = 0;
+  }
+}
@@ -14,6 +14,8 @@
 #include "../include/Logger.h"
 #include "../include/Input.h"
 #include "../include/ScriptSignal.h"
+#include "../include/FrameProfiler.h"
+#include "../include/InputRecorder.h"
 #include "temp_utils.hpp"
 
 using namespace Logger;
@@ -22,6 +24,17 @@ namespace Engine
 {
   std::map<unsigned, std::vector<Stage *> > Stage::StageList;
   Stage* Stage::lastRunning_ = nullptr;
+  bool Stage::luaSeeded_ = false;
+  unsigned Stage::luaSeed_ = 0;
+
+  // Seconds per frame a loading stage can spend on its load steps
+  static const double LOAD_BUDGET = 0.008;
+  static const double BACKGROUND_LOAD_BUDGET = 0.002;
+
+  // Load steps per frame while input is recorded or replayed. A time budget
+  // would load over a different number of frames on every run
+  static const unsigned FIXED_LOAD_STEPS = 4;
+  static const unsigned FIXED_BACKGROUND_LOAD_STEPS = 1;
 
   static void OnStageReset(Stage * stage, const Packet &)
   {
@@ -157,39 +170,212 @@ namespace Engine
       Resets a stage by clearing its entities, messenger, and handlers.
       Runs the stage's rest function if it has one.
 
-    \param name
-      Name of the stage to reset
-     
-     \param order
-      Order the stage to reset exists on
+      The first reset rebuilds the lua sandbox and captures a snapshot once
+      the reset function is done. Later resets restore the sandbox from that
+      snapshot, and the reset function reuses the files it loaded into it.
+
+      Load steps the reset function queues are run over the next frames, 
+      see UpdateLoading. A stage that was preloaded and hasn't run since is
+      already reset, and one still preloading is moved to the foreground.
+
+    \param stage
+      Pointer to the stage to reset
   */
   /****************************************************************************/
-  void Stage::ResetStage(const std::string & name, unsigned order)
+  void Stage::ResetStage(Stage * stage)
   {
-    ResetStage(&GetStage(name, order));
+    stage->setStageReset(false);
+
+    if (stage->loading_)
+    {
+      stage->loadingBackground_ = false;
+      return;
+    }
+
+    if (stage->preloaded_)
+    {
+      stage->preloaded_ = false;
+      Log<Info>("Stage '%s' was preloaded, skipping reset", stage->stageName_.c_str());
+      return;
+    }
+
+    stage->beginLoad(false);
   }
 
   /****************************************************************************/
   /*!
     \brief
-      Resets a stage by clearing its entities, messenger, and handlers.
-      Runs the stage's rest function if it has one.
+      Resets a stage in the background, using only a little time each frame.
+      Once done, the next reset of the stage is skipped as long as the stage
+      hasn't started running in between
 
     \param stage
-      Pointer to the stage to reset
+      Stage to preload
   */
   /****************************************************************************/
-  void Stage::ResetStage(Stage * stage)
+  void Stage::PreloadStage(Stage & stage)
   {
-    stage->stageClear();
-    stage->setStageReset(false);
-    stage->getMessenger().Clear();
+    if (stage.loading_ || stage.preloaded_ || !stage.resFunc_)
+      return;
 
-    stage->initLuaSandbox();
-    stage->startLuaSandbox();
+    stage.beginLoad(true);
+  }
 
-    if (stage->resFunc_)
-      stage->resFunc_(stage);
+  /****************************************************************************/
+  /*!
+    \brief
+      Runs a loading stage's load steps for this frame, or starts preloading
+      an idle stage that wants it. Called once per frame for every stage
+
+    \param stage
+      Stage to update
+  */
+  /****************************************************************************/
+  void Stage::UpdateLoading(Stage & stage)
+  {
+    if (stage.loading_)
+      stage.continueLoad();
+    else if (stage.preloadWhenIdle_ && !stage.isRunning_ && !stage.toggleRunning_ &&
+             !stage.resetting_ && !stage.preloaded_)
+      PreloadStage(stage);
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Seeds math.random in every stage's lua sandbox, and in sandboxes made
+      later on
+
+    \param seed
+      Seed to use
+  */
+  /****************************************************************************/
+  void Stage::SeedLuaRandom(unsigned seed)
+  {
+    luaSeeded_ = true;
+    luaSeed_ = seed;
+
+    for (auto & stage_entry : StageList)
+    {
+      for (Stage * stage : stage_entry.second)
+      {
+        if (stage->lua_Sandbox_)
+          stage->lua_Sandbox_->seedRandom(seed);
+      }
+    }
+  }
+
+  void Stage::queueLoadStep(LOAD_STEP step)
+  {
+    loadSteps_.push_back(step);
+    ++loadStepsTotal_;
+  }
+
+  float Stage::getLoadProgress() const
+  {
+    if (!loading_ || loadStepsTotal_ == 0)
+      return 1.0f;
+
+    return 1.0f - static_cast<float>(loadSteps_.size()) / loadStepsTotal_;
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Clears the stage and runs its reset function. Load steps the reset 
+      function queued are left for continueLoad
+
+    \param background
+      Whether the stage is being preloaded
+  */
+  /****************************************************************************/
+  void Stage::beginLoad(bool background)
+  {
+    loadStart_ = FrameProfiler::Now();
+    loadFrames_ = 0;
+    loadRestored_ = snapshot_.isCaptured();
+    loadingBackground_ = background;
+    preloaded_ = false;
+
+    loadSteps_.clear();
+    loadStepsTotal_ = 0;
+
+    stageClear();
+
+    if (loadRestored_)
+      snapshot_.restore(*this);
+    else
+    {
+      initLuaSandbox();
+      startLuaSandbox();
+    }
+
+    if (resFunc_)
+      resFunc_(this);
+
+    loading_ = true;
+
+    if (loadSteps_.empty())
+      finishLoad();
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Runs queued load steps until this frame's budget is used up. At least 
+      one step runs each frame so loading always finishes. While input is 
+      recorded or replayed, a fixed number of steps runs instead
+  */
+  /****************************************************************************/
+  void Stage::continueLoad()
+  {
+    double budget = loadingBackground_ ? BACKGROUND_LOAD_BUDGET : LOAD_BUDGET;
+    unsigned fixedSteps = loadingBackground_ ? FIXED_BACKGROUND_LOAD_STEPS : FIXED_LOAD_STEPS;
+    bool fixed = InputRecorder::IsRecording() || InputRecorder::IsReplaying();
+    uint64_t start = FrameProfiler::Now();
+    unsigned steps = 0;
+
+    ++loadFrames_;
+
+    do
+    {
+      LOAD_STEP step = loadSteps_.front();
+      loadSteps_.pop_front();
+
+      step(this);
+      ++steps;
+    } while (!loadSteps_.empty() && 
+             (fixed ? steps < fixedSteps : (FrameProfiler::Now() - start) / 1e9 < budget));
+
+    if (loadSteps_.empty())
+      finishLoad();
+  }
+
+  void Stage::finishLoad()
+  {
+    loading_ = false;
+
+    if (!loadRestored_)
+      snapshot_.capture(*this);
+    else if (snapshot_.getInstanceCount() != GetGameObjectCount())
+      Log<Warning>("Stage '%s' restored with %d instances, snapshot had %u",
+        stageName_.c_str(), GetGameObjectCount(), 
+        static_cast<unsigned>(snapshot_.getInstanceCount()));
+
+    if (loadingBackground_)
+    {
+      preloaded_ = true;
+
+      // Instances show until they're told the stage is paused. Told once, 
+      // when the preload is done, rather than after every load step
+      if (!isRunning_)
+        mess_.Post("STAGE_PAUSED", Message<bool>(false));
+    }
+
+    Log<Info>("%s stage '%s' in %.2f ms over %u frames (%s)", 
+      loadingBackground_ ? "Preloaded" : "Reset", stageName_.c_str(),
+      (FrameProfiler::Now() - loadStart_) / 1e6, loadFrames_,
+      loadRestored_ ? "restored from snapshot" : "full rebuild");
   }
 
   /****************************************************************************/
@@ -222,7 +408,9 @@ namespace Engine
   /****************************************************************************/
   Stage::Stage(const std::string & name, STAGE_RESET_FUNC reset, unsigned order) :
     stageName_(name), stageId_(AssignID()), resetting_(false), resFunc_(reset),
-    lua_Sandbox_(nullptr)
+    lua_Sandbox_(nullptr), loadStepsTotal_(0), loadFrames_(0), loadStart_(0),
+    loading_(false), loadingBackground_(false), loadRestored_(false), 
+    preloaded_(false), preloadWhenIdle_(false)
   {
     stageOrder_ = order;
 
@@ -298,6 +486,9 @@ namespace Engine
   {
     stage.resFunc_ = res;
 
+    // The old snapshot was taken after a different reset function
+    stage.snapshot_.invalidate();
+
     // Have to do conditional check. Stage may already be resetting and 
     // you probably don't want to overwrite that
     if (resetNow)
@@ -352,6 +543,11 @@ namespace Engine
   {
     stage.isRunning_ = !stage.isRunning_;
     stage.toggleRunning_ = false;
+
+    if (stage.isRunning_)
+      stage.clock_.Resume();
+    else
+      stage.clock_.Pause();
   }
   /****************************************************************************/
   /*!
@@ -563,9 +759,20 @@ namespace Engine
   /****************************************************************************/
   void Stage::update()
   {      
-      //event_Router_.update();
 //    addGameInstance("Box0");
+      // Half built stages wait for their load to finish
+      if (loading_)
+        return;
+
+      // Running changes the stage, so it's no longer freshly reset
+      if (isRunning_ && !toggleRunning_)
+        preloaded_ = false;
+
       updateHandlers();
+
+      // Deliver this frame's batched script events
+      event_Router_.update();
+
       burstScripts(GSM::get().getDisplay().GetFrameTime());
   }
 
@@ -681,6 +888,9 @@ namespace Engine
         std::string type = inst->getObjectType();
         unsigned long id = inst->getId();
 
+        // Let anything tracking the instance know it's gone
+        stage.getMessenger().Post("InstanceRemoved", id);
+
         delete stage.gameInstanceList_.at(id);
         stage.removeHierarchy(type, id);
 
@@ -942,6 +1152,9 @@ namespace Engine
     }
 
     StageList.clear();
+
+    // No sandbox is left to load from the cache
+    Sandbox::FlushChunks();
   }
 
   /****************************************************************************/
@@ -1014,6 +1227,13 @@ namespace Engine
 
     Sandbox * newBox = new Sandbox(sandbox);
 
+    // Scripts in a stage reset mid-frame draw from the frame's seed too
+    if (luaSeeded_)
+      newBox->seedRandom(luaSeed_);
+
+    // Let garbage collection use spare time at the end of short frames
+    newBox->setGCBudget(0.001, true);
+
     hierarchy_ = newtable(newBox->getLuaState());
 
     event_Router_.reset();
@@ -1100,7 +1320,9 @@ namespace Engine
 
     registerLuaModule(
       class_<ScriptEvent, std::shared_ptr<ScriptEvent>>("ScriptEvent")
-      .def("Connect", &ScriptEvent::connect)
+      .def("Connect", &ScriptEvent::connectImmediate)
+      .def("ConnectBatched", &ScriptEvent::connectBatched)
+      .def("ConnectLatest", &ScriptEvent::connectLatest)
       .property("Name", &ScriptEvent::eventName));
 
     registerLuaModule(
@@ -1134,6 +1356,49 @@ namespace Engine
       luabind::call_function<void>(lua_Sandbox_->getLuaState(), "init", this);
     }
   }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Keeps a deep copy of the sandbox's shared environment so 
+      restoreLuaSandbox can go back to it
+  */
+  /****************************************************************************/
+  void Stage::snapshotLuaSandbox()
+  {
+    if (lua_Sandbox_)
+      lua_Sandbox_->snapshotState();
+  }
+
+  /****************************************************************************/
+  /*!
+    \brief
+      Reuses the running sandbox instead of creating a new one. Stops every 
+      script, puts the shared environment back to the last snapshot and 
+      gives the stage an empty hierarchy. Falls back to a fresh sandbox if
+      there isn't one yet
+  */
+  /****************************************************************************/
+  void Stage::restoreLuaSandbox()
+  {
+    if (!lua_Sandbox_)
+    {
+      initLuaSandbox();
+      startLuaSandbox();
+      return;
+    }
+
+    lua_State * L = lua_Sandbox_->getLuaState();
+
+    event_Router_.reset();
+    event_Router_.L = L;
+
+    hierarchy_ = luabind::newtable(L);
+    hierarchy_["name"] = stageName_;
+    hierarchy_["_RAW"] = this;
+
+    lua_Sandbox_->restoreState(this);
+  }
   SCRIPT_PTR Stage::loadScript(const std::string & script)
   {
     if (lua_Sandbox_)
@@ -1163,7 +1428,9 @@ namespace Engine
     if (lua_Sandbox_)
     {
       try {
-        lua_Sandbox_->update(GSM::get().getDisplay().GetFrameTime());
+        Display & disp = GSM::get().getDisplay();
+
+        lua_Sandbox_->update(disp.GetFrameTime(), disp.GetFrameTimeLeft());
       }
       catch (const std::exception & excep){
         Log<Error>(excep.what());
@@ -0,0 +1,133 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include <SDL2/SDL.h>
+
+#include <GL/glew.h>
+#include <GL/GL.h>
+
+#include <algorithm>
+
+#include "StaticBatch.h"
+#include "Renderer.h"
+#include "RMesh.h"
+
+StaticBatch::StaticBatch(const RMesh * mesh, const DrawSurface * surface) :
+  boundsMin{ 0, 0 }, boundsMax{ 0, 0 },
+  mesh_{ mesh }, surface_{ surface }, count_{ 0 }, 
+  drawMode_{ mesh->drawMode }, indexCount_{ static_cast<GLsizei>(3 * mesh->tris.size()) },
+  vao_{ NULL }, vertices_{ NULL }, indices_{ NULL }, transforms_{ NULL }, attributes_{ NULL }
+{
+  glGenVertexArrays(1, &vao_);
+  glGenBuffers(1, &vertices_);
+  glGenBuffers(1, &indices_);
+  glGenBuffers(1, &transforms_);
+  glGenBuffers(1, &attributes_);
+
+  glBindVertexArray(vao_);
+
+  // Own copy of the mesh, the renderer's buffers are freed when the mesh is replaced
+  glBindBuffer(GL_ARRAY_BUFFER, vertices_);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * mesh_->verts.size(), mesh_->verts.data(), GL_STATIC_DRAW);
+
+  Renderer::setVertexLayout();
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Tri) * mesh_->tris.size(), mesh_->tris.data(), GL_STATIC_DRAW);
+
+  // One matrix column per attribute
+  glBindBuffer(GL_ARRAY_BUFFER, transforms_);
+
+  for (GLuint col = 0; col < 4; ++col)
+  {
+    glEnableVertexAttribArray(3 + col);
+    glVertexAttribPointer(3 + col, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(col * sizeof(glm::vec4)));
+    glVertexAttribDivisor(3 + col, 1);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, attributes_);
+
+  glEnableVertexAttribArray(7);
+  glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(StaticAttributes), (void*)offsetof(StaticAttributes, shade));
+  glVertexAttribDivisor(7, 1);
+
+  glEnableVertexAttribArray(8);
+  glVertexAttribIPointer(8, 1, GL_UNSIGNED_INT, sizeof(StaticAttributes), (void*)offsetof(StaticAttributes, frame));
+  glVertexAttribDivisor(8, 1);
+
+  glBindVertexArray(NULL);
+  glBindBuffer(GL_ARRAY_BUFFER, NULL);
+}
+
+StaticBatch::~StaticBatch()
+{
+  glDeleteBuffers(1, &vertices_);
+  glDeleteBuffers(1, &indices_);
+  glDeleteBuffers(1, &transforms_);
+  glDeleteBuffers(1, &attributes_);
+  glDeleteVertexArrays(1, &vao_);
+}
+
+/**
+* \brief  Uploads every instance of the batch
+*
+* \param  transforms  Transformation of each instance, before the group transformation
+* \param  attributes  Shade and frame of each instance
+*/
+void StaticBatch::build(const std::vector<glm::mat4> & transforms, const std::vector<StaticAttributes> & attributes)
+{
+  count_ = std::min(transforms.size(), attributes.size());
+
+  glBindBuffer(GL_ARRAY_BUFFER, transforms_);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * count_, transforms.data(), GL_STATIC_DRAW);
+
+  glBindBuffer(GL_ARRAY_BUFFER, attributes_);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(StaticAttributes) * count_, attributes.data(), GL_DYNAMIC_DRAW);
+
+  glBindBuffer(GL_ARRAY_BUFFER, NULL);
+}
+
+/**
+* \brief  Replaces the shade and frame of a single instance
+*/
+void StaticBatch::setAttributes(size_t index, const StaticAttributes & attributes)
+{
+  if (index >= count_)
+    return;
+
+  glBindBuffer(GL_ARRAY_BUFFER, attributes_);
+  glBufferSubData(GL_ARRAY_BUFFER, sizeof(StaticAttributes) * index, sizeof(StaticAttributes), &attributes);
+  glBindBuffer(GL_ARRAY_BUFFER, NULL);
+}
+
+const RMesh * StaticBatch::getMesh() const
+{
+  return mesh_;
+}
+
+const DrawSurface * StaticBatch::getSurface() const
+{
+  return surface_;
+}
+
+size_t StaticBatch::size() const
+{
+  return count_;
+}
+
+GLuint StaticBatch::getVAO() const
+{
+  return vao_;
+}
+
+GLenum StaticBatch::getDrawMode() const
+{
+  return drawMode_;
+}
+
+GLsizei StaticBatch::getIndexCount() const
+{
+  return indexCount_;
+}
@@ -35,9 +35,7 @@ namespace Engine
   Structure::Structure() : height_(1), width_(1), zMax_(1), type_(0), group_(0), 
     structEntity_(0)
   {
-    std::vector<std::shared_ptr<StructureTile> > row;
-    row.push_back(std::shared_ptr<StructureTile>(new StructureTile(1, 0, 1)));
-    grid_.push_back(row);
+    tiles_.push_back(StructureTile(1, 0, 1));
   }
 
   /****************************************************************************/
@@ -57,9 +55,7 @@ namespace Engine
   : height_(1), width_(1), zMax_(1), type_(0), group_(group), structEntity_(0), 
     childTiles_(childTiles)
   {
-    std::vector<std::shared_ptr<StructureTile> > row;
-    row.push_back(std::shared_ptr<StructureTile>(new StructureTile(1, 0, 1)));
-    grid_.push_back(row);
+    tiles_.push_back(StructureTile(1, 0, 1));
     //stage_ = Stage::GetStage("TestStage1"); // not dynamic
   }
 
@@ -76,9 +72,7 @@ namespace Engine
   Structure::Structure(const std::string& path) : 
    height_(1), width_(1), type_(0), group_(-1), structEntity_(0)
   {
-    std::vector<std::shared_ptr<StructureTile> > row;
-    row.push_back(std::shared_ptr<StructureTile>(new StructureTile(1, 0, 1)));
-    grid_.push_back(row);
+    tiles_.push_back(StructureTile(1, 0, 1));
     LoadStructureFromPath(path);
   }
 
@@ -136,7 +130,7 @@ namespace Engine
       {
         int _height;
         sFile >> _height;
-        grid_[col][row]->SetHeight(_height);
+        GetTile(row, col).SetHeight(_height);
 
         if (_height > maxHeight)
           maxHeight = _height;
@@ -194,7 +188,7 @@ namespace Engine
     {
       for (int j = 0; j < width_; ++j)
       {
-        stream << std::setw(2) << grid_[i][j]->GetHeight() << " ";
+        stream << std::setw(2) << GetTile(j, i).GetHeight() << " ";
       }
 
       stream << std::endl;
@@ -241,7 +235,7 @@ namespace Engine
     {
       for (int j = 0; j < width_; ++j)
       {
-        stream << std::setw(2) << grid_[i][j]->GetHeight() << " ";
+        stream << std::setw(2) << GetTile(j, i).GetHeight() << " ";
       }
 
       stream << std::endl;
@@ -279,7 +273,7 @@ namespace Engine
         {
           for (int j = 0; j < width_; ++j)
           {
-            if (grid_[i][j]->GetHeight() != rhs.grid_[i][j]->GetHeight())
+            if (GetTile(j, i).GetHeight() != rhs.GetTile(j, i).GetHeight())
             {
               Log<Info>("Mismatch at tile (%d, %d)", j, i);
               return false;
@@ -328,28 +322,7 @@ namespace Engine
   /****************************************************************************/
   void Structure::SetWidth(int width)
   {
-    if (width_ < width)
-    {
-      for (int j = 0; j < height_; ++j)
-      {
-        for (int i = width_; i < width; ++i)
-        {
-          grid_[j].push_back(std::shared_ptr<StructureTile>(new StructureTile(0, 0, 0)));
-        }
-      }
-    }
-    else if (width_ > width)
-    {
-      for (int j = 0; j < height_; ++j)
-      {
-        for (int i = width_; i > width; --i)
-        {
-          grid_[j].pop_back();
-        }
-      }
-    }
-
-    width_ = width;
+    Resize(width, height_);
   }
 
   /****************************************************************************/
@@ -364,27 +337,40 @@ namespace Engine
   /****************************************************************************/
   void Structure::SetHeight(int height)
   {
-    if (height_ < height)
-    {
-      for (int i = height_; i < height; ++i)
-      {
-        std::vector<std::shared_ptr<StructureTile> > row;
+    Resize(width_, height);
+  }
 
-        for (int i = 0; i < width_; i++)
-          row.push_back(std::shared_ptr<StructureTile>(new StructureTile(0, 0)));
+  /****************************************************************************/
+  /*!
+  \brief
+  Resizes the Structure grid, keeping the tiles that still fit and filling new
+  tiles with empty ones
 
-        grid_.push_back(row);
+  \param width
+  The width to resize to
 
-      }
-    }
-    else if (height_ > height)
+  \param height
+  The height to resize to
+
+  */
+  /****************************************************************************/
+  void Structure::Resize(int width, int height)
+  {
+    if (width == width_ && height == height_)
+      return;
+
+    std::vector<StructureTile> tiles(width * height, StructureTile(0, 0, 0));
+
+    for (int j = 0; j < height && j < height_; ++j)
     {
-      for (int i = height_; i > height; --i)
+      for (int i = 0; i < width && i < width_; ++i)
       {
-        grid_.pop_back();
+        tiles[j * width + i] = GetTile(i, j);
       }
     }
 
+    tiles_.swap(tiles);
+    width_ = width;
     height_ = height;
   }
 
@@ -408,14 +394,11 @@ namespace Engine
 
     if (width_ == rhs.width_ && height_ == rhs.height_)
     {
-      for (int i = 0; i < height_; ++i)
+      for (size_t i = 0; i < tiles_.size(); ++i)
       {
-        for (int j = 0; j < width_; ++j)
+        if (tiles_[i].GetHeight() != rhs.tiles_[i].GetHeight())
         {
-          if (grid_[i][j]->GetHeight() != rhs.grid_[i][j]->GetHeight())
-          {
-            return false;
-          }
+          return false;
         }
       }
 
@@ -425,6 +408,37 @@ namespace Engine
     return false;
   }
 
+  /****************************************************************************/
+  /*!
+  \brief
+  Builds a compact key from the size and height map of the Structure. Two
+  Structures have the same key exactly when CompareGrids would match them.
+
+  \return
+  The pattern key of the Structure
+
+  */
+  /****************************************************************************/
+  std::string Structure::GetPatternKey() const
+  {
+    std::string key;
+    key.reserve(2 * (tiles_.size() + 2));
+
+    auto append = [&key](int value)
+    {
+      key.push_back(static_cast<char>(value & 0xFF));
+      key.push_back(static_cast<char>((value >> 8) & 0xFF));
+    };
+
+    append(width_);
+    append(height_);
+
+    for (auto& tile : tiles_)
+      append(tile.GetHeight());
+
+    return key;
+  }
+
   /****************************************************************************/
   /*!
   \brief
@@ -437,37 +451,33 @@ namespace Engine
   {
     GameInstance* gameObject = stage_->getMessenger().Request<GameInstance*>("PlayerController");
 
-    std::unordered_map<std::string, Structure>* LSL = gameObject->RequestData<std::unordered_map<std::string, Structure>*>("GetParsedStructureList");
-
-    //Log<Info>("Total number of loaded Structures at time of comparison: %d", LSL->size());
+    STRUCT_INDEX* LSI = gameObject->RequestData<STRUCT_INDEX*>("GetStructureIndex");
 
     GameInstance & newObj = stage_->addGameInstance("Structure");
 
     structEntity_ = newObj.getId();
 
-    for (auto& PossibleStructIter : *LSL)
+    auto PossibleStructIter = LSI->find(GetPatternKey());
+
+    if (PossibleStructIter != LSI->end())
     {
-      if (CompareGrids(PossibleStructIter.second))
+      // Oddly convoluted process to get entities from the structure
+      for (auto & tileId : childTiles_)
       {
-        // Oddly convoluted process to get entities from the structure
-        for (auto & tileId : childTiles_)
-        {
-          GameInstance& tileObj = stage_->getInstanceFromID(tileId);
-          auto instances = tileObj.RequestData <std::vector<unsigned long>>("TileEntities");
+        GameInstance& tileObj = stage_->getInstanceFromID(tileId);
+        auto instances = tileObj.RequestData <std::vector<unsigned long>>("TileEntities");
 
-          for (auto inst : instances)
+        for (auto inst : instances)
+        {
+          if (inst != tileId) // Why is the tile itself part of the stack?
           {
-            if (inst != tileId) // Why is the tile itself part of the stack?
-            {
-              GameInstance& obj = stage_->getInstanceFromID(inst);
-              newObj.PostMessage("AddStructureInstance", inst);
-            }
+            GameInstance& obj = stage_->getInstanceFromID(inst);
+            newObj.PostMessage("AddStructureInstance", inst);
           }
         }
-
-        newObj.PostMessage("LoadStructure", PossibleStructIter.first);
-        break;
       }
+
+      newObj.PostMessage("LoadStructure", PossibleStructIter->second);
     }
 
     SetArt();
@@ -5,7 +5,6 @@
 // ---------------------------------------------------------------------------------
 
 #include "../include/StructureLogic.h"
-#include "../include/GraphicsPipeline.h"
 #include "../include/audio_startup.h"
 //#include "../include/StructureCombat.h" // Possible future implementation.
 #include "../include/GSM.h"
@@ -233,7 +232,8 @@ namespace Engine
         float damPerc = static_cast<float>(OurHp) / static_cast<float>(MaxHp);
 
         Audio_Engine* AEngine = GetAudioEngine();
-        AEngine->PlaySounds("enemy_melee.wav", Vector3(), 0.05f);
+        static const SoundHandle meleeSound = AEngine->GetSoundHandle("enemy_melee.wav");
+        AEngine->PlaySounds(meleeSound, Vector3(), 0.05f);
         getParent().PostMessage("HpSet", Message<int>(OurHp));
         getParent().PostMessage("CreateParticles", Message<std::string>("spiral"));
 
@@ -299,7 +299,8 @@ namespace Engine
     getParent().PostMessage("StatFlagSet", Message<unsigned>(0));
 
     Audio_Engine* AEngine = GetAudioEngine();
-    AEngine->PlaySounds("ktttt.wav", Vector3(), -20.0f);
+    static const SoundHandle destroyedSound = AEngine->GetSoundHandle("ktttt.wav");
+    AEngine->PlaySounds(destroyedSound, Vector3(), -20.0f);
 
     /* Inform the grid that the structure has been destroyed. */
     //glm::vec2 gridpos = getParent().RequestData<glm::vec2>("TilePos");
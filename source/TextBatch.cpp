@@ -0,0 +1,237 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include <SDL2/SDL.h>
+
+#include <GL/glew.h>
+#include <GL/GL.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "TextBatch.h"
+#include "Font.h"
+#include "Renderer.h"
+#include "EngineCounters.h"
+
+TextBatch::TextBatch() :
+  nextId_{ 1 }, dirty_{ false }, ar_{ 0 },
+  vao_{ NULL }, vbo_{ NULL }, ibo_{ NULL }
+{}
+
+TextBatch::~TextBatch()
+{
+  if (vao_ != NULL)
+  {
+    glDeleteBuffers(1, &vbo_);
+    glDeleteBuffers(1, &ibo_);
+    glDeleteVertexArrays(1, &vao_);
+  }
+}
+
+/**
+* \brief  Adds an empty label to the batch
+*
+* \param  font  Font the label is drawn with
+*
+* \return A token for the label
+*/
+TextToken TextBatch::newLabel(const Font * font)
+{
+  size_t id = nextId_++;
+
+  labels_.insert(std::make_pair(id, Label{ font, std::string{}, glm::vec2{ 0, 0 }, 0.1f, glm::vec4{ 1, 1, 1, 1 }, true, 0 }));
+
+  return TextToken{ this, id };
+}
+
+/**
+* \brief  Rebuilds the vertex buffer if any label changed since the last layout
+*
+* \param  ar  Aspect ratio of the view, used to keep glyphs from stretching
+*/
+void TextBatch::layout(float ar)
+{
+  if (!dirty_ && ar == ar_)
+    return;
+
+  dirty_ = false;
+  ar_ = ar;
+
+  verts_.clear();
+  indices_.clear();
+  ranges_.clear();
+
+  // Group labels by font so each font is drawn with one call
+  std::vector<const Label *> order;
+
+  for (const auto & label : labels_)
+  {
+    if (label.second.visible && label.second.font && label.second.font->isLoaded() && !label.second.text.empty())
+      order.push_back(&label.second);
+  }
+
+  std::stable_sort(order.begin(), order.end(), [](const Label * lhs, const Label * rhs)
+  {
+    return lhs->font < rhs->font;
+  });
+
+  for (const Label * label : order)
+  {
+    if (ranges_.empty() || ranges_.back().font != label->font)
+      ranges_.push_back(Range{ label->font, indices_.size(), 0 });
+
+    layoutLabel(*label, ar);
+
+    ranges_.back().count = indices_.size() - ranges_.back().first;
+  }
+
+  if (vao_ == NULL)
+  {
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
+    glGenBuffers(1, &ibo_);
+
+    glBindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+
+    Renderer::setVertexLayout();
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
+    glBindVertexArray(NULL);
+    glBindBuffer(GL_ARRAY_BUFFER, NULL);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * verts_.size(), verts_.data(), GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, NULL);
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, ibo_);
+  glBufferData(GL_COPY_WRITE_BUFFER, sizeof(unsigned) * indices_.size(), indices_.data(), GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, NULL);
+
+  Engine::EngineCounters::Add("Text relayouts", 1);
+}
+
+/**
+* \brief  Draws every laid out label
+*
+* \param  render  Renderer the text program was loaded into
+* \param  group   Transformation applied to every label
+*/
+void TextBatch::draw(Renderer & render, const glm::mat4 & group) const
+{
+  for (const Range & range : ranges_)
+    render.drawText(vao_, *range.font, range.first, range.count, group);
+}
+
+size_t TextBatch::size() const
+{
+  return labels_.size();
+}
+
+bool TextBatch::empty() const
+{
+  return indices_.empty();
+}
+
+/**
+* \brief  Appends the quads of a single label, centred on its position
+*/
+void TextBatch::layoutLabel(const Label & label, float ar)
+{
+  const Font & font = *label.font;
+
+  // Font pixels to layer units, horizontal units are narrower by the aspect ratio
+  float unit = label.size / (font.getAscent() - font.getDescent());
+  glm::vec2 scale{ unit / ar, unit };
+
+  float width = 0;
+
+  for (char c : label.text)
+  {
+    const Font::Glyph * glyph = font.getGlyph(c);
+
+    if (glyph)
+      width += glyph->advance;
+  }
+
+  glm::vec2 pen{ label.position.x - 0.5f * width * scale.x,
+                 label.position.y - 0.5f * (font.getAscent() + font.getDescent()) * scale.y };
+
+  for (char c : label.text)
+  {
+    const Font::Glyph * glyph = font.getGlyph(c);
+
+    if (glyph == nullptr)
+      continue;
+
+    if (c != ' ')
+    {
+      glm::vec2 topLeft = pen + glyph->offset * scale;
+      glm::vec2 bottomRight = topLeft + glm::vec2{ glyph->size.x, -glyph->size.y } * scale;
+
+      unsigned base = static_cast<unsigned>(verts_.size());
+
+      verts_.push_back(Vertex{ glm::vec2{ bottomRight.x, topLeft.y }, glm::vec2{ glyph->uvMax.x, glyph->uvMin.y }, label.color });
+      verts_.push_back(Vertex{ topLeft, glyph->uvMin, label.color });
+      verts_.push_back(Vertex{ glm::vec2{ topLeft.x, bottomRight.y }, glm::vec2{ glyph->uvMin.x, glyph->uvMax.y }, label.color });
+      verts_.push_back(Vertex{ bottomRight, glyph->uvMax, label.color });
+
+      indices_.insert(indices_.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+    }
+
+    pen.x += glyph->advance * scale.x;
+  }
+}
+
+bool TextBatch::registerLabel(size_t id)
+{
+  auto it = labels_.find(id);
+
+  bool found = (it != labels_.end());
+
+  if (found)
+    ++(it->second.count);
+
+  return found;
+}
+
+void TextBatch::deregisterLabel(size_t id)
+{
+  auto it = labels_.find(id);
+
+  if (it == labels_.end())
+    return;
+
+  --(it->second.count);
+
+  // Remove a label if all references are deregistered
+  if (it->second.count <= 0)
+  {
+    labels_.erase(it);
+    dirty_ = true;
+  }
+}
+
+const TextBatch::Label & TextBatch::getLabel(size_t id) const
+{
+  auto it = labels_.find(id);
+
+  if (it == labels_.end())
+    throw std::out_of_range("Attempting to retrieve unknown text label");
+
+  return it->second;
+}
+
+TextBatch::Label & TextBatch::getLabel(size_t id)
+{
+  return const_cast<Label &>(static_cast<const TextBatch *>(this)->getLabel(id));
+}
+
+void TextBatch::markDirty()
+{
+  dirty_ = true;
+}
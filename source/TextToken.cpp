@@ -0,0 +1,157 @@
+// Primary Author : agent
+//
+//  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
+// FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
+// ---------------------------------------------------------------------------------
+#include "TextToken.h"
+#include "TextBatch.h"
+
+TextToken::TextToken() :
+  parent_{ nullptr }, id_{ 0 }
+{}
+
+TextToken::TextToken(const TextToken & cpy) :
+  parent_{ cpy.parent_ }, id_{ cpy.id_ }
+{
+  registerMe();
+}
+
+TextToken::TextToken(TextBatch * parent, size_t id) :
+  parent_{ parent }, id_{ id }
+{
+  registerMe();
+}
+
+/**
+* \brief  Destructor for TextTokens. Removes the label if this was its last token.
+*/
+TextToken::~TextToken()
+{
+  deregisterMe();
+}
+
+TextToken & TextToken::operator=(const TextToken & rhs)
+{
+  if (operator==(rhs))
+    return *this;
+
+  deregisterMe();
+
+  parent_ = rhs.parent_;
+  id_ = rhs.id_;
+
+  registerMe();
+
+  return *this;
+}
+
+bool TextToken::operator==(const TextToken & rhs) const
+{
+  return (id_ == rhs.id_) && (parent_ == rhs.parent_);
+}
+
+/**
+* \brief  Checks if the token refers to a label
+*/
+bool TextToken::isValid() const
+{
+  return parent_ != nullptr;
+}
+
+const std::string & TextToken::getText() const
+{
+  return parent_->getLabel(id_).text;
+}
+
+glm::vec2 TextToken::getPosition() const
+{
+  return parent_->getLabel(id_).position;
+}
+
+float TextToken::getSize() const
+{
+  return parent_->getLabel(id_).size;
+}
+
+glm::vec4 TextToken::getColor() const
+{
+  return parent_->getLabel(id_).color;
+}
+
+bool TextToken::isVisible() const
+{
+  return parent_->getLabel(id_).visible;
+}
+
+void TextToken::setText(const std::string & text)
+{
+  auto & label = parent_->getLabel(id_);
+
+  if (label.text == text)
+    return;
+
+  label.text = text;
+  parent_->markDirty();
+}
+
+void TextToken::setPosition(const glm::vec2 & pos)
+{
+  auto & label = parent_->getLabel(id_);
+
+  if (label.position == pos)
+    return;
+
+  label.position = pos;
+  parent_->markDirty();
+}
+
+void TextToken::setSize(float size)
+{
+  auto & label = parent_->getLabel(id_);
+
+  if (label.size == size)
+    return;
+
+  label.size = size;
+  parent_->markDirty();
+}
+
+void TextToken::setColor(const glm::vec4 & color)
+{
+  auto & label = parent_->getLabel(id_);
+
+  if (label.color == color)
+    return;
+
+  label.color = color;
+  parent_->markDirty();
+}
+
+void TextToken::setVisible(bool visible)
+{
+  auto & label = parent_->getLabel(id_);
+
+  if (label.visible == visible)
+    return;
+
+  label.visible = visible;
+  parent_->markDirty();
+}
+
+/**
+* \brief  Registers the token with its batch
+*/
+void TextToken::registerMe()
+{
+  if (parent_ != nullptr)
+    parent_->registerLabel(id_);
+}
+
+/**
+* \brief  Unregisters the token from its batch
+*/
+void TextToken::deregisterMe()
+{
+  if (parent_ != nullptr)
+    parent_->deregisterLabel(id_);
+}
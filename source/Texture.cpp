@@ -40,7 +40,7 @@ Texture::Texture(const std::string& image, size_t frames) :
   Texture::~Texture()
   {
     // delete texture
-    if(texture_ == NULL)
+    if(texture_ != NULL)
       glDeleteTextures(1, &texture_);
 
 //#ifndef N_LOGGING
@@ -95,6 +95,11 @@ Texture::Texture(const std::string& image, size_t frames) :
     texture_ = SOIL_load_OGL_texture_from_memory(bmp.data(), bmp.size(), SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, SOIL_FLAG_INVERT_Y);
     Log<RenderInfo>("SOIL: %s: %s", SOIL_last_result(), imagePath_.c_str());
 
+    // The GPU has its own copy now. Keep the file around if the upload
+    // failed so the next bind can try again
+    if (texture_ != NULL)
+      std::vector<unsigned char>().swap(bmp);
+
     glBindTexture(GL_TEXTURE_2D, NULL);
     //#ifndef N_LOGGING
     //
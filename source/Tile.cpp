@@ -77,7 +77,8 @@ namespace Engine
     if (!pc->RequestData<bool>("IsGod") && pc->RequestData<int>("AvailableWalls") <= 0)
     {
       stage_->removeGameInstance(ID);
-      GetAudioEngine()->PlaySounds("ResourceEmpty.wav", Vector3(), -18.0f);
+      static const SoundHandle emptySound = GetAudioEngine()->GetSoundHandle("ResourceEmpty.wav");
+      GetAudioEngine()->PlaySounds(emptySound, Vector3(), -18.0f);
       return; // if out of blocks, build nothing
     }
 
@@ -98,7 +99,8 @@ namespace Engine
     glm::vec4 color = item.getShade();
 
     /* Placement sound. */
-    AEngine->PlaySounds("place_block.wav", Vector3(), -12.0f);
+    static const SoundHandle placeSound = AEngine->GetSoundHandle("place_block.wav");
+    AEngine->PlaySounds(placeSound, Vector3(), -12.0f);
 
     // suscribe to clicked event
     REQUEST_ACTION getxy = std::bind(&Tile::XYRequest, this, std::placeholders::_1);
@@ -117,8 +119,7 @@ namespace Engine
 
     obj.PostMessage("CreateParticles", Message<std::string>("spiral")); // create particles when structure is built
 
-    std::set<int> tGroups = grid_->FindModifiedGroups(x_, y_);
-    grid_->ParseGroups(tGroups);
+    grid_->OnBlockPushed(x_, y_, height_);
     ++grid_->num_blocks_;
   }
 
@@ -138,8 +139,6 @@ namespace Engine
       DrawToken item = stage_->getInstanceFromID(game_instance_ID_[1]).RequestData<DrawToken>("Graphic");
       item.setShade(bottom_color_); 
     }
-    int ModifiedGroup = grid_->FindModifiedGroupOnRemove(x_, y_);
-
     stage_->getInstanceFromID(game_instance_ID_[1]).PostMessage("CreateParticles", Message<std::string>("explosion"));
     stage_->removeGameInstance(game_instance_ID_.back());
 
@@ -149,14 +148,7 @@ namespace Engine
     if (height_ == 0)
       group_ = 0;
 
-    if (ModifiedGroup)
-    {
-      grid_->ParseRemovedGroup(ModifiedGroup);
-    }
-    else
-    {
-      grid_->UpdateStructure(ModifiedGroup);
-    }
+    grid_->OnBlockPopped(x_, y_, height_);
     --grid_->num_blocks_;
   }
 
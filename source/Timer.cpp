@@ -5,15 +5,97 @@
 // ---------------------------------------------------------------------------------
 #include "../include/Timer.h"
 
-using namespace std::chrono;
+#include "../include/FrameProfiler.h"
+
+/****************************************************************************/
+/*!
+  \brief
+    Sets the time every timer reads until the next call. Called by the main
+    loop once per frame
+
+  \param nanos
+    Monotonic timestamp in nanoseconds
+*/
+/****************************************************************************/
+void FrameClock::Publish(uint64_t nanos)
+{
+  current() = nanos;
+}
+
+/****************************************************************************/
+/*!
+  \brief
+    Gets the timestamp of the current frame
+
+  \return
+    Nanoseconds since an arbitrary point
+*/
+/****************************************************************************/
+uint64_t FrameClock::Now()
+{
+  return current();
+}
+
+// Starts at the program's start time so timers made before the first frame
+// don't see a jump once frames are published
+uint64_t & FrameClock::current()
+{
+  static uint64_t now = Engine::FrameProfiler::Now();
+
+  return now;
+}
+
+StageClock::StageClock() :
+  isPaused_{ false }, pauseTime_{ 0 }, offset_{ 0 }
+{}
+
+/****************************************************************************/
+/*!
+  \brief
+    Stops the clock, along with every timer running on it
+*/
+/****************************************************************************/
+void StageClock::Pause()
+{
+  if (!isPaused_)
+    pauseTime_ = Now();
+
+  isPaused_ = true;
+}
+
+void StageClock::Resume()
+{
+  if (isPaused_)
+    offset_ = FrameClock::Now() - pauseTime_;
+
+  isPaused_ = false;
+}
+
+/****************************************************************************/
+/*!
+  \brief
+    Gets the frame time the clock has been running for
+
+  \return
+    Nanoseconds, not counting time spent paused
+*/
+/****************************************************************************/
+uint64_t StageClock::Now() const
+{
+  return isPaused_ ? pauseTime_ : FrameClock::Now() - offset_;
+}
 
 /****************************************************************************/
 /*!
   \brief
     Constructor for the Timer class
+
+  \param clock
+    Stage clock to run on, or nullptr to run on the frame clock
 */
 /****************************************************************************/
-Timer::Timer()
+Timer::Timer(const StageClock * clock) :
+  clock_{ clock }
 {
   Reset();
 }
@@ -27,37 +109,47 @@ Timer::Timer()
 void Timer::Reset()
 {
   isPaused_ = false;
-  initTime_ = duration_cast<milliseconds>(system_clock::now().time_since_epoch());
+  initTime_ = now();
 }
 
 /****************************************************************************/
 /*!
   \brief
-    Toggles the pause on the timer
-
-  \return
-    New paused status of the timer
+    Pauses the timer, keeping its current elapsed time
 */
 /****************************************************************************/
 void Timer::Pause()
 {
-  
   // Set paused time to the current elapsed time since initialization
   if (!isPaused_)
-    pauseTime_ = duration_cast<milliseconds>(system_clock::now().time_since_epoch()) - initTime_;
+    pauseTime_ = now() - initTime_;
 
   isPaused_ = true;
-
 }
 
 void Timer::UnPause()
 {
   if(isPaused_)
-    initTime_ = duration_cast<milliseconds>(system_clock::now().time_since_epoch()) - pauseTime_;
+    initTime_ = now() - pauseTime_;
 
   isPaused_ = false;
 }
 
+/****************************************************************************/
+/*!
+  \brief
+    Moves the timer onto another clock and resets it
+
+  \param clock
+    Stage clock to run on, or nullptr to run on the frame clock
+*/
+/****************************************************************************/
+void Timer::SetClock(const StageClock * clock)
+{
+  clock_ = clock;
+  Reset();
+}
+
 /****************************************************************************/
 /*!
   \brief
@@ -71,7 +163,12 @@ void Timer::UnPause()
 double Timer::ElapsedTime() const
 {
   if(isPaused_)
-    return (duration_cast<milliseconds>(system_clock::now().time_since_epoch()) - pauseTime_).count() / 1000.0;
+    return pauseTime_ / 1000000000.0;
   else
-    return (duration_cast<milliseconds>(system_clock::now().time_since_epoch()) - initTime_).count() / 1000.0;
+    return (now() - initTime_) / 1000000000.0;
+}
+
+uint64_t Timer::now() const
+{
+  return clock_ ? clock_->Now() : FrameClock::Now();
 }
@@ -248,6 +248,7 @@ namespace Engine
   void Transform::setX(float x)
   {
     x_ = x;
+    ++version_;
   }
 
   /****************************************************************************/
@@ -262,6 +263,7 @@ namespace Engine
   void Transform::setY(float y)
   {
     y_ = y;
+    ++version_;
   }
 
   /****************************************************************************/
@@ -276,6 +278,7 @@ namespace Engine
   void Transform::setRot(float rot)
   {
     rot_ = rot;
+    ++version_;
   }
 
   /****************************************************************************/
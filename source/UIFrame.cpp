@@ -183,6 +183,9 @@ namespace Engine
     events.push_back(router.newEvent<float>(objMessenger, "SpriteDepthSet"));
     events.push_back(router.newEvent<float>(objMessenger, "SpriteDepthChanged"));
     sub->getParent().registerScriptEvent(events);
+
+    // Components caching the old graphic switch to this one
+    sub->getParent().PostMessage("GraphicChanged", Message<DrawToken>(sub->getItem()));
   }
 
   void UIFrameHandler::update()
@@ -78,38 +78,55 @@ namespace Engine
 
       for (auto & waveName : waveNames)
       {
-        // Should be an array of spawn data
+        // Should be an array of spawn data, or an object that plays its 
+        // "spawns" array "repeat" times
         Json::Value waveData = root.get(waveName, defValue);
+        Json::Value spawnList = waveData;
+        int waveRepeat = 1;
         std::vector<float> delays;
         std::vector<EnemySpawnFlags> flags;
         std::vector<ObjectSpawnInfo> info;
         std::vector<int> positions;
 
+        if (waveData.isObject())
+        {
+          spawnList = waveData.get("spawns", defValue);
+          waveRepeat = waveData.get("repeat", 1).asInt();
+        }
+
         // Make sure the data is the correct format
-        if (waveData.isArray())
+        if (spawnList.isArray())
         {
-          for (auto spawnInfo : waveData)
+          for (int pass = 0; pass < waveRepeat; ++pass)
           {
-            try
-            {
-              // Load spawining info from the list
-              std::string type = spawnInfo.get("type", defValue).asString();
-              int position = spawnInfo.get("position", defValue).asInt();
-              float delay = spawnInfo.get("delay", defValue).asFloat();
-
-              EnemySpawnFlags enemyType;
-              ObjectSpawnInfo objInfo;
-
-              ReturnEnemyArchetype(&objInfo, &enemyType, type);
-
-              delays.push_back(delay);
-              flags.push_back(enemyType);
-              info.push_back(objInfo);
-              positions.push_back(position);
-            }
-            catch (const std::exception & e)
+            for (auto spawnInfo : spawnList)
             {
-              Log<WaveWarning>("Failed to load spawn info in %s! What: %s", filePath.c_str(), e.what());
+              try
+              {
+                // Load spawining info from the list
+                std::string type = spawnInfo.get("type", defValue).asString();
+                int position = spawnInfo.get("position", defValue).asInt();
+                float delay = spawnInfo.get("delay", defValue).asFloat();
+                int repeat = spawnInfo.get("repeat", 1).asInt();
+
+                EnemySpawnFlags enemyType;
+                ObjectSpawnInfo objInfo;
+
+                ReturnEnemyArchetype(&objInfo, &enemyType, type);
+
+                // Copies come out on the same frame as the first
+                for (int i = 0; i < repeat; ++i)
+                {
+                  delays.push_back(i ? 0.0f : delay);
+                  flags.push_back(enemyType);
+                  info.push_back(objInfo);
+                  positions.push_back(position);
+                }
+              }
+              catch (const std::exception & e)
+              {
+                Log<WaveWarning>("Failed to load spawn info in %s! What: %s", filePath.c_str(), e.what());
+              }
             }
           }
 
@@ -11,7 +11,7 @@
 namespace Engine
 {
   WaveController::WaveController(GameInstance * owner) : Component(owner, "WaveController"),
-    currentWave_(0), running_(false)
+    currentWave_(0), waveTimer_(&owner->getStage()->getClock()), running_(false)
   {
     waveTimer_.Pause();
   }
@@ -86,13 +86,16 @@ namespace Engine
         NextWave();
         waveTimer_.Reset();
       }
-      else if (!wave.IsWaveOver())
+      else
       {
-        if (wave.GetDelay() <= waveTimer_.ElapsedTime())
+        // Delays are from the previous spawn, so everything with no delay 
+        // after it comes out on the same frame
+        while (!wave.IsWaveOver() && wave.GetDelay() <= waveTimer_.ElapsedTime())
         {
-          unsigned long enemyID = wv_[currentWave_].SpawnNext(getParent().getStage());
+          unsigned long enemyID = wave.SpawnNext(getParent().getStage());
 
-          enemies_.push_back(std::make_pair(enemyID, currentWave_));
+          liveEnemies_[enemyID] = currentWave_;
+          ++aliveCount_[currentWave_];
           waveTimer_.Reset();
         }
       }
@@ -113,40 +116,34 @@ namespace Engine
   void WaveController::AddWave(const Wave & wave)
   {
     wv_.push_back(wave);
+    aliveCount_.push_back(0);
   }
 
   bool WaveController::IsWaveDead(size_t wave) const
   {
-    for (auto & enemy : enemies_)
-    {
-      if (enemy.second == wave)
-      {
-        try
-        {
-          // Only succceeds if instance currently exists
-          getParent().getStage()->getInstanceFromID(enemy.first);
+    return wave >= aliveCount_.size() || aliveCount_[wave] == 0;
+  }
 
-          return false;
-        }
-        catch (const std::out_of_range &) {}
-      }
-    }
+  /* Called when the stage deletes an instance. Only enemies this controller 
+     spawned are counted, and they stop being tracked once they're gone. */
+  void WaveController::OnInstanceRemoved(unsigned long id)
+  {
+    auto enemy = liveEnemies_.find(id);
+
+    if (enemy == liveEnemies_.end())
+      return;
 
-    return true;
+    --aliveCount_[enemy->second];
+    liveEnemies_.erase(enemy);
   }
 
   void WaveController::KillWave(size_t wave)
   {
-    for (auto & instance : enemies_)
+    // Removal is deferred, so the wave counts as alive until the stage cleans up
+    for (auto & enemy : liveEnemies_)
     {
-      if (instance.second == wave)
-      {
-        try
-        {
-          getParent().getStage()->removeGameInstance(instance.first);
-        }
-        catch (const std::out_of_range &) {}
-      }
+      if (enemy.second == wave)
+        getParent().getStage()->removeGameInstance(enemy.first);
     }
   }
 
@@ -274,6 +271,11 @@ namespace Engine
     sub->KillAll();
   }
 
+  static void OnInstanceRemoved(WaveController * sub, const Packet & payload)
+  {
+    sub->OnInstanceRemoved(payload.getData<unsigned long>());
+  }
+
   // Requests
   static void RequestWave(const WaveController * sub, Packet & payload)
   {
@@ -295,19 +297,6 @@ namespace Engine
     payload.setData(sub->WaveSize());
   }
 
-  void WaveController::OnStagePaused(const Packet & payload)
-  {
-    bool paused = payload.getData<bool>();
-
-    if (running_)
-    {
-      if (paused)
-        waveTimer_.Pause();
-      else
-        waveTimer_.UnPause();
-    }
-
-  }
   void WaveControllerHandler::ConnectEvents(Component * base_sub)
   {
     WaveController * sub = static_cast<WaveController *>(base_sub);
@@ -317,12 +306,12 @@ namespace Engine
     using namespace std::placeholders;
 
     SUBSCRIBER_ACTION onPause = std::bind(OnWavePaused, sub, std::placeholders::_1);
-    SUBSCRIBER_ACTION onStagePause = std::bind(&WaveController::OnStagePaused, sub, std::placeholders::_1);
 
     SUBSCRIBER_ACTION onWaveSet = std::bind(OnWaveSet, sub, std::placeholders::_1);
     SUBSCRIBER_ACTION onWaveAdd = std::bind(OnWaveAdd, sub, std::placeholders::_1);
     SUBSCRIBER_ACTION onWaveKilled = std::bind(OnWaveKill, sub, std::placeholders::_1);
     SUBSCRIBER_ACTION onAllKilled = std::bind(OnKillAll, sub, std::placeholders::_1);
+    SUBSCRIBER_ACTION onRemoved = std::bind(OnInstanceRemoved, sub, std::placeholders::_1);
 
     REQUEST_ACTION waveReq = std::bind(RequestWave, sub, std::placeholders::_1);
     REQUEST_ACTION waveNums = std::bind(RequestNumWaves, sub, std::placeholders::_1);
@@ -330,7 +319,6 @@ namespace Engine
     REQUEST_ACTION numEnemies = std::bind(RequestWaveSize, sub, std::placeholders::_1);
 
     // Events
-    objMessenger.Subscribe(stageMessenger, "STAGE_PAUSED", onStagePause);
     objMessenger.Subscribe(stageMessenger, "PauseWave", onPause);
     objMessenger.Subscribe(objMessenger, "PauseWave", onPause);
 
@@ -344,6 +332,8 @@ namespace Engine
     objMessenger.Subscribe(stageMessenger, "KillAllWaves", onAllKilled);
     objMessenger.Subscribe(objMessenger, "KillAllWaves", onAllKilled);
 
+    objMessenger.Subscribe(stageMessenger, "InstanceRemoved", onRemoved);
+
 
     // Requests
     stageMessenger.SetupRequest("CurrentWave", waveReq);
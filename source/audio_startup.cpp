@@ -17,16 +17,7 @@ static bool visitedLowHealth = false;
 static int repeatChannel = -1;
 static bool isMute = false; //used for global mute
 static bool melodyMute = false;
-static std::map<std::string, unsigned> soundCount;
-
-unsigned getSoundCount( const string& soundName )
-{
-  return soundCount[soundName];
-}
-void setSoundCount( const string& soundName, unsigned count )
-{
-  soundCount[soundName] = count;
-}
+static std::string audioBackend; //empty picks the best one there is
 
 void setMelodyMute(bool muted)
 {
@@ -90,6 +81,20 @@ Audio_Engine* GetAudioEngine()
   return AEngine;
 }
 
+/*! \brief
+ * Picks the backend StartGameAudioSystem starts ("fmod", "sdl" or "null").
+ * Has to be set before the audio system starts.
+ */
+void setAudioBackend(const std::string& strBackend)
+{
+  audioBackend = strBackend;
+}
+
+const std::string& getAudioBackend()
+{
+  return audioBackend;
+}
+
 /*! \brief
  * Initializes the audio system and reads in all sounds in the List.
  */
@@ -97,12 +102,14 @@ void StartGameAudioSystem()
 {
   std::string theList = "audio/List.txt";
   AEngine = new Audio_Engine;
-  AEngine->Init();
+  AEngine->Init( getAudioBackend() );
   GatherSounds( theList, *AEngine);
 }
 
 /*! \brief
- * Reads a list of sounds from a text file and loads them into the engine.
+ * Reads a list of sounds from a text file and starts loading them into the
+ * engine. The loading happens in the background; anything played before its
+ * sound is in starts as soon as it is.
  * \param strFileName
  * Path of the list.
  */
@@ -116,7 +123,6 @@ void GatherSounds( const string& strFileName, Audio_Engine& aEngine )
     return;
   }
   //container
-  std::string prefix = "audio/";
   std::string strSoundName;
   //iterator
   while ( fIn.good() )
@@ -124,6 +130,11 @@ void GatherSounds( const string& strFileName, Audio_Engine& aEngine )
     // Grab a name from the file.
     strSoundName = "5debug5";
     std::getline( fIn, strSoundName );
+    // Skip blank lines, the list ends with one.
+    if ( strSoundName.empty() )
+    {
+      continue;
+    }
     char chrFirstLetter = strSoundName[0];
     // Issue a warning if the input is bad.
     if ( !( 'A' <= chrFirstLetter && chrFirstLetter >= 'Z' ) &&
@@ -133,14 +144,11 @@ void GatherSounds( const string& strFileName, Audio_Engine& aEngine )
       return;
     }
     // Sets audio to 2D by default.
-    FMOD_MODE eMode = FMOD_DEFAULT;
+    bool b3d = false;
     // If the first letter is an 'm', loop it.
-    if ( strSoundName[0] == 'm' )
-    {
-      eMode |= FMOD_LOOP_NORMAL;
-    }
-    std::string finished_name = prefix + strSoundName;
+    bool bLooping = strSoundName[0] == 'm';
     // Send the results of reading our naming scheme to the Audio Engine.
-    aEngine.LoadSound( finished_name, (eMode & FMOD_3D) != 0, (eMode & FMOD_LOOP_NORMAL) != 0, (eMode & FMOD_CREATESTREAM) != 0 );
+    // LoadSound adds the audio folder itself.
+    aEngine.LoadSound( strSoundName, b3d, bLooping, false );
   }
 }
@@ -3,10 +3,13 @@
 //  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
 // FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
 // ---------------------------------------------------------------------------------
+#include <chrono>
+#include <climits>
 #include <luabind/luabind.hpp>
 #include "../include/Logger.h"
 #include "../include/audio_test.h"
 #include "../include/audio_startup.h"
+#include "../include/MemoryTracker.h"
 
 #define DEBUG 1
 
@@ -16,34 +19,417 @@ using namespace Logger;
 
 static float volume_ = 0.0f;
 
+static const size_t COMMAND_QUEUE_SIZE = 1024;
+static const size_t EVENT_QUEUE_SIZE = 256;
+
 /*! \brief
- * Creates the containers for the system, initializes the system.
+ * Creates the containers for the system and starts the audio thread.
+ * \param pBackend
+ * Started backend. The implementation owns it from here on.
  */
-Implementation::Implementation()
+Implementation::Implementation( AudioBackend* pBackend ) : mpBackend(pBackend),
+  mCommands(COMMAND_QUEUE_SIZE), mEvents(EVENT_QUEUE_SIZE), mbRunning(true),
+  mnNextChannelId(0), mnVoicesStarted(0)
 {
-    mpStudioSystem = NULL;
-    Audio_Engine::ErrorCheck( FMOD::Studio::System::create( &mpStudioSystem ) );
-    Audio_Engine::ErrorCheck( mpStudioSystem->initialize( 200, FMOD_STUDIO_INIT_LIVEUPDATE, FMOD_INIT_PROFILE_ENABLE, NULL ) );
-
-    mpSystem = NULL;
-    Audio_Engine::ErrorCheck( mpStudioSystem->getLowLevelSystem( &mpSystem ) );
+  for ( int i = 0; i < MAX_VOICES; ++i )
+  {
+    mnVoiceIds[i] = -1;
+  }
+  mThread = std::thread( &Implementation::RunAudioThread, this );
 }
 
 /*! \brief
- * Cleans up the information being used/stored and shuts down FMOD.
+ * Stops the audio thread and shuts down the backend. Commands still queued
+ * are thrown away.
  */
-Implementation::~Implementation() 
+Implementation::~Implementation()
 {
-    Audio_Engine::ErrorCheck( mpStudioSystem->unloadAll() );
-    Audio_Engine::ErrorCheck( mpStudioSystem->release() );
+  mbRunning = false;
+  mThread.join();
+  delete mpBackend;
 }
 
 /*! \brief
- * Loops through channels to find and delete stopped ones.
+ * Hands the audio thread anything that didn't fit in the queue last time,
+ * and catches up on what it has reported: sounds that finished loading
+ * start their waiting voices, and voices that ended go back in the pool.
  */
 void Implementation::Update()
 {
-  Audio_Engine::ErrorCheck( mpStudioSystem->update() );
+  mCommands.Flush();
+
+  AudioEvent event;
+  while ( mEvents.Pop( event ) )
+  {
+    switch ( event.mType )
+    {
+    case AudioEvent::SOUND_READY:
+    case AudioEvent::SOUND_FAILED:
+      {
+        SoundEntry& entry = mSounds[event.mSound];
+        // It may have been unloaded again since.
+        if ( entry.mnState != SOUND_LOADING )
+        {
+          break;
+        }
+
+        bool bReady = event.mType == AudioEvent::SOUND_READY;
+        if ( !bReady )
+        {
+          // Only complain once, then never try to play it again.
+          Log<Error>("Couldn't load sound: %s", entry.mName.c_str());
+        }
+        entry.mnState = bReady ? SOUND_READY : SOUND_FAILED;
+
+        for ( int i = 0; i < MAX_VOICES; ++i )
+        {
+          Voice& voice = mVoices[i];
+          if ( voice.mSound != event.mSound || voice.mbStarted )
+          {
+            continue;
+          }
+          if ( bReady )
+          {
+            StartVoice( voice );
+          }
+          else
+          {
+            FreeVoice( voice );
+          }
+        }
+      }
+      break;
+    case AudioEvent::VOICE_ENDED:
+      {
+        Voice* pVoice = FindVoice( event.mnChannelId );
+        if ( pVoice )
+        {
+          // The audio thread already let go of it.
+          pVoice->mbStarted = false;
+          FreeVoice( *pVoice );
+        }
+      }
+      break;
+    }
+  }
+}
+
+/*! \brief
+ * Finds the handle of a sound without loading it.
+ * \param strSoundName
+ * Name the sound was loaded with.
+ * \return
+ * The handle, or INVALID_SOUND if the sound was never loaded.
+ */
+SoundHandle Implementation::FindSound( const string& strSoundName ) const
+{
+  SoundHandleMap::const_iterator tFoundIt = mSoundHandles.find( strSoundName );
+  if ( tFoundIt == mSoundHandles.end() )
+  {
+    return INVALID_SOUND;
+  }
+  return tFoundIt->second;
+}
+
+/*! \brief
+ * Asks the audio thread to open a sound. It reports back when the sound is
+ * ready to play.
+ * \param hSound
+ * Sound to open, with the settings it was loaded with.
+ */
+void Implementation::OpenSound( SoundHandle hSound )
+{
+  SoundEntry& entry = mSounds[hSound];
+  entry.mnState = SOUND_LOADING;
+
+  AudioCommand command = AudioCommand();
+  command.mType = AudioCommand::OPEN_SOUND;
+  command.mSound = hSound;
+  command.mstrName = "audio/" + entry.mName;
+  command.mnValue = ( entry.mb3d ? AudioCommand::OPEN_3D : 0 ) |
+                    ( entry.mbLooping ? AudioCommand::OPEN_LOOPING : 0 ) |
+                    ( entry.mbStream ? AudioCommand::OPEN_STREAM : 0 );
+  Send( command );
+}
+
+/*! \brief
+ * Finds the voice a channel id belongs to.
+ * \param nChannelId
+ * Id given out by PlaySounds.
+ * \return
+ * The voice, or NULL if the sound has stopped since.
+ */
+Voice* Implementation::FindVoice( int nChannelId )
+{
+  if ( nChannelId < 0 )
+  {
+    return NULL;
+  }
+
+  Voice& voice = mVoices[nChannelId % MAX_VOICES];
+  if ( voice.mnChannelId != nChannelId )
+  {
+    return NULL;
+  }
+  return &voice;
+}
+
+/*! \brief
+ * Takes a voice out of the pool. If the sound already has MAX_INSTANCES
+ * copies playing, its oldest copy is stopped. If the pool is full, the least
+ * important voice (the oldest of those) is stolen, unless every voice is
+ * more important than the new sound.
+ * \param hSound
+ * Sound the voice will play.
+ * \param nPriority
+ * 0: Most important, 256: least important.
+ * \return
+ * The voice, or NULL if the sound shouldn't play.
+ */
+Voice* Implementation::AllocVoice( SoundHandle hSound, int nPriority )
+{
+  Voice* pFree = NULL;
+  Voice* pOldestCopy = NULL;
+  Voice* pVictim = NULL;
+  int nCopies = 0;
+
+  for ( int i = 0; i < MAX_VOICES; ++i )
+  {
+    Voice& voice = mVoices[i];
+    if ( voice.mnChannelId == -1 )
+    {
+      if ( !pFree )
+      {
+        pFree = &voice;
+      }
+      continue;
+    }
+
+    if ( voice.mSound == hSound )
+    {
+      ++nCopies;
+      if ( !pOldestCopy || voice.mnStarted < pOldestCopy->mnStarted )
+      {
+        pOldestCopy = &voice;
+      }
+    }
+
+    if ( !pVictim || voice.mnPriority > pVictim->mnPriority ||
+         ( voice.mnPriority == pVictim->mnPriority && voice.mnStarted < pVictim->mnStarted ) )
+    {
+      pVictim = &voice;
+    }
+  }
+
+  if ( nCopies >= MAX_INSTANCES )
+  {
+    FreeVoice( *pOldestCopy );
+    pFree = pOldestCopy;
+  }
+  else if ( !pFree )
+  {
+    if ( pVictim->mnPriority < nPriority )
+    {
+      return NULL;
+    }
+    FreeVoice( *pVictim );
+    pFree = pVictim;
+  }
+
+  // Ids change every time the slot is reused, so ids kept after a sound has
+  // stopped don't reach whatever plays in its slot next.
+  int nSlot = static_cast<int>( pFree - mVoices );
+  pFree->mnChannelId = static_cast<int>( mnNextChannelId++ % ( INT_MAX / MAX_VOICES ) ) * MAX_VOICES + nSlot;
+  pFree->mSound = hSound;
+  pFree->mnPriority = nPriority;
+  pFree->mnStarted = mnVoicesStarted++;
+  return pFree;
+}
+
+/*! \brief
+ * Tells the audio thread to start a voice whose sound is ready.
+ * \param voice
+ * Voice to start.
+ */
+void Implementation::StartVoice( Voice& voice )
+{
+  AudioCommand command = AudioCommand();
+  command.mType = AudioCommand::START_VOICE;
+  command.mnVoice = static_cast<int>( &voice - mVoices );
+  command.mnChannelId = voice.mnChannelId;
+  command.mSound = voice.mSound;
+  command.mfValue = voice.mfLevel;
+  command.mnValue = voice.mnPriority;
+  command.mbPaused = voice.mbPaused;
+  command.mvPosition = voice.mvPosition;
+  Send( command );
+  voice.mbStarted = true;
+}
+
+/*! \brief
+ * Stops a voice and puts it back in the pool.
+ * \param voice
+ * Voice to free.
+ */
+void Implementation::FreeVoice( Voice& voice )
+{
+  if ( voice.mbStarted )
+  {
+    AudioCommand command = AudioCommand();
+    command.mType = AudioCommand::STOP_VOICE;
+    command.mnVoice = static_cast<int>( &voice - mVoices );
+    Send( command );
+  }
+  voice = Voice();
+}
+
+/*! \brief
+ * Checks for voices silenced by the "mute all" function.
+ */
+bool Implementation::AnyVoiceMuteListed() const
+{
+  for ( int i = 0; i < MAX_VOICES; ++i )
+  {
+    if ( mVoices[i].mbMuteListed )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*! \brief
+ * Queues a command for the audio thread. Never waits.
+ */
+void Implementation::Send( const AudioCommand& command )
+{
+  mCommands.Push( command );
+}
+
+/*! \brief
+ * The audio thread. Carries out the game's commands, lets the backend do
+ * its work, and reports loaded sounds and ended voices back.
+ */
+void Implementation::RunAudioThread()
+{
+  // Everything the backends allocate from here on is audio memory.
+  Engine::MemoryTracker::Scope memory( Engine::MemoryTag::Audio );
+
+  vector<SoundHandle> vReady;
+  vector<SoundHandle> vFailed;
+  vector<int> vFinished;
+
+  while ( mbRunning )
+  {
+    AudioCommand command;
+    while ( mCommands.Pop( command ) )
+    {
+      Execute( command );
+    }
+
+    mpBackend->Update();
+
+    mpBackend->PollSounds( vReady, vFailed );
+    for ( size_t i = 0; i < vReady.size(); ++i )
+    {
+      AudioEvent event = { AudioEvent::SOUND_READY, vReady[i], -1 };
+      mEvents.Push( event );
+    }
+    for ( size_t i = 0; i < vFailed.size(); ++i )
+    {
+      AudioEvent event = { AudioEvent::SOUND_FAILED, vFailed[i], -1 };
+      mEvents.Push( event );
+    }
+
+    mpBackend->PollFinished( vFinished );
+    for ( size_t i = 0; i < vFinished.size(); ++i )
+    {
+      int& nChannelId = mnVoiceIds[vFinished[i]];
+      if ( nChannelId != -1 )
+      {
+        AudioEvent event = { AudioEvent::VOICE_ENDED, INVALID_SOUND, nChannelId };
+        mEvents.Push( event );
+        nChannelId = -1;
+      }
+    }
+
+    vReady.clear();
+    vFailed.clear();
+    vFinished.clear();
+    mEvents.Flush();
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+  }
+}
+
+/*! \brief
+ * Carries out one command from the game. Audio thread only.
+ */
+void Implementation::Execute( const AudioCommand& command )
+{
+  switch ( command.mType )
+  {
+  case AudioCommand::OPEN_SOUND:
+    mpBackend->OpenSound( command.mSound, command.mstrName, ( command.mnValue & AudioCommand::OPEN_3D ) != 0,
+                          ( command.mnValue & AudioCommand::OPEN_LOOPING ) != 0, ( command.mnValue & AudioCommand::OPEN_STREAM ) != 0 );
+    break;
+  case AudioCommand::RELEASE_SOUND:
+    mpBackend->ReleaseSound( command.mSound );
+    break;
+  case AudioCommand::START_VOICE:
+    mnVoiceIds[command.mnVoice] = command.mnChannelId;
+    if ( !mpBackend->StartVoice( command.mnVoice, command.mSound, command.mfValue, command.mnValue, command.mbPaused, command.mvPosition ) )
+    {
+      // Let the game have the voice back.
+      AudioEvent event = { AudioEvent::VOICE_ENDED, command.mSound, command.mnChannelId };
+      mEvents.Push( event );
+      mnVoiceIds[command.mnVoice] = -1;
+    }
+    break;
+  case AudioCommand::STOP_VOICE:
+    mpBackend->StopVoice( command.mnVoice );
+    mnVoiceIds[command.mnVoice] = -1;
+    break;
+  case AudioCommand::SET_VOLUME:
+    mpBackend->SetVoiceVolume( command.mnVoice, command.mfValue );
+    break;
+  case AudioCommand::SET_PAUSED:
+    mpBackend->SetVoicePaused( command.mnVoice, command.mnValue != 0 );
+    break;
+  case AudioCommand::SET_PRIORITY:
+    mpBackend->SetVoicePriority( command.mnVoice, command.mnValue );
+    break;
+  case AudioCommand::SET_POSITION:
+    mpBackend->SetVoicePosition( command.mnVoice, command.mvPosition );
+    break;
+  case AudioCommand::SET_LISTENER:
+    mpBackend->SetListener( command.mvPosition );
+    break;
+  case AudioCommand::LOAD_BANK:
+    mpBackend->LoadBank( command.mstrName, static_cast<unsigned>( command.mnValue ) );
+    break;
+  case AudioCommand::LOAD_EVENT:
+    mpBackend->LoadEvent( command.mstrName );
+    break;
+  case AudioCommand::PLAY_EVENT:
+    mpBackend->PlayEvent( command.mstrName );
+    break;
+  case AudioCommand::STOP_EVENT:
+    mpBackend->StopEvent( command.mstrName, command.mnValue != 0 );
+    break;
+  case AudioCommand::SET_EVENT_PARAMETER:
+    mpBackend->SetEventParameter( command.mstrName, command.mstrParameter, command.mfValue );
+    break;
+  }
+}
+
+/*! \brief
+ * Makes a free voice.
+ */
+Voice::Voice() : mnChannelId(-1), mSound(INVALID_SOUND), mbStarted(false), mfVolume(0.0f),
+  mfLevel(0.0f), mnPriority(Audio_Engine::DEFAULT_PRIORITY), mnStarted(0),
+  mbPaused(false), mbMuteListed(false)
+{
 }
 
 
@@ -54,14 +440,17 @@ Implementation* sgpImplementation = NULL;
 
 /*! \brief
  * Creates the audio engine.
+ * \param strBackend
+ * "fmod", "sdl" or "null". Empty picks the best one there is.
  */
-void Audio_Engine::Init()
+void Audio_Engine::Init( const string& strBackend )
 {
-  sgpImplementation = new Implementation;
+  sgpImplementation = new Implementation( CreateAudioBackend( strBackend ) );
 }
 
 /*! \brief
- * Necessary cleanup every game loop!
+ * Necessary cleanup every game loop! The audio itself runs on its own
+ * thread, so this only trades messages with it.
  */
 void Audio_Engine::Update()
 {
@@ -69,7 +458,8 @@ void Audio_Engine::Update()
 }
 
 /*! \brief
- * Loads a sound into the engine.
+ * Starts loading a sound into the engine. The loading happens on the audio
+ * thread, so this never waits on the disk.
  * \param strSoundName
  * Unique identifier to search for desired sound.
  * \param b3d
@@ -78,183 +468,173 @@ void Audio_Engine::Update()
  * Loads the sounds as a loop.
  * \param bStream
  * Open sound file/URL so it decompresses/reads at runtime.
+ * \return
+ * Handle to play the sound with.
  */
-void Audio_Engine::LoadSound( const std::string& strSoundName, bool b3d, bool bLooping, bool bStream )
+SoundHandle Audio_Engine::LoadSound( const std::string& strSoundName, bool b3d, bool bLooping, bool bStream )
 {
-  Implementation::SoundMap::iterator tFoundIt = sgpImplementation->mSounds.find( strSoundName );
+  SoundHandle hSound = sgpImplementation->FindSound( strSoundName );
   // Say NO to duplicate sound loading!
-  if ( tFoundIt != sgpImplementation->mSounds.end() )
+  if ( hSound != INVALID_SOUND && sgpImplementation->mSounds[hSound].mnState != Implementation::SOUND_UNLOADED &&
+       sgpImplementation->mSounds[hSound].mnState != Implementation::SOUND_FAILED )
   {
     Log<Info>("Already created sound: %s", strSoundName.c_str());
-    return;
+    return hSound;
   }
 
-  FMOD_MODE eMode = FMOD_DEFAULT;
-  eMode |= bLooping ? FMOD_LOOP_NORMAL : FMOD_DEFAULT;
-  eMode |= b3d ? FMOD_3D : FMOD_2D;
-  eMode |= bStream ? FMOD_CREATESTREAM : FMOD_CREATECOMPRESSEDSAMPLE;
+  // Handles are never given back, so a sound keeps its handle through unloads.
+  if ( hSound == INVALID_SOUND )
+  {
+    SoundEntry entry = { strSoundName, Implementation::SOUND_UNLOADED, b3d, bLooping, bStream };
+    hSound = static_cast<SoundHandle>( sgpImplementation->mSounds.size() );
+    sgpImplementation->mSounds.push_back( entry );
+    sgpImplementation->mSoundHandles[strSoundName] = hSound;
+  }
 
-  FMOD::Sound* pSound = NULL;
-  std::string prefix = "audio/";
-  std::string finished_name = prefix + strSoundName;
-  // Searches in directory for a sound and gives it the desired playmodes.
-  Audio_Engine::ErrorCheck( sgpImplementation->mpSystem->createSound( finished_name.c_str(), eMode, NULL, &pSound ) );
+  SoundEntry& entry = sgpImplementation->mSounds[hSound];
+  entry.mb3d = b3d;
+  entry.mbLooping = bLooping;
+  entry.mbStream = bStream;
+  sgpImplementation->OpenSound( hSound );
   Log<Info>("'%s' ping", strSoundName.c_str());
 
-  if ( pSound )
-  {
-    sgpImplementation->mSounds[ strSoundName ] = pSound;
-  }
+  return hSound;
 }
 
 /*! \brief
- * Unloads a sound from the audio engine.
+ * Unloads a sound from the audio engine. Its handle stays good; playing it
+ * again loads it back in.
  * \param strSoundName
  * Sound to be removed.
  */
 void Audio_Engine::UnLoadSound( const std::string& strSoundName )
 {
-  Implementation::SoundMap::iterator tFoundIt = sgpImplementation->mSounds.find( strSoundName );
+  SoundHandle hSound = sgpImplementation->FindSound( strSoundName );
   // Stop if you can't find it.
-  if ( tFoundIt == sgpImplementation->mSounds.end() )
+  if ( hSound == INVALID_SOUND || sgpImplementation->mSounds[hSound].mnState == Implementation::SOUND_UNLOADED )
   {
 
     Log<Warning>("Couldn't find sound: %s", strSoundName.c_str());
 
     return;
   }
-  Audio_Engine::ErrorCheck( tFoundIt->second->release() );
-  sgpImplementation->mSounds.erase( tFoundIt );
+
+  // Anything still playing it has to go first.
+  for ( int i = 0; i < Implementation::MAX_VOICES; ++i )
+  {
+    if ( sgpImplementation->mVoices[i].mSound == hSound )
+    {
+      sgpImplementation->FreeVoice( sgpImplementation->mVoices[i] );
+    }
+  }
+
+  AudioCommand command = AudioCommand();
+  command.mType = AudioCommand::RELEASE_SOUND;
+  command.mSound = hSound;
+  sgpImplementation->Send( command );
+  sgpImplementation->mSounds[hSound].mnState = Implementation::SOUND_UNLOADED;
 }
 
 /*! \brief
- * Puts a sound into a channel and starts it.
+ * Gets the handle of a sound, loading it with the default settings if it
+ * hasn't been loaded yet. Look handles up once and keep them around.
  * \param strSoundName
- * Search the Sound map for this.
+ * Name of the sound in the audio folder.
+ * \return
+ * Handle to play the sound with.
+ */
+SoundHandle Audio_Engine::GetSoundHandle( const std::string& strSoundName )
+{
+  SoundHandle hSound = sgpImplementation->FindSound( strSoundName );
+  if ( hSound == INVALID_SOUND )
+  {
+    hSound = LoadSound( strSoundName );
+  }
+  return hSound;
+}
+
+/*! \brief
+ * Puts a sound into a voice and starts it. Sounds that are still loading
+ * start as soon as they are ready.
+ * \param hSound
+ * Handle from GetSoundHandle or LoadSound.
  * \param vPosition
  * Location of the sound in 3D space.
  * \param fVolumedB
  * How loud the volume is, in decibels.
+ * \param nPriority
+ * 0: Most important, 256: least important. Less important sounds are
+ * stopped to make room when every voice is in use.
  * \return
- * The channel containing the sound.
+ * The channel containing the sound, or -1 if it couldn't be played.
  */
-int Audio_Engine::PlaySounds(const string& strSoundName, const Vector3& vPosition, float fVolumedB)
-{ 
-  int nChannelId = 0;
-
-  unsigned count = getSoundCount(strSoundName);
-  if ( count > 5 )
+int Audio_Engine::PlaySounds( SoundHandle hSound, const Vector3& vPosition, float fVolumedB, int nPriority )
+{
+  if ( hSound < 0 || hSound >= static_cast<SoundHandle>( sgpImplementation->mSounds.size() ) )
   {
-    //Do nothing if there are too many instances of the sound.
     return -1;
   }
-  else
+
+  SoundEntry& entry = sgpImplementation->mSounds[hSound];
+  // If it was unloaded, bring it back and play it once it's in.
+  if ( entry.mnState == Implementation::SOUND_UNLOADED )
   {
-    setSoundCount(strSoundName, ++count); //increment the count
+    sgpImplementation->OpenSound( hSound );
   }
-  // Increment the channelId variable to keep getting unique IDs
-  nChannelId = sgpImplementation->mnNextChannelId++;
-  Implementation::SoundMap::iterator tFoundIt = sgpImplementation->mSounds.find( strSoundName );
-  // If we can't find the sound in the map, try to find it by name.
-  if ( tFoundIt == sgpImplementation->mSounds.end() )
+  if ( entry.mnState == Implementation::SOUND_FAILED )
   {
-    LoadSound( strSoundName );
-    tFoundIt = sgpImplementation->mSounds.find( strSoundName );
-    if ( tFoundIt == sgpImplementation->mSounds.end() )
-    {
-      return nChannelId;
-    }
+    return -1;
   }
 
-  FMOD::Channel* pChannel = NULL;
-  // This plays the sound PAUSED.
-  Audio_Engine::ErrorCheck(sgpImplementation->mpSystem->playSound(tFoundIt->second, NULL, true, &pChannel));
-  FMOD_MODE loop_var = 0;
-  tFoundIt->second->getMode(&loop_var);
-  if (loop_var == FMOD_LOOP_NORMAL)
+  Voice* pVoice = sgpImplementation->AllocVoice( hSound, nPriority );
+  // Do nothing if every voice is playing something more important.
+  if ( !pVoice )
   {
-    pChannel->setMode(FMOD_LOOP_NORMAL);
+    return -1;
   }
-  // Adds the sound to the playing map.
-  sgpImplementation->mPlaying[nChannelId] = strSoundName;
-  sgpImplementation->mVolume[nChannelId] = fVolumedB;
-  if ( pChannel )
+
+  int nChannelId = pVoice->mnChannelId;
+  pVoice->mfVolume = fVolumedB;
+  pVoice->mfLevel = fVolumedB + volume_;
+  pVoice->mvPosition = vPosition;
+  // If we're alt-tabbed, add it to the list so it gets silenced!
+  if ( getVolumeMute() )
   {
-    FMOD_MODE currMode;
-    tFoundIt->second->getMode(&currMode);
-    if ( currMode & FMOD_3D )
-    {
-      FMOD_VECTOR position = VectorToFmod(vPosition);
-      Audio_Engine::ErrorCheck(pChannel->set3DAttributes(&position, NULL));
-    }
-    // If we're alt-tabbed, silence the sound and add it to the list!
-    if ( getVolumeMute() )
-    {
-      Audio_Engine::ErrorCheck(pChannel->setVolume(dbToVolume(fVolumedB + volume_)));
-      sgpImplementation->mPaused[nChannelId] = pChannel;
-    }
-    else
-    {
-      Audio_Engine::ErrorCheck(pChannel->setVolume(dbToVolume(fVolumedB + volume_)));
-    }
-    Audio_Engine::ErrorCheck( pChannel->setPaused(false) );
-    sgpImplementation->mChannels[nChannelId] = pChannel;
-    pChannel->setCallback(Audio_Engine::EndOfSound);
+    pVoice->mbMuteListed = true;
   }
-  sgpImplementation->Update();
 
-  //DEBUG text! Please let it sit there if it is needed in the future.
-  /*
-  char name[20];
-  for ( int i = 0; i < 20; ++i )
+  if ( entry.mnState == Implementation::SOUND_READY )
   {
-    if ( i < strSoundName.size() )
-    {
-      name[i] = strSoundName[i];
-    }
-    else
-    {
-      name[i] = '*';
-    }
-  }
-  Log<Warning>("Playing sound '%s' ", name);
-  Log<Warning>("Playing Channel count: %d", static_cast<int>(sgpImplementation->mPlaying.size()));
-  int channelsplaying = 0, realchan = 0;
-  unsigned vers = 0;
-  Log<Warning>("FMOD Channel count: %d", channelsplaying );
-  Log<Warning>("Playing Channel count: %d", static_cast<int>(sgpImplementation->mPlaying.size()));
-  Log<Warning>("Channel count: %d", static_cast<int>(sgpImplementation->mChannels.size()));
-  if ( sgpImplementation->mPlaying.size() > 4 )
-  {
-    char soundname[20];
-    for ( Implementation::ChannelPlayingMap::iterator j = sgpImplementation->mPlaying.begin(); j != sgpImplementation->mPlaying.end(); ++j )
-    {
-      // Get the name of each sound in the playing channel.
-      for (int i = 0; i < 20; ++i)
-      {
-        if (i < (j->second).size())
-        {
-          soundname[i] = (j->second)[i];
-        }
-        else
-        {
-          soundname[i] = '*';
-        }
-      }
-      Log<Warning>("Channel %d sound '%s' ", j->first, soundname);
-    }
+    sgpImplementation->StartVoice( *pVoice );
   }
-  */
 
   // If we've got paused sounds, play new sounds paused as well.
-  if ( !sgpImplementation->mPaused.empty() )
+  if ( sgpImplementation->AnyVoiceMuteListed() )
   {
     SetChannelMute(nChannelId, true);
-    sgpImplementation->mPaused[nChannelId] = pChannel;
+    pVoice->mbMuteListed = true;
   }
   return nChannelId;
 }
 
+/*! \brief
+ * Plays a sound by name. Prefer keeping the handle and using that instead.
+ * \param strSoundName
+ * Name of the sound in the audio folder.
+ * \param vPosition
+ * Location of the sound in 3D space.
+ * \param fVolumedB
+ * How loud the volume is, in decibels.
+ * \param nPriority
+ * 0: Most important, 256: least important.
+ * \return
+ * The channel containing the sound, or -1 if it couldn't be played.
+ */
+int Audio_Engine::PlaySounds(const string& strSoundName, const Vector3& vPosition, float fVolumedB, int nPriority)
+{
+  return PlaySounds( GetSoundHandle( strSoundName ), vPosition, fVolumedB, nPriority );
+}
+
 /*! \brief
  * Sets the location of the sound.
  * \param nChannelID
@@ -264,9 +644,9 @@ int Audio_Engine::PlaySounds(const string& strSoundName, const Vector3& vPositio
  */
 void Audio_Engine::SetChannel3dPosition( int nChannelId, const Vector3& vPosition )
 {
-  Implementation::ChannelMap::iterator tFoundIt = sgpImplementation->mChannels.find( nChannelId );
+  Voice* pVoice = sgpImplementation->FindVoice( nChannelId );
   // If you can't find the channel, stop.
-  if ( tFoundIt == sgpImplementation->mChannels.end() )
+  if ( !pVoice )
   {
 
     Log<Warning>("Couldn't find channel: %d", nChannelId);
@@ -274,8 +654,15 @@ void Audio_Engine::SetChannel3dPosition( int nChannelId, const Vector3& vPositio
     return;
   }
 
-  FMOD_VECTOR position = VectorToFmod( vPosition );
-  Audio_Engine::ErrorCheck( tFoundIt->second->set3DAttributes( &position, NULL) );
+  pVoice->mvPosition = vPosition;
+  if ( pVoice->mbStarted )
+  {
+    AudioCommand command = AudioCommand();
+    command.mType = AudioCommand::SET_POSITION;
+    command.mnVoice = static_cast<int>( pVoice - sgpImplementation->mVoices );
+    command.mvPosition = vPosition;
+    sgpImplementation->Send( command );
+  }
 }
 
 /*! \brief
@@ -288,8 +675,8 @@ void Audio_Engine::SetChannel3dPosition( int nChannelId, const Vector3& vPositio
 void Audio_Engine::SetChannelVolume( int nChannelId, float fVolumedB )
 {
   float volume = fVolumedB + GetGlobalVolumedB();
-  Implementation::ChannelMap::iterator tFoundIt = sgpImplementation->mChannels.find( nChannelId );
-  if ( tFoundIt == sgpImplementation->mChannels.end() )
+  Voice* pVoice = sgpImplementation->FindVoice( nChannelId );
+  if ( !pVoice )
   {
     Log<Warning>("Couldn't find channel: %d", nChannelId);
 
@@ -298,7 +685,7 @@ void Audio_Engine::SetChannelVolume( int nChannelId, float fVolumedB )
 
   if ( getMelodyMute() )
   {
-    if ( tFoundIt->first == FindSoundChannel("menumelody_repeat.wav") || tFoundIt->first == FindSoundChannel("startup.wav"))
+    if ( nChannelId == FindSoundChannel("menumelody_repeat.wav") || nChannelId == FindSoundChannel("startup.wav"))
     {
       volume = -96.0f;
     }
@@ -308,18 +695,27 @@ void Audio_Engine::SetChannelVolume( int nChannelId, float fVolumedB )
   {
     if ( !getMelodyMute() )
     {
-      sgpImplementation->mVolume[nChannelId] = fVolumedB;
+      pVoice->mfVolume = fVolumedB;
     }
     else
     {
-      if ( tFoundIt->first != FindSoundChannel("menumelody_repeat.wav") || tFoundIt->first == FindSoundChannel("startup.wav"))
+      if ( nChannelId != FindSoundChannel("menumelody_repeat.wav") || nChannelId == FindSoundChannel("startup.wav"))
       {
-        sgpImplementation->mVolume[nChannelId] = fVolumedB;
+        pVoice->mfVolume = fVolumedB;
       }
       //else it's a melody and is mute so the volume should not be recorded.
     }
   }
-  Audio_Engine::ErrorCheck( tFoundIt->second->setVolume( dbToVolume( volume ) ) );
+  // Sounds still loading pick this up when they start.
+  pVoice->mfLevel = volume;
+  if ( pVoice->mbStarted )
+  {
+    AudioCommand command = AudioCommand();
+    command.mType = AudioCommand::SET_VOLUME;
+    command.mnVoice = static_cast<int>( pVoice - sgpImplementation->mVoices );
+    command.mfValue = volume;
+    sgpImplementation->Send( command );
+  }
 }
 
 /*! \brief
@@ -331,32 +727,28 @@ void Audio_Engine::SetChannelVolume( int nChannelId, float fVolumedB )
  */
 float Audio_Engine::GetChannelVolume(int nChannelId)
 {
-  return sgpImplementation->mVolume[nChannelId];
+  Voice* pVoice = sgpImplementation->FindVoice( nChannelId );
+  if ( !pVoice )
+  {
+    return 0.0f;
+  }
+  return pVoice->mfVolume;
 }
 
 /*! \brief
- * Loads a bank from the map into the audio engine.
+ * Loads a bank from the map into the audio engine. Only FMOD has banks.
  * \param strBankName
  * Unique identifier for the bank.
  * \flags
  * Check FMOD help for info on these bank flags.
  */
-void Audio_Engine::LoadBank( const std::string& strBankName, FMOD_STUDIO_LOAD_BANK_FLAGS flags )
+void Audio_Engine::LoadBank( const std::string& strBankName, unsigned flags )
 {
-  Implementation::BankMap::iterator tFoundIt = sgpImplementation->mBanks.find( strBankName );
-  // Stop if the identifier string is already in use.
-  if ( tFoundIt != sgpImplementation->mBanks.end() )
-  {
-    Log<Info>("Already created bank: ", strBankName.c_str());
-    return;
-  }
-  FMOD::Studio::Bank* pBank;
-  // The part that puts it int
-  Audio_Engine::ErrorCheck( sgpImplementation->mpStudioSystem->loadBankFile( strBankName.c_str(), flags, &pBank ) );
-  if ( pBank )
-  {
-    sgpImplementation->mBanks[strBankName] = pBank;
-  }
+  AudioCommand command = AudioCommand();
+  command.mType = AudioCommand::LOAD_BANK;
+  command.mstrName = strBankName;
+  command.mnValue = static_cast<int>( flags );
+  sgpImplementation->Send( command );
 }
 
 /*! \brief
@@ -364,24 +756,12 @@ void Audio_Engine::LoadBank( const std::string& strBankName, FMOD_STUDIO_LOAD_BA
  * \param strEventName
  * Unique identifier for the Event.
  */
-void Audio_Engine::LoadEvent( const std::string& strEventName ) {
-  Implementation::EventMap::iterator tFoundit = sgpImplementation->mEvents.find( strEventName );
-  // Stop if you found an event using the same name.
-  if ( tFoundit != sgpImplementation->mEvents.end() )
-  {
-    return;
-  }
-  FMOD::Studio::EventDescription* pEventDescription = NULL;
-  Audio_Engine::ErrorCheck( sgpImplementation->mpStudioSystem->getEvent( strEventName.c_str(), &pEventDescription ) );
-  if ( pEventDescription )
-  {
-    FMOD::Studio::EventInstance* pEventInstance = NULL;
-    Audio_Engine::ErrorCheck(pEventDescription->createInstance( &pEventInstance ) );
-    if ( pEventInstance )
-    {
-      sgpImplementation->mEvents[strEventName] = pEventInstance;
-    }
-  }   
+void Audio_Engine::LoadEvent( const std::string& strEventName )
+{
+  AudioCommand command = AudioCommand();
+  command.mType = AudioCommand::LOAD_EVENT;
+  command.mstrName = strEventName;
+  sgpImplementation->Send( command );
 }
 
 /*! \brief
@@ -391,49 +771,51 @@ void Audio_Engine::LoadEvent( const std::string& strEventName ) {
  */
 void Audio_Engine::PlayEvent( const string &strEventName )
 {
-  Implementation::EventMap::iterator tFoundit = sgpImplementation->mEvents.find( strEventName );
-  // If we can't find it, try to load the event.
-  if ( tFoundit == sgpImplementation->mEvents.end() )
-  {
-    LoadEvent( strEventName );
-    tFoundit = sgpImplementation->mEvents.find( strEventName );
-    // If it can't be loaded in, stop.
-    if ( tFoundit == sgpImplementation->mEvents.end() )
-    {
-      return;
-    }
-  }
-  tFoundit->second->start();
+  AudioCommand command = AudioCommand();
+  command.mType = AudioCommand::PLAY_EVENT;
+  command.mstrName = strEventName;
+  sgpImplementation->Send( command );
 }
 
 void Audio_Engine::SetChannelPause( int nChannelId, bool pause )
 {
-	//for ( ChannelMap::iterator it = mChannels.begin(), itEnd = mChannels.end() ; it != itEnd ; ++it )
-	Implementation::ChannelMap::iterator it = sgpImplementation->mChannels.find(nChannelId);
-	if ( it != sgpImplementation->mChannels.end() )
-	{
-		Audio_Engine::ErrorCheck( it->second->setPaused( pause ) );
-	}
+  Voice* pVoice = sgpImplementation->FindVoice( nChannelId );
+  if ( pVoice )
+  {
+    pVoice->mbPaused = pause;
+    if ( pVoice->mbStarted )
+    {
+      AudioCommand command = AudioCommand();
+      command.mType = AudioCommand::SET_PAUSED;
+      command.mnVoice = static_cast<int>( pVoice - sgpImplementation->mVoices );
+      command.mnValue = pause ? 1 : 0;
+      sgpImplementation->Send( command );
+    }
+  }
 }
 
 void Audio_Engine::GetChannelSounds( int nChannelId, vector<std::string>& vstrSoundsFound )
 {
-  for (Implementation::ChannelPlayingMap::iterator it = sgpImplementation->mPlaying.begin(), itEnd = sgpImplementation->mPlaying.end() ; it != itEnd ; ++it)
+  Voice* pVoice = sgpImplementation->FindVoice( nChannelId );
+  if ( pVoice )
   {
-    if ( it->first == nChannelId )
-    {
-      vstrSoundsFound.push_back( it->second );
-    }
+    vstrSoundsFound.push_back( sgpImplementation->mSounds[pVoice->mSound].mName );
   }
 }
 
 void Audio_Engine::GetSoundChannels( const string& strSoundName, vector<int>& vintChannelsFound )
 {
-  for ( Implementation::ChannelPlayingMap::iterator it = sgpImplementation->mPlaying.begin(), itEnd = sgpImplementation->mPlaying.end() ; it != itEnd ; ++it )
+  SoundHandle hSound = sgpImplementation->FindSound( strSoundName );
+  if ( hSound == INVALID_SOUND )
   {
-    if ( it->second == strSoundName )
+    return;
+  }
+
+  for ( int i = 0; i < Implementation::MAX_VOICES; ++i )
+  {
+    if ( sgpImplementation->mVoices[i].mSound == hSound )
     {
-      vintChannelsFound.push_back( it->first );
+      vintChannelsFound.push_back( sgpImplementation->mVoices[i].mnChannelId );
     }
   }
 }
@@ -441,108 +823,72 @@ void Audio_Engine::GetSoundChannels( const string& strSoundName, vector<int>& vi
 //Currently, this only works to add functions into an overall mute. DO NOT PASS FALSE!
 void Audio_Engine::SetChannelMute( int nChannelId, bool mute )
 {
-	//for ( ChannelMap::iterator it = mChannels.begin(), itEnd = mChannels.end() ; it != itEnd ; ++it )
-	Implementation::ChannelMap::iterator it = sgpImplementation->mChannels.find(nChannelId);
-	if ( it != sgpImplementation->mChannels.end() )
-	{
+  Voice* pVoice = sgpImplementation->FindVoice( nChannelId );
+  if ( pVoice )
+  {
     float volume = -96.0f;
     if (!mute)
     {
-      volume = GetChannelVolume(it->first);
+      volume = pVoice->mfVolume;
     }
-    SetChannelVolume(it->first, volume);
-	}
+    SetChannelVolume(nChannelId, volume);
+  }
 }
 
 //This function will mute all channels.
 void Audio_Engine::SetAllChannelsMute( bool isMute )
 {
   setVolumeMute(isMute); //This function indicates a blanked mute setting.
-  if ( !sgpImplementation->mChannels.empty() )
+  for ( int i = 0; i < Implementation::MAX_VOICES; ++i )
   {
-    for (Implementation::ChannelMap::iterator it = sgpImplementation->mChannels.begin(); it != sgpImplementation->mChannels.end(); ++it)
+    int nChannelId = sgpImplementation->mVoices[i].mnChannelId;
+    if ( nChannelId == -1 )
     {
-      float volume = -96.0f;
-      // Set volume to normal levels.
-      if ( !isMute )
-      {
-        // Should we unpause the melodies?
-        if ( getMelodyMute() )
-        {
-          if ( it->first == FindSoundChannel("menumelody_repeat.wav"))
-          {
-            continue;
-          }
-          if ( it->first == FindSoundChannel("startup.wav"))
-          {
-            continue;
-          }
-        }
-
-        volume = GetChannelVolume(it->first);
-      }
-      SetChannelVolume(it->first, volume);
+      continue;
     }
-  }
-  // Empty out the Paused sound list once we've set the volumes properly.
-  if (!isMute)
-  {
-    if (!sgpImplementation->mPaused.empty())
+
+    float volume = -96.0f;
+    // Set volume to normal levels.
+    if ( !isMute )
     {
-      if ( !getMelodyMute() )
-      {
-        sgpImplementation->mPaused.clear();
-      }
-      else //empty out all other sounds.
+      // Should we unpause the melodies?
+      if ( getMelodyMute() )
       {
-        int nChannelId = FindSoundChannel("menumelody.wav");
-        int nChannelId2 = FindSoundChannel("startup.wav");
-        //This deletion causes problems
-        Implementation::ChannelMap unmute;
-        for (Implementation::ChannelMap::iterator it = sgpImplementation->mPaused.begin(); it != sgpImplementation->mPaused.end(); ++it)
+        if ( nChannelId == FindSoundChannel("menumelody_repeat.wav"))
         {
-          // If it's not either of the melody sounds, remove it.
-          if ( it->first != nChannelId && it->first != nChannelId2 )
-          {
-            unmute.insert(*it);
-          }
+          continue;
         }
-        for (Implementation::ChannelMap::iterator it = unmute.begin(); it != unmute.end(); ++it)
+        if ( nChannelId == FindSoundChannel("startup.wav"))
         {
-          Implementation::ChannelMap::iterator condemned = sgpImplementation->mPaused.find(it->first);
-          sgpImplementation->mPaused.erase(condemned);
+          continue;
         }
       }
+
+      volume = GetChannelVolume(nChannelId);
     }
+    SetChannelVolume(nChannelId, volume);
   }
-
-  /* THIS FUNCTIONALITY IS BROKEN because the cleanup service removes information. */
-#if 0
-  /* Are we looking for sounds to pause? */
-  if ( isPaused )
+  // Empty out the Paused sound list once we've set the volumes properly.
+  if (!isMute)
   {
-    for (Implementation::ChannelMap::iterator it = sgpImplementation->mChannels.begin(), itEnd = sgpImplementation->mChannels.end(); it != itEnd; ++it)
+    int nChannelId = -1;
+    int nChannelId2 = -1;
+    // Leave the melodies on the list if they're still muted.
+    if ( getMelodyMute() )
     {
-      // Only set currently playing sounds to be paused.
-      bool playing = false;
-      it->second->isPlaying( &playing );
-      if ( playing )
-      {
-        Audio_Engine::ErrorCheck(it->second->setPaused(isPaused));
-        sgpImplementation->mPaused.insert(*it);
-      }
+      nChannelId = FindSoundChannel("menumelody.wav");
+      nChannelId2 = FindSoundChannel("startup.wav");
     }
-  }
-  else /* Are we unpausing our paused sounds? */
-  {
-    Implementation::ChannelMap::iterator it = sgpImplementation->mPaused.begin();
-    while (it != sgpImplementation->mPaused.end() )
+    for ( int i = 0; i < Implementation::MAX_VOICES; ++i )
     {
-      Audio_Engine::ErrorCheck(it->second->setPaused(isPaused));
-      it = sgpImplementation->mPaused.erase(it);
+      Voice& voice = sgpImplementation->mVoices[i];
+      if ( voice.mnChannelId == -1 || voice.mnChannelId == nChannelId || voice.mnChannelId == nChannelId2 )
+      {
+        continue;
+      }
+      voice.mbMuteListed = false;
     }
   }
-#endif
 }
 
 /* This alters the priorty of a channel.
@@ -551,133 +897,67 @@ void Audio_Engine::SetAllChannelsMute( bool isMute )
    */
 void Audio_Engine::SetChannelPriority(int nChannelId, int priority)
 {
-  FMOD::Channel* target = NULL;
-  sgpImplementation->mpSystem->getChannel(nChannelId, &target );
-  target->setPriority(priority);
+  Voice* pVoice = sgpImplementation->FindVoice( nChannelId );
+  if ( !pVoice )
+  {
+    return;
+  }
+  pVoice->mnPriority = priority;
+  if ( pVoice->mbStarted )
+  {
+    AudioCommand command = AudioCommand();
+    command.mType = AudioCommand::SET_PRIORITY;
+    command.mnVoice = static_cast<int>( pVoice - sgpImplementation->mVoices );
+    command.mnValue = priority;
+    sgpImplementation->Send( command );
+  }
 }
 
 /* UNTESTED */
-void Audio_Engine::Set3dListenerAndOrientation(const Vector3& vPos, float fVolumedB)
+void Audio_Engine::Set3dListenerAndOrientation(const Vector3& vPos, float /*fVolumedB*/)
 {
-  const FMOD_VECTOR * vFPos = &VectorToFmod(vPos);
-  const FMOD_VECTOR * vFVel = &VectorToFmod( Vector3() );
-  sgpImplementation->mpSystem->set3DListenerAttributes(0, vFPos, vFVel, vFVel, vFVel );
+  AudioCommand command = AudioCommand();
+  command.mType = AudioCommand::SET_LISTENER;
+  command.mvPosition = vPos;
+  sgpImplementation->Send( command );
 }
 
-/* Finds the first channel which is playing a sound. */
+/* Finds the oldest channel which is playing a sound. */
 int Audio_Engine::FindSoundChannel(const string& strSoundName)
 {
-  for (Implementation::ChannelPlayingMap::iterator soundIt = sgpImplementation->mPlaying.begin(), itEnd = sgpImplementation->mPlaying.end(); soundIt != itEnd ; ++soundIt)
+  SoundHandle hSound = sgpImplementation->FindSound( strSoundName );
+  Voice* pFound = NULL;
+  for ( int i = 0; hSound != INVALID_SOUND && i < Implementation::MAX_VOICES; ++i )
   {
-    if ( soundIt->second == strSoundName )
-      return soundIt->first;
+    Voice& voice = sgpImplementation->mVoices[i];
+    if ( voice.mSound == hSound && ( !pFound || voice.mnStarted < pFound->mnStarted ) )
+    {
+      pFound = &voice;
+    }
+  }
+  if ( pFound )
+  {
+    return pFound->mnChannelId;
   }
   return -1; /* Magical number of doom that I hope never bites me. */
 }
 
+// A voice counts as playing until the audio thread says it has ended, or
+// it is stopped. Sounds still loading count too, they start when they can.
 bool Audio_Engine::IsPlaying(int nChannelId) const
 {
-  Implementation::ChannelMap::iterator channelIt = sgpImplementation->mChannels.find(nChannelId);
-  bool retval = false;
-  if ( channelIt != sgpImplementation->mChannels.end() )
-  {
-    channelIt->second->isPlaying(&retval);
-  }
-  return retval;
-}
-
-// This is mainly used in the callback function. It's faster than StopChannel,
-// and is more convenient for that function.
-void Audio_Engine::StopChannelPtr(FMOD::Channel* target)
-{
-  if ( !sgpImplementation->mChannels.empty() )
-  {
-    for (Implementation::ChannelMap::iterator it = sgpImplementation->mChannels.begin(); it != sgpImplementation->mChannels.end(); ++it)
-    {
-      //Have we found the channel?
-      if (it->second == target)
-      {
-        int nChannelId = it->first;
-        // Remove it from all containers.
-        sgpImplementation->mChannels.erase(it);
-        Implementation::ChannelPlayingMap::iterator pit = sgpImplementation->mPlaying.find(nChannelId);
-        std::string name = pit->second;
-        if (pit != sgpImplementation->mPlaying.end())
-        {
-          sgpImplementation->mPlaying.erase(pit);
-        }
-        Implementation::VolumeMap::iterator vit = sgpImplementation->mVolume.find(nChannelId);
-        if (vit != sgpImplementation->mVolume.end())
-        {
-          sgpImplementation->mVolume.erase(vit);
-        }
-        // Make sure it can't hide in the paused channel list.
-        Implementation::ChannelMap::iterator sit = sgpImplementation->mPaused.find(nChannelId);
-        if (sit != sgpImplementation->mPaused.end())
-        {
-          //sgpImplementation->mPaused.erase(sit);
-          target->setPaused(true);
-        }
-        else
-        {
-          target->stop();
-        }
-
-        unsigned count = getSoundCount(name); // these two lines decrement the count.
-        setSoundCount(name, --count);
-        break;
-      }
-    }
-  }
-  Update();
+  return sgpImplementation->FindVoice( nChannelId ) != NULL;
 }
 
 //Both stop and pause a channel. The surest way to kill it.
 // Also removes it from the Paused channel list.
 void Audio_Engine::StopChannel(int nChannelId)
 {
-  FMOD::Channel* target = NULL;
-  Implementation::ChannelMap::iterator it = sgpImplementation->mChannels.find(nChannelId);
-  if ( !sgpImplementation->mChannels.empty() && it != sgpImplementation->mChannels.end() )
+  Voice* pVoice = sgpImplementation->FindVoice( nChannelId );
+  if ( pVoice )
   {
-    target = it->second;
-    // Use the callback function to clean up.
-    target->stop();
+    sgpImplementation->FreeVoice( *pVoice );
   }
-  /*
-  if ( !sgpImplementation->mChannels.empty() )
-  {
-    for (Implementation::ChannelMap::iterator it = sgpImplementation->mChannels.begin(); it != sgpImplementation->mChannels.end(); ++it)
-    {
-      //Have we found the channel?
-      if (it->second == target)
-      {
-        nChannelId = it->first;
-        // Remove it from all containers.
-        sgpImplementation->mChannels.erase(it);
-        Implementation::ChannelPlayingMap::iterator pit = sgpImplementation->mPlaying.find(nChannelId);
-        if (pit != sgpImplementation->mPlaying.end())
-        {
-          sgpImplementation->mPlaying.erase(pit);
-        }
-        Implementation::VolumeMap::iterator vit = sgpImplementation->mVolume.find(nChannelId);
-        if (vit != sgpImplementation->mVolume.end())
-        {
-          sgpImplementation->mVolume.erase(vit);
-        }
-        // Make sure it can't hide in the paused channel list.
-        Implementation::ChannelMap::iterator sit = sgpImplementation->mPaused.find(nChannelId);
-        if (sit != sgpImplementation->mPaused.end())
-        {
-          sgpImplementation->mPaused.erase(sit);
-        }
-        target->stop();
-        break;
-      }
-    }
-  }
-  */
-  Update();
 }
 
 /*! \brief
@@ -689,73 +969,41 @@ void Audio_Engine::StopChannel(int nChannelId)
  */
 void Audio_Engine::StopEvent( const string &strEventName, bool bImmediate )
 {
-  Implementation::EventMap::iterator tFoundIt = sgpImplementation->mEvents.find( strEventName );
-  // Stop if we can't find the event.
-  if ( tFoundIt == sgpImplementation->mEvents.end() )
-  {
-    return;
-  }
-
-  FMOD_STUDIO_STOP_MODE eMode;
-  // Instant or fade?
-  eMode = bImmediate ? FMOD_STUDIO_STOP_IMMEDIATE : FMOD_STUDIO_STOP_ALLOWFADEOUT;
-  // Change the play mode.
-  Audio_Engine::ErrorCheck( tFoundIt->second->stop( eMode ) );
-}
-
-#if 0
-/*! \brief
- * Checks to see if an Event is currently playing.
- * \param strEventName
- * Specifies which event.
- * \return
- * True if playing, false otherwise.
- */
-bool Audio_Engine::IsEventPlaying( const string& strEventName ) const
-{
-  bool bIsPlaying = false;
-  Implementation::EventMap::iterator tFoundIt = sgpImplementation->mEvents.find( strEventName );
-  // Stop if we can't find the event.
-  if ( tFoundIt == sgpImplementation->mEvents.end() )
-  {
-    if ( DEBUG )
-    {
-      /* TODO: Make this debug later */
-    }
-  }
-  return tFoundIt->second->isPlaying();
+  AudioCommand command = AudioCommand();
+  command.mType = AudioCommand::STOP_EVENT;
+  command.mstrName = strEventName;
+  command.mnValue = bImmediate ? 1 : 0;
+  sgpImplementation->Send( command );
 }
-#endif
 
 /*! \brief
- * Gets information about an Event.
+ * Gets information about an Event. The audio thread can't be asked without
+ * waiting on it, so this gives back the last value SetEventParameter set.
  * \param strEventName
  * Specify the Event.
  * \param strParameterName
  * Specify the type of information being searched for.
  * \param parameter
- * Output - pointer to the value.
+ * Output - pointer to the value. Left alone if it was never set.
  */
 void Audio_Engine::GetEventParameter( const string &strEventName, const string &strParameterName, float* parameter )
 {
-  Implementation::EventMap::iterator tFoundIt = sgpImplementation->mEvents.find( strEventName );
+  map<string, map<string, float> >::iterator tFoundIt = sgpImplementation->mEventParameters.find( strEventName );
   // If you can't find it, stop.
-  if ( tFoundIt == sgpImplementation->mEvents.end() )
+  if ( tFoundIt == sgpImplementation->mEventParameters.end() )
   {
-    if ( DEBUG )
-    {
-      //TODO: Debug statement!
-    }
     return;
   }
 
-  FMOD::Studio::ParameterInstance* pParameter = NULL;
-  Audio_Engine::ErrorCheck( tFoundIt->second->getParameter( strParameterName.c_str(), &pParameter ) );
-  Audio_Engine::ErrorCheck( pParameter->getValue( parameter ) );
+  map<string, float>::iterator tParamIt = tFoundIt->second.find( strParameterName );
+  if ( tParamIt != tFoundIt->second.end() )
+  {
+    *parameter = tParamIt->second;
+  }
 }
 
 /*! \brief
- * Gets the value of an Event parameter.
+ * Sets the value of an Event parameter.
  * \param strEventName
  * Specifies the Event.
  * \param strParameterName
@@ -765,30 +1013,28 @@ void Audio_Engine::GetEventParameter( const string &strEventName, const string &
  */
 void Audio_Engine::SetEventParameter( const string &strEventName, const string &strParameterName, float fValue )
 {
-  Implementation::EventMap::iterator tFoundIt = sgpImplementation->mEvents.find( strEventName );
-  // If you can't find it, stop.
-  if ( tFoundIt == sgpImplementation->mEvents.end() )
-  {
-    if ( DEBUG )
-    {
-      //TODO: Debug statement!
-    }
-    return;
-  }
-
-  FMOD::Studio::ParameterInstance* pParameter = NULL;
-  Audio_Engine::ErrorCheck( tFoundIt->second->getParameter( strParameterName.c_str(), &pParameter ) );
-  Audio_Engine::ErrorCheck( pParameter->setValue( fValue ) );
+  sgpImplementation->mEventParameters[strEventName][strParameterName] = fValue;
+
+  AudioCommand command = AudioCommand();
+  command.mType = AudioCommand::SET_EVENT_PARAMETER;
+  command.mstrName = strEventName;
+  command.mstrParameter = strParameterName;
+  command.mfValue = fValue;
+  sgpImplementation->Send( command );
 }
 
 void Audio_Engine::SetGlobalVolumedB( float volume )
 {
   volume_ = volume;
 
-  for (Implementation::ChannelMap::iterator it = sgpImplementation->mChannels.begin(); it != sgpImplementation->mChannels.end(); ++it)
+  for ( int i = 0; i < Implementation::MAX_VOICES; ++i )
   {
+    if ( sgpImplementation->mVoices[i].mnChannelId == -1 )
+    {
+      continue;
+    }
     /* THIS ERASES PREVIOUS INFORMATION ON VOLUME! */
-    SetChannelVolume( it->first, volume_ );
+    SetChannelVolume( sgpImplementation->mVoices[i].mnChannelId, volume_ );
   }
 }
 
@@ -797,96 +1043,6 @@ float Audio_Engine::GetGlobalVolumedB()
   return volume_;
 }
 
-/*! \brief
- * Converts float vector into FMOD vector.
- * \param vPosition
- * Input values.
- * \return
- * FMOD vector.
- */
-FMOD_VECTOR VectorToFmod( const Vector3& vPosition )
-{
-  FMOD_VECTOR fVec;
-  fVec.x = vPosition.x;
-  fVec.y = vPosition.y;
-  fVec.z = vPosition.z;
-  return fVec;
-}
-
-FMOD_RESULT F_CALLBACK Audio_Engine::EndOfSound(FMOD_CHANNELCONTROL *chanControl,
-                                         FMOD_CHANNELCONTROL_TYPE controlType,
-                                         FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType,
-                                         void *commandData1,
-                                         void *commandData2)
-{
-  // Has the channel's sound ended?
-  if (controlType == FMOD_CHANNELCONTROL_CALLBACK_END)
-  {
-    FMOD::Channel *channel = (FMOD::Channel *)chanControl;
-    // Find the channel in our containers.
-
-    // Only stop the channel if it's actually done playing.
-    int nChannelId = -1;
-    if (!sgpImplementation->mChannels.empty())
-    {
-      GetAudioEngine()->StopChannelPtr(channel);
-    }
-  }
-  /*
-  else
-  {
-    FMOD::ChannelGroup *group = (FMOD::ChannelGroup *)chanControl;
-    // ChannelGroup specific functions here...
-  }
-  */
-
-  // ChannelControl generic functions here...
-
-    return FMOD_OK;
-}
-
-/*! \brief
- * Converts dB to volume.
- * \param dB
- * Input.
- * \return
- * Output volume value.
- */
-float dbToVolume( float dB )
-{
-    return powf(10.0f, 0.05f * dB);
-}
-
-/*! \brief
- * Converts volume to dB
- * \param volume
- * Input.
- * \return
- * Output dB value.
- */
-float VolumeTodb( float volume )
-{
-    return 20.0f * log10f(volume);
-}
-
-/*! \brief
- * Checks to see if FMOD encountered a problem.
- * \param result
- * Output from an FMOD function.
- * \return
- * Boolean, true is bad, false means everything is running smoothly.
- */
-int Audio_Engine::ErrorCheck( FMOD_RESULT result )
-{
-  if ( result != FMOD_OK )
-  {
-    Log<Error>("FMOD ERROR %d", result);
-    return 1;
-  }
-
-  return 0;
-}
-
 /*! \brief
  * Headshot the audio system with a silver bullet from a golden gun.
  * It's dead, Jim.
@@ -895,6 +1051,7 @@ int Audio_Engine::ErrorCheck( FMOD_RESULT result )
 void Audio_Engine::Shutdown()
 {
   delete sgpImplementation;
+  sgpImplementation = NULL;
 }
 
 static int PlaySoundsBind(Audio_Engine& AE, std::string str, float volume)
@@ -902,11 +1059,18 @@ static int PlaySoundsBind(Audio_Engine& AE, std::string str, float volume)
   return AE.PlaySounds(str, Vector3(), volume);
 }
 
+static int PlaySoundBind(Audio_Engine& AE, SoundHandle hSound, float volume)
+{
+  return AE.PlaySounds(hSound, Vector3(), volume);
+}
+
 luabind::scope Audio_Engine::GetLuaRegisters()
 {
   using namespace luabind;
   return class_<Audio_Engine>("Audio_Engine")
     .scope[def("getSystem", &GetAudioEngine)]
-    .def("PlaySounds",PlaySoundsBind);
-    
+    .def("PlaySounds",PlaySoundsBind)
+    .def("PlaySound",PlaySoundBind)
+    .def("GetSoundHandle",&Audio_Engine::GetSoundHandle);
+
 }
@@ -183,7 +183,6 @@ namespace Engine
 
   static void RotateBind(Camera& cam, float x, float y)
   {
-    //GFXPipe::get().SetLerpIsometric(x, y);
   }
 
   
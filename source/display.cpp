@@ -6,6 +6,8 @@
 #include <SDL2/SDL.h>
 
 #include "display.h"
+#include "FrameProfiler.h"
+#include "Timer.h"
 //#include "../include/Logger.h"
 
 
@@ -19,6 +21,8 @@
 // Frametime is calculated by a weighted average of the last few frames
 // frametimes is an array of the last couple values, equal to FRAME_VALUES
 
+const double Display::TARGET_FRAME_TIME = 1.0 / 60.0;
+
 /****************************************************************************/
 /*!
 \brief
@@ -107,19 +111,21 @@ void Display::Initialize(int width, int height, const std::string& win_title)
   memset(frametimes, 0, sizeof(frametimes));
   framecount = 0;
   framespersecond = 0;
-  frametimelast = SDL_GetTicks();
+  framestart = Engine::FrameProfiler::Now();
+  FrameClock::Publish(framestart);
 }
 
 /****************************************************************************/
 /*!
 \brief
-Updates the framtime of the display
+Updates the framtime of the display and hands the finished frame to the
+frame profiler
 */
 /****************************************************************************/
 void Display::UpdateFrameTime()
 {
   size_t frametimesindex;
-  size_t getticks;
+  unsigned long long now;
   size_t count;
   size_t i;
 
@@ -127,13 +133,17 @@ void Display::UpdateFrameTime()
   frametimesindex = framecount % FRAME_VALUES;
 
   // store the current time
-  getticks = SDL_GetTicks();
+  now = Engine::FrameProfiler::Now();
 
   // save the frame time value
-  frametimes[frametimesindex] = getticks - frametimelast;
+  frametimes[frametimesindex] = now - framestart;
+  Engine::FrameProfiler::EndFrame(now - framestart);
+
+  // save the start of this frame for the next update
+  framestart = now;
 
-  // save the last frame time for the next update
-  frametimelast = getticks;
+  // Every Timer reads this frame's time from here on
+  FrameClock::Publish(now);
 
   // increment the frame count
   framecount++;
@@ -160,7 +170,7 @@ void Display::UpdateFrameTime()
   framespersecond /= count;
 
   // Convert to FPS
-  framespersecond = 1000.0f / framespersecond;
+  framespersecond = 1000000000.0f / framespersecond;
 
 }
 
@@ -178,6 +188,39 @@ float Display::GetFrameTime()
   return 1.0f / framespersecond;
 }
 
+/****************************************************************************/
+/*!
+\brief
+Replaces the frame time until the next update. Used by input replays so the
+game steps by the recorded frame times
+
+\param dt
+Frame time in seconds
+*/
+/****************************************************************************/
+void Display::OverrideFrameTime(float dt)
+{
+  if (dt > 0)
+    framespersecond = 1.0f / dt;
+}
+
+/****************************************************************************/
+/*!
+\brief
+Gets how much time is left in the current frame before it goes over the
+target frame time
+
+\return
+Seconds left in the frame. Negative if the frame is already over
+*/
+/****************************************************************************/
+double Display::GetFrameTimeLeft() const
+{
+  double inFrame = (Engine::FrameProfiler::Now() - framestart) / 1000000000.0;
+
+  return TARGET_FRAME_TIME - inFrame;
+}
+
 /****************************************************************************/
 /*!
 \brief
@@ -6,6 +6,8 @@
 //  Copyright 1996-2017, DigiPen Institute of Technology (USA). All rights reserved.
 // FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
 // ---------------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include "../include/grid.h"
 //#include <functional>
@@ -13,8 +15,6 @@
 #include "../include/GSM.h"
 #include "../include/Stage.h"
 
-static int cycles = 0;
-
 static unsigned char northColl = 1 << 0;
 static unsigned char  westColl = 1 << 1;
 static unsigned char southColl = 1 << 2;
@@ -24,18 +24,22 @@ using namespace Logger;
 
 namespace Engine
 {
-  Grid::Grid() : stage_(nullptr), width_(0), height_(0), cycles_(0), groupIndex_(0), row_offset_(0), column_offset_(0), num_blocks_(0)
+  Grid::Grid() : stage_(nullptr), width_(0), height_(0), cycles_(0), groupIndex_(0), row_offset_(0), column_offset_(0), num_blocks_(0),
+    cellOrigin_(0), cellSize_(0), layoutRevision_(0)
   {
 
   }
 
-  Grid::Grid(Stage* stage, int width, int height) : stage_(stage), row_offset_(0), column_offset_(0), num_blocks_(0)
+  Grid::Grid(Stage* stage, int width, int height) : stage_(stage), row_offset_(0), column_offset_(0), num_blocks_(0),
+    cellOrigin_(0), cellSize_(0), layoutRevision_(0)
   {
     width_ = width;
     height_ = height;
     groupIndex_ = 0;
     cycles_ = 0;
     row_.reserve(height);
+    cellHeights_.assign(width * height, 0);
+    cellGroups_.assign(width * height, 0);
     CreateGrid(width, height);
     ParseGrid();
   }
@@ -97,6 +101,66 @@ namespace Engine
     for (int j = 0; j < height_ ; ++j)
       for (int i = 0; i < width_; ++i)
         DrawTile(row_[j][i], i, j);
+
+    UpdateCellTransform();
+  }
+
+  /****************************************************************************/
+  /*!
+  \brief
+  Caches where the tiles are in the world so positions can be turned into
+  tiles without asking the tiles. Rows and columns added later are drawn
+  relative to tile (0, 0), so it only needs updating when the whole grid is
+  drawn
+
+  */
+  /****************************************************************************/
+  void Grid::UpdateCellTransform()
+  {
+    if (height_ < 1 || width_ < 1 || row_[0][0] == 0)
+      return;
+
+    GameInstance& tile = stage_->getInstanceFromID(row_[0][0]);
+    cellOrigin_ = tile.RequestData<glm::vec2>("Position");
+    cellSize_ = tile.RequestData<glm::vec2>("TileScale");
+    ++layoutRevision_;
+  }
+
+  /****************************************************************************/
+  /*!
+  \brief
+  Gets the direction to move in to get around blocks and off the right side
+  of the grid, steering toward the center of the next tile
+
+  \param pos
+  World position to sample at
+
+  \return
+  Unit direction to move in. Straight ahead if the position is off the grid
+  or no route exists
+
+  */
+  /****************************************************************************/
+  glm::vec2 Grid::SampleFlow(const glm::vec2& pos) const
+  {
+    if (cellSize_.x <= 0 || cellSize_.y <= 0)
+      return glm::vec2(1, 0);
+
+    glm::vec2 local = (pos - cellOrigin_) / cellSize_;
+    glm::ivec2 cell(static_cast<int>(std::floor(local.x + 0.5f)), static_cast<int>(std::floor(local.y + 0.5f)));
+
+    if (cell.x < 0 || cell.x >= width_ || cell.y < 0 || cell.y >= height_)
+      return glm::vec2(1, 0);
+
+    glm::ivec2 step = flow_.GetDirection(cell.x, cell.y);
+    glm::vec2 target = cellOrigin_ + glm::vec2(cell + step) * cellSize_;
+    glm::vec2 toTarget = target - pos;
+    float distance = glm::length(toTarget);
+
+    if (distance < 0.001f)
+      return glm::vec2(step);
+
+    return toTarget / distance;
   }
 
   void Grid::DrawRow(const std::vector<unsigned long>& vec)
@@ -117,12 +181,14 @@ namespace Engine
     for (int i = 0; i < width_; ++i)
     {
       unsigned int tile = CreateTile(height_, i);
+      stage_->getInstanceFromID(tile).PostMessage("SetTilePos", Message<glm::vec2>(glm::vec2(i, height_)));
       vec.push_back(tile);
     }
 
     row_.push_back(vec);
     
     DrawRow(vec);
+    ResizeCells(width_, height_ + 1);
     ++height_;
    
   }
@@ -143,12 +209,14 @@ namespace Engine
     for (int i = 0; i < height_; ++i)
     {
       unsigned int tile = CreateTile(i, width_);
+      stage_->getInstanceFromID(tile).PostMessage("SetTilePos", Message<glm::vec2>(glm::vec2(width_, i)));
       vec.push_back(tile);
       row_[i].push_back(tile);
       
     }
     
     DrawColumn(vec);
+    ResizeCells(width_ + 1, height_);
     ++width_;
   }
 
@@ -195,6 +263,7 @@ namespace Engine
       RemoveTile(i, height_ - 1);
     }
     row_.pop_back();
+    ResizeCells(width_, height_ - 1);
     --height_;
     --column_offset_;
   }
@@ -209,6 +278,7 @@ namespace Engine
       RemoveTile(width_ - 1, i);
       row_[i].pop_back();
     }
+    ResizeCells(width_ - 1, height_);
     --width_;
     --row_offset_;
   }
@@ -221,49 +291,23 @@ namespace Engine
     }
     else
     {
-      if (stage_->getInstanceFromID(row_[y][x]).RequestData<int>("TileGroup") != 0)
-      {
-        return true;
-      }
+      return cellGroups_[CellIndex(x, y)] != 0;
     }
-
-    return false;
   }
 
   bool Grid::CheckIfTileIsGrouped(int x, int y)
-  {
-    if (CheckIfTileIsOccupied(x, y))
-    {
-      if (stage_->getInstanceFromID(row_[y][x]).RequestData<int>("TileGroup") == 1)
-      {
-        return false;
-      }
-      else
-      {
-        return true;
-      }
-    }
-
-    return false;
-  }
-
-  bool Grid::CheckIfTileIsNotGrouped(int x, int y)
   {
     if (x >= width_ || y >= height_ || x < 0 || y < 0)
     {
       return false;
     }
-    else if (stage_->getInstanceFromID(row_[y][x]).RequestData<int>("TileGroup") == 1)
-    {
-      return true;
-    }
     else
     {
-      return false;
+      return cellGroups_[CellIndex(x, y)] > 1;
     }
   }
 
-  bool Grid::CheckIfTileIsValid(int x, int y)
+  bool Grid::CheckIfTileIsNotGrouped(int x, int y)
   {
     if (x >= width_ || y >= height_ || x < 0 || y < 0)
     {
@@ -271,10 +315,15 @@ namespace Engine
     }
     else
     {
-      return CheckIfTileIsGrouped(x, y);
+      return cellGroups_[CellIndex(x, y)] == 1;
     }
   }
 
+  bool Grid::CheckIfTileIsValid(int x, int y)
+  {
+    return CheckIfTileIsGrouped(x, y);
+  }
+
   unsigned char Grid::CheckAround(int x, int y)
   {
     unsigned char bitfield = 0;
@@ -291,23 +340,6 @@ namespace Engine
     return bitfield;
   }
 
-  unsigned char Grid::CheckUngrouped(int x, int y)
-  {
-    unsigned char bitfield = 0;
-
-    if (CheckIfTileIsNotGrouped(x, y + 1))
-      bitfield |= northColl;
-    if (CheckIfTileIsNotGrouped(x - 1, y))
-      bitfield |= westColl;
-    if (CheckIfTileIsNotGrouped(x, y - 1))
-      bitfield |= southColl;
-    if (CheckIfTileIsNotGrouped(x + 1, y))
-      bitfield |= eastColl;
-
-    cycles++;
-    return bitfield;
-  }
-
   int Grid::PushTile(int x, int y, unsigned long ID)
   {
     Log<Info>("PushTile Called");
@@ -329,7 +361,7 @@ namespace Engine
     {
       return 0;
     }
-    else if (!stage_->getInstanceFromID(row_[y][x]).RequestData<int>("TileHeight"))
+    else if (!cellHeights_[CellIndex(x, y)])
     {
       return 0;
     }
@@ -345,571 +377,403 @@ namespace Engine
   /****************************************************************************/
   /*!
   \brief
-  Groups the structure given by x and y to the given index.
-  Works when given any point within the ungrouped grid as input
-  Uses a recursive backtracking maze generation algorithm to traverse the structure
-  Catalogues how many cycles it took to parse the entire structure
+  Updates the grouping after a block has been placed on a tile. A block placed
+  on an empty tile joins the group of its neighbors, merging every neighboring
+  group into the largest one. Only the affected groups are touched.
 
   \param x
-  An x value that is in the ungrouped structure
+  The x position of the tile
 
   \param y
-  A y value that is in the ungrouped structure
+  The y position of the tile
 
-  \param index
-  The group to set the group to
+  \param height
+  The number of blocks on the tile after the push
 
   */
   /****************************************************************************/
-  void Grid::Group(int x, int y, int index)
+  void Grid::OnBlockPushed(int x, int y, int height)
   {
-    unsigned char PossibleMoves = CheckUngrouped(x, y);
-
-    while (PossibleMoves)
-    {
-      int newX;
-      int newY;
-
-      stage_->getInstanceFromID(row_[y][x]).PostMessage("SetTileGroup", Message<int>(-1));
-      ChooseNextPosition(x, y, PossibleMoves, &newX, &newY);
-      Group(newX, newY, index);
-
-      PossibleMoves = CheckUngrouped(x, y);
-    }
-
-    stage_->getInstanceFromID(row_[y][x]).PostMessage("SetTileGroup", Message<int>(index));
-    cycles_ += cycles;
-    cycles = 0;
-    return;
-  }
-
-  /****************************************************************************/
-  /*!
-  \brief
-  Calculates which direction to traverse to when given a list of possible moves
-
-  \param x
-  The current x location
-
-  \param y
-  The current y location
-
-  \param possibleMoves
-  The bitfield of possible directions to go
+    int cell = CellIndex(x, y);
+    cellHeights_[cell] = height;
+    cycles_ = 1;
 
-  \param newX
-  The location to place the next position X
+    flow_.SetBlocked(x, y, true);
 
-  \param newY
-  The location to place the next position Y
-
-  */
-  /****************************************************************************/
-  void Grid::ChooseNextPosition(int x, int y, unsigned char possibleMoves, int* newX, int* newY)
-  {
-    if (southColl & possibleMoves)
+    // Stacking onto an existing group only changes its height map
+    if (cellGroups_[cell] > 1)
     {
-      *newX = x;
-      *newY = y - 1;
+      UpdateStructure(cellGroups_[cell]);
       return;
     }
-    if (eastColl & possibleMoves)
-    {
-      *newX = x + 1;
-      *newY = y;
-      return;
-    }
-    if (northColl & possibleMoves)
+
+    std::set<int> neighbors;
+    const int dx[] = { 0, -1, 0, 1 };
+    const int dy[] = { 1, 0, -1, 0 };
+
+    for (int i = 0; i < 4; ++i)
     {
-      *newX = x;
-      *newY = y + 1;
-      return;
+      if (CheckIfTileIsGrouped(x + dx[i], y + dy[i]))
+        neighbors.insert(cellGroups_[CellIndex(x + dx[i], y + dy[i])]);
     }
-    if (westColl & possibleMoves)
+
+    if (neighbors.empty())
     {
-      *newX = x - 1;
-      *newY = y;
+      int group = FindNextOpenGroupNumber();
+      GroupInfo& info = groupInfo_[group];
+      info.minX = info.maxX = x;
+      info.minY = info.maxY = y;
+      AddCellToGroup(cell, group);
+      groups_.insert(group);
+      CreateStructure(group);
       return;
     }
-  }
 
-  /****************************************************************************/
-  /*!
-  \brief
-  Resets the groupings and heights of every tile in the grid and clears
-  the structlist and groups containers
+    // The largest group survives so the fewest tiles get relabeled
+    int survivor = *neighbors.begin();
 
-  */
-  /****************************************************************************/
-  void Grid::ResetGrid()
-  {
-    groupIndex_ = 1;
+    for (int group : neighbors)
+    {
+      if (groupInfo_[group].cells.size() > groupInfo_[survivor].cells.size())
+        survivor = group;
+    }
 
-    for (int i = 0; i < height_; ++i)
+    for (int group : neighbors)
     {
-      for (int j = 0; j < width_; ++j)
-      {
-        GameInstance& tile = stage_->getInstanceFromID(row_[i][j]);
-        if (tile.RequestData<int>("TileGroup") > 1)
-        {
-          tile.PostMessage("SetTileGroup", Message<int>(0));
-          tile.PostMessage("SetTileHeight", Message<int>(0));
-        }
-      }
+      if (group != survivor)
+        MergeGroupInto(group, survivor);
     }
 
-    structList_.clear();
-    groups_.clear();
+    AddCellToGroup(cell, survivor);
+    UpdateStructure(survivor);
   }
 
-  
-
   /****************************************************************************/
   /*!
   \brief
-  Increments the group index and groups the structure from given position within
-  the structure. OLD CODE DO NOT USE
+  Updates the grouping after a block has been removed from a tile. Removing the
+  last block of a tile re-splits only the group it belonged to.
 
   \param x
-  x pos in grid
+  The x position of the tile
 
   \param y
-  y pos in grid
+  The y position of the tile
+
+  \param height
+  The number of blocks on the tile after the pop
 
   */
   /****************************************************************************/
-  void Grid::GroupStructureFrom(int x, int y)
+  void Grid::OnBlockPopped(int x, int y, int height)
   {
-    groupIndex_++;
-    Group(x, y, groupIndex_);
-  }
+    int cell = CellIndex(x, y);
+    int group = cellGroups_[cell];
+    cellHeights_[cell] = height;
+    cycles_ = 1;
 
-  /****************************************************************************/
-  /*!
-  \brief
-  Finds every non-grouped structure and groups them into a group
+    if (height == 0)
+      flow_.SetBlocked(x, y, false);
 
-  */
-  /****************************************************************************/
-  void Grid::GroupStructures()
-  {
-    for (int i = 0; i < height_; ++i)
+    if (group <= 1)
     {
-      for (int j = 0; j < width_; ++j)
-      {
-        if (CheckIfTileIsNotGrouped(j, i))
-        {
-          GroupStructureFrom(j, i);
-        }
-      }
+      if (height == 0)
+        SetCellGroup(cell, 0);
+      return;
     }
-  }
 
-  void Grid::ParseGrid()
-  {
-    cycles_ = 0;
-    ResetGroups();
-    SetTileData();
-    GroupStructures();
-  }
-
-  /****************************************************************************/
-  /*!
-  \brief
-  Sets every tile's XY data so it knows where it is in the grid
-
-  */
-  /****************************************************************************/
-  void Grid::SetTileData()
-  {
-    for (int i = 0; i < height_; ++i)
+    if (height > 0)
     {
-      for (int j = 0; j < width_; ++j)
-      {
-        stage_->getInstanceFromID(row_[i][j]).PostMessage("SetTilePos", Message<glm::vec2>(glm::vec2(j, i)));
-      }
+      UpdateStructure(group);
+      return;
     }
-  }
 
-  /****************************************************************************/
-  /*!
-  \brief
-  Resets every group in the grid
-  Sets every grouped value's group to 1(ungrouped)
+    GroupInfo& info = groupInfo_[group];
+    info.cells.erase(std::find(info.cells.begin(), info.cells.end(), cell));
+    SetCellGroup(cell, 0);
 
-  */
-  /****************************************************************************/
-  void Grid::ResetGroups()
-  {
-    groupIndex_ = 1;
+    structList_.erase(group);
 
-    for (int i = 0; i < height_; ++i)
+    if (info.cells.empty())
     {
-      for (int j = 0; j < width_; ++j)
-      {
-        GameInstance& tile = stage_->getInstanceFromID(row_[i][j]);
-        if (tile.RequestData<int>("TileGroup") > 1)
-        {
-          tile.PostMessage("SetTileGroup", Message<int>(1));
-        }
-      }
+      groupInfo_.erase(group);
+      groups_.erase(group);
+    }
+    else
+    {
+      SplitGroup(group);
     }
   }
 
   /****************************************************************************/
   /*!
   \brief
-  Finds the first grid position instance of the given group
+  Resizes the cell arrays to the given grid size, keeping the cells that are
+  still inside the grid
 
-  \return
-  The vec2 of grid position x and y where the first instance of the group is
+  \param width
+  The new width of the grid
 
-  \param group
-  The group to find the first instance of
+  \param height
+  The new height of the grid
 
   */
   /****************************************************************************/
-  glm::vec2 Grid::GetFirstPosInstanceOfGroup(int group)
+  void Grid::ResizeCells(int width, int height)
   {
-    bool foundTop = false;
-    int minX = width_;
-    int maxY = -1;
+    std::vector<int> heights(width * height, 0);
+    std::vector<int> groups(width * height, 0);
 
-    for (int i = 0; i < height_; ++i)
+    for (int j = 0; j < height && j < height_; ++j)
     {
-      for (int j = 0; j < width_; ++j)
+      for (int i = 0; i < width && i < width_; ++i)
       {
-        if (stage_->getInstanceFromID(row_[i][j]).RequestData<int>("TileGroup") == group)
-        {
-          if (!foundTop)
-          {
-            maxY = i;
-            foundTop = true;
-          }
-
-          if (j < minX)
-          {
-            minX = j;
-          }
-        }
+        heights[j * width + i] = cellHeights_[CellIndex(i, j)];
+        groups[j * width + i] = cellGroups_[CellIndex(i, j)];
       }
     }
 
-    return glm::vec2(minX, maxY);
+    for (auto& group : groupInfo_)
+    {
+      for (int& cell : group.second.cells)
+        cell = (cell / width_) * width + cell % width_;
+    }
+
+    cellHeights_.swap(heights);
+    cellGroups_.swap(groups);
+
+    // The goal column moves with the right edge, so everything reroutes
+    flow_.Rebuild(width, height, cellHeights_);
+    ++layoutRevision_;
   }
 
   /****************************************************************************/
   /*!
   \brief
-  Gets the width of the structure in the grid
+  Sets the group of a cell, notifying the tile only when the group changed
 
-  \return
-  The width of the structure
-
-  \param gX
-  The first x position of the structure
-
-  \param gY
-  The first y position of the structure
+  \param cell
+  The index of the cell
 
   \param group
-  The group to find the width of
+  The group to set the cell to
 
   */
   /****************************************************************************/
-  int Grid::GetStructWidthFromGroup(int gX, int gY, int group)
+  void Grid::SetCellGroup(int cell, int group)
   {
-    int maxX = -1;
+    if (cellGroups_[cell] == group)
+      return;
 
-    for (int i = gY; i < height_; ++i)
-    {
-      for (int j = gX; j < width_; ++j)
-      {
-        if (stage_->getInstanceFromID(row_[i][j]).RequestData<int>("TileGroup") == group)
-        {
-          if (j > maxX)
-          {
-            maxX = j;
-          }
-        }
-      }
-    }
+    cellGroups_[cell] = group;
 
-    return maxX - gX + 1;
+    unsigned long tile = row_[cell / width_][cell % width_];
+    if (tile)
+      stage_->getInstanceFromID(tile).PostMessage("SetTileGroup", Message<int>(group));
   }
 
-  /****************************************************************************/
-  /*!
-  \brief
-  Gets the height of the structure in the grid
-
-  \return
-  The height of the structure
-
-  \param gX
-  The first x position of the structure
-
-  \param gY
-  The first y position of the structure
-
-  \param group
-  The group to find the height of
-
-  */
-  /****************************************************************************/
-  int Grid::GetStructHeightFromGroup(int gX, int gY, int group)
+  void Grid::AddCellToGroup(int cell, int group)
   {
-    int maxY = -1;
+    GroupInfo& info = groupInfo_[group];
+    int x = cell % width_;
+    int y = cell / width_;
 
-    for (int i = gY; i < height_; ++i)
-    {
-      for (int j = gX; j < width_; ++j)
-      {
-        if (stage_->getInstanceFromID(row_[i][j]).RequestData<int>("TileGroup") == group)
-        {
-          if (i > maxY)
-          {
-            maxY = i;
-          }
-        }
-      }
-    }
+    info.cells.push_back(cell);
+    info.minX = std::min(info.minX, x);
+    info.minY = std::min(info.minY, y);
+    info.maxX = std::max(info.maxX, x);
+    info.maxY = std::max(info.maxY, y);
 
-    return maxY - gY + 1;
+    SetCellGroup(cell, group);
   }
 
   /****************************************************************************/
   /*!
   \brief
-  Copies over the height values from the grid onto the given struct by giving the
-  topleft and bottomright xy positions in the grid
+  Moves every tile of a group into another group and removes the old group
 
-  \param nStruct
-  The structure to copy to
-
-  \param iX
-  The topleft X
+  \param from
+  The group to merge
 
-  \param iY
-  The topleft Y
-
-  \param lX
-  The bottomright X
-
-  \param lY
-  The bottomright Y
+  \param into
+  The group to merge into
 
   */
   /****************************************************************************/
-  void Grid::CopyStructFromGridFromTo(Structure& nStruct, int iX, int iY, int lX, int lY)
+  void Grid::MergeGroupInto(int from, int into)
   {
-    for (int i = iY, k = 0; i < lY, k < nStruct.GetY(); ++i, ++k)
-    {
-      for (int j = iX, l = 0; j < lX, l < nStruct.GetX(); ++j, ++l)
-      {
-        nStruct.GetGrid()[k][l]->SetHeight(stage_->getInstanceFromID(row_[i][j]).RequestData<int>("TileHeight"));
-      }
-    }
+    GroupInfo& src = groupInfo_[from];
+
+    for (int cell : src.cells)
+      AddCellToGroup(cell, into);
+
+    cycles_ += src.cells.size();
+
+    groupInfo_.erase(from);
+    groups_.erase(from);
+    structList_.erase(from);
   }
 
   /****************************************************************************/
   /*!
   \brief
-  Gets all the tiles from a given group and returns them as a vector
-
-  \return
-  the vector of tiles that correspond to the structure
+  Splits a group into its connected parts after a tile was removed from it.
+  Only the tiles of the group are visited. The first part keeps the group
+  number and every other part gets a new one.
 
   \param group
-  The group to gather the tiles for
+  The group to split
 
   */
   /****************************************************************************/
-  std::vector<unsigned long> Grid::GetTilePtrsFromGroup(int group)
+  void Grid::SplitGroup(int group)
   {
-    std::vector<unsigned long> children;
+    std::vector<int> cells;
+    cells.swap(groupInfo_[group].cells);
+    groupInfo_.erase(group);
+    groups_.erase(group);
 
-    for (int i = 0; i < width_; ++i)
+    // Mark the old tiles as unvisited
+    for (int cell : cells)
+      cellGroups_[cell] = -1;
+
+    std::vector<int> stack;
+    const int dx[] = { 0, -1, 0, 1 };
+    const int dy[] = { 1, 0, -1, 0 };
+    int current = (group > 1) ? group : FindNextOpenGroupNumber();
+
+    for (int start : cells)
     {
-      for (int j = 0; j < height_; ++j)
-      {
-        if (stage_->getInstanceFromID(row_[j][i]).RequestData<int>("TileGroup") == group)
-        {
-          children.push_back(row_[j][i]);
-        }
-      }
-    }
+      if (cellGroups_[start] != -1)
+        continue;
 
-    return children;
-  }
+      GroupInfo& info = groupInfo_[current];
+      info.minX = info.maxX = start % width_;
+      info.minY = info.maxY = start / width_;
+      groups_.insert(current);
 
-  std::set<int> Grid::FindModifiedGroups(int x, int y)
-  {
-    std::set<int> tGroups;
-    int CurrGroup = stage_->getInstanceFromID(row_[y][x]).RequestData<int>("TileGroup");
+      // Restore the old label first so unchanged tiles are not notified
+      cellGroups_[start] = group;
+      AddCellToGroup(start, current);
+      stack.push_back(start);
 
-    if (CurrGroup > 1)
-    {
-      tGroups.insert(CurrGroup);
-    }
-    else
-    {
-      int nGroup = 0, wGroup = 0, sGroup = 0, eGroup = 0;
-
-      if (CheckIfTileIsValid(x, y + 1))
-        nGroup = stage_->getInstanceFromID(row_[y + 1][x]).RequestData<int>("TileGroup");
-      if (CheckIfTileIsValid(x - 1, y))
-        wGroup = stage_->getInstanceFromID(row_[y][x - 1]).RequestData<int>("TileGroup");
-      if (CheckIfTileIsValid(x, y - 1))
-        sGroup = stage_->getInstanceFromID(row_[y - 1][x]).RequestData<int>("TileGroup");
-      if (CheckIfTileIsValid(x + 1, y))
-        eGroup = stage_->getInstanceFromID(row_[y][x + 1]).RequestData<int>("TileGroup");
-
-      if (nGroup)
-      {
-        tGroups.insert(nGroup);
-      }
-      if (wGroup)
+      while (!stack.empty())
       {
-        tGroups.insert(wGroup);
-      }
-      if (sGroup)
-      {
-        tGroups.insert(sGroup);
-      }
-      if (eGroup)
-      {
-        tGroups.insert(eGroup);
-      }
+        int cell = stack.back();
+        stack.pop_back();
+        ++cycles_;
 
-      tGroups.erase(0);
-    }
+        int x = cell % width_;
+        int y = cell / width_;
 
-    return tGroups;
-  }
+        for (int i = 0; i < 4; ++i)
+        {
+          int nx = x + dx[i];
+          int ny = y + dy[i];
 
-  int Grid::FindModifiedGroupOnRemove(int x, int y)
-  {
-    //if (stage_->getInstanceFromID(row_[y][x]).RequestData<int>("TileHeight") == 0)
-    //  return 0;
+          if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_)
+            continue;
 
-    std::set<int> t = FindModifiedGroups(x, y);
+          int next = CellIndex(nx, ny);
 
-    if (t.size())
-      return *(t.begin());
-    else
-      return 0;
+          if (cellGroups_[next] == -1)
+          {
+            cellGroups_[next] = group;
+            AddCellToGroup(next, current);
+            stack.push_back(next);
+          }
+        }
+      }
+
+      CreateStructure(current);
+      current = FindNextOpenGroupNumber();
+    }
   }
 
   /****************************************************************************/
   /*!
   \brief
-  Finds every ungrouped structure in the grid and groups them into separate
-  structures
+  Resets the groupings and heights of every tile in the grid and clears
+  the structlist and groups containers
 
   */
   /****************************************************************************/
-  void Grid::GroupUngroupedStructures()
+  void Grid::ResetGrid()
   {
+    groupIndex_ = 1;
+
     for (int i = 0; i < height_; ++i)
     {
       for (int j = 0; j < width_; ++j)
       {
-        if (stage_->getInstanceFromID(row_[i][j]).RequestData<int>("TileGroup") == 1)
+        int cell = CellIndex(j, i);
+
+        if (cellGroups_[cell] > 1)
         {
-          int group = FindNextOpenGroupNumber();
-          Group(j, i, group);
-          CullStructures();
-          CreateStructure(group);
+          SetCellGroup(cell, 0);
+          stage_->getInstanceFromID(row_[i][j]).PostMessage("SetTileHeight", Message<int>(0));
+          cellHeights_[cell] = 0;
         }
       }
     }
+
+    structList_.clear();
+    groups_.clear();
+    groupInfo_.clear();
+
+    flow_.Rebuild(width_, height_, cellHeights_);
   }
 
   /****************************************************************************/
   /*!
   \brief
-  Parses the list of given groups once tile has been added. Much faster than
-  reparsing entire grid since it only affects modified groups. Also keeps old
-  grouping values so modifying structures is much easier.
-
-  \param tGroups
-  The set of groups that are being modified
+  Sets the tile data and regroups every occupied tile in the grid from scratch
 
   */
   /****************************************************************************/
-  void Grid::ParseGroups(const std::set<int>& tGroups)
+  void Grid::ParseGrid()
   {
-    if (tGroups.size() > 1)
-    {
-      int GroupToMergeInto = *(tGroups.begin());
-
-      for (auto& GroupsIter : tGroups)
-      {
-        ResetGroupInGrid(GroupsIter);
-      }
-
-      SetUngroupedStructureTo(GroupToMergeInto);
+    cycles_ = 0;
+    groupIndex_ = 1;
+    SetTileData();
 
-      for (auto iter = tGroups.begin(); iter != tGroups.end(); ++iter)
-      {
-        if (*iter == GroupToMergeInto)
-        {
+    structList_.clear();
+    groups_.clear();
+    groupInfo_.clear();
 
-        }
-        else
-        {
-          groups_.erase(*iter);
-        }
-      }
+    // Put every occupied tile into one group and split it into its parts
+    GroupInfo& all = groupInfo_[1];
 
-      CullStructures();
-      UpdateStructure(GroupToMergeInto);
-    }
-    else if (tGroups.size() == 1)
+    for (int cell = 0; cell < width_ * height_; ++cell)
     {
-      SetUngroupedStructureAdditionTo(*(tGroups.begin()));
-      UpdateStructure(*(tGroups.begin()));
+      if (cellHeights_[cell] > 0)
+        all.cells.push_back(cell);
+      else
+        SetCellGroup(cell, 0);
     }
+
+    if (all.cells.empty())
+      groupInfo_.erase(1);
     else
-    {
-      int newGroupIndex = FindNextOpenGroupNumber();
+      SplitGroup(1);
 
-      SetUngroupedStructureTo(newGroupIndex);
-      groups_.insert(newGroupIndex);
-      CreateStructure(newGroupIndex);
-    }
-  }
-
-  void Grid::ParseRemovedGroup(int group)
-  {
-    ResetGroupInGrid(group);
-    structList_.erase(group);
-    groups_.erase(group);
-    GroupUngroupedStructures();
+    flow_.Rebuild(width_, height_, cellHeights_);
   }
 
   /****************************************************************************/
   /*!
   \brief
-  Resets the given group in the grid by setting every group value to 1
-
-  \param group
-  The group to reset
+  Sets every tile's XY data so it knows where it is in the grid
 
   */
   /****************************************************************************/
-  void Grid::ResetGroupInGrid(int group)
+  void Grid::SetTileData()
   {
     for (int i = 0; i < height_; ++i)
     {
       for (int j = 0; j < width_; ++j)
       {
-        GameInstance& tile = stage_->getInstanceFromID(row_[i][j]);
-        if (tile.RequestData<int>("TileGroup") == group)
-        {
-          tile.PostMessage("SetTileGroup", Message<int>(1));
-        }
+        stage_->getInstanceFromID(row_[i][j]).PostMessage("SetTilePos", Message<glm::vec2>(glm::vec2(j, i)));
       }
     }
   }
@@ -917,55 +781,66 @@ namespace Engine
   /****************************************************************************/
   /*!
   \brief
-  Finds the first ungrouped grid and groups it to the given group number
+  Copies the heights of a group's tiles onto the given struct. Tiles inside the
+  bounding box that belong to other groups are left empty.
 
-  \param group
-  The group to set the first ungrouped structure to
+  \param nStruct
+  The structure to copy to
+
+  \param info
+  The group to copy from
 
   */
   /****************************************************************************/
-  void Grid::SetUngroupedStructureTo(int group)
+  void Grid::CopyGroupToStructure(Structure& nStruct, const GroupInfo& info)
   {
-    //Log<Info>("SetUngroupedStructureTo");
-
-    for (int i = 0; i < height_; ++i)
+    for (int i = info.minY, k = 0; i <= info.maxY; ++i, ++k)
     {
-      for (int j = 0; j < width_; ++j)
+      for (int j = info.minX, l = 0; j <= info.maxX; ++j, ++l)
       {
-        if (CheckIfTileIsNotGrouped(j, i))
-        {
-          Group(j, i, group);
-          return;
-        }
+        nStruct.GetTile(l, k).SetHeight(0);
       }
     }
+
+    for (int cell : info.cells)
+    {
+      int k = cell / width_ - info.minY;
+      int l = cell % width_ - info.minX;
+      nStruct.GetTile(l, k).SetHeight(cellHeights_[cell]);
+    }
   }
 
   /****************************************************************************/
   /*!
   \brief
-  Finds the first ungrouped grid and groups it to the given group number
+  Gets all the tiles from a given group and returns them as a vector, ordered
+  by column then row
 
-  \param group
-  The group to set the first ungrouped structure to
+  \return
+  the vector of tiles that correspond to the structure
+
+  \param info
+  The group to gather the tiles for
 
   */
   /****************************************************************************/
-  void Grid::SetUngroupedStructureAdditionTo(int group)
+  std::vector<unsigned long> Grid::GetTilesFromGroup(const GroupInfo& info)
   {
-    //Log<Info>("SetUngroupedStructureAdditionTo");
+    std::vector<int> cells(info.cells);
+    const int width = width_;
 
-    for (int i = 0; i < height_; ++i)
+    std::sort(cells.begin(), cells.end(), [width](int lhs, int rhs)
     {
-      for (int j = 0; j < width_; ++j)
-      {
-        if (CheckIfTileIsNotGrouped(j, i))
-        {
-          stage_->getInstanceFromID(row_[i][j]).PostMessage("SetTileGroup", Message<int>(group));
-          return;
-        }
-      }
-    }
+      return std::make_pair(lhs % width, lhs / width) < std::make_pair(rhs % width, rhs / width);
+    });
+
+    std::vector<unsigned long> children;
+    children.reserve(cells.size());
+
+    for (int cell : cells)
+      children.push_back(row_[cell / width_][cell % width_]);
+
+    return children;
   }
 
   /****************************************************************************/
@@ -980,74 +855,46 @@ namespace Engine
   /****************************************************************************/
   void Grid::UpdateStructure(int group)
   {
-    glm::vec2 firstPos = GetFirstPosInstanceOfGroup(group);
+    auto infoIter = groupInfo_.find(group);
+    auto structIter = structList_.find(group);
 
-    if (int(firstPos.x) == -1 || int(firstPos.y) == -1)
+    if (infoIter == groupInfo_.end() || structIter == structList_.end())
     {
+      Log<Error>("Failed to delete old structure instance!");
+      return;
     }
-    else
-    {
-      int structWidth = GetStructWidthFromGroup(static_cast<int>(firstPos.x), static_cast<int>(firstPos.y), group);
-      int structHeight = GetStructHeightFromGroup(static_cast<int>(firstPos.x), static_cast<int>(firstPos.y), group);
-      std::vector<unsigned long> children = GetTilePtrsFromGroup(group);
-
-      auto ent = structList_.at(group);
 
-      ent->GetEntity()->PostMessage<std::string>("UnloadStructure", "");
+    structIter->second->GetEntity()->PostMessage<std::string>("UnloadStructure", "");
+    structList_.erase(structIter);
 
-      if( structList_.erase(group))
-      {
-        std::shared_ptr<Structure> nStructPtr = std::make_shared<Structure>(group, children);
-
-        //Log<Info>("Struct %d Width: %d, Height: %d", group, structWidth, structHeight);
-
-        nStructPtr->SetWidth(structWidth);
-        nStructPtr->SetHeight(structHeight);
-        nStructPtr->SetStage(stage_);
-
-        CopyStructFromGridFromTo(*nStructPtr, static_cast<int>(firstPos.x), static_cast<int>(firstPos.y),
-          static_cast<int>(firstPos.x + structWidth), static_cast<int>(firstPos.y + structHeight));
-
-        nStructPtr->SetStructureEntity();
-      
-        structList_.insert(std::make_pair(group, nStructPtr));
-      }
-      else
-      {
-        Log<Error>("Failed to delete old structure instance!");
-      }
-    }
+    CreateStructure(group);
   }
 
 
  void Grid::CreateStructure(int group)
   {
-    glm::vec2 firstPos = GetFirstPosInstanceOfGroup(group);
+    auto infoIter = groupInfo_.find(group);
 
-    if (int(firstPos.x) == -1 || int(firstPos.y) == -1)
-    {
-    }
-    else
-    {
-      int structWidth = GetStructWidthFromGroup(static_cast<int>(firstPos.x), static_cast<int>(firstPos.y), group);
-      int structHeight = GetStructHeightFromGroup(static_cast<int>(firstPos.x), static_cast<int>(firstPos.y), group);
-      std::vector<unsigned long> children = GetTilePtrsFromGroup(group);
-      std::shared_ptr<Structure> nStructPtr(new Structure(group, children));
+    if (infoIter == groupInfo_.end())
+      return;
 
-     // Log<Info>("Struct %d Width: %d, Height: %d", group, structWidth, structHeight);
+    const GroupInfo& info = infoIter->second;
+    int structWidth = info.maxX - info.minX + 1;
+    int structHeight = info.maxY - info.minY + 1;
+    std::shared_ptr<Structure> nStructPtr(new Structure(group, GetTilesFromGroup(info)));
 
-      nStructPtr->SetWidth(structWidth);
-      nStructPtr->SetHeight(structHeight);
-      nStructPtr->SetStage(stage_);
+   // Log<Info>("Struct %d Width: %d, Height: %d", group, structWidth, structHeight);
 
-      CopyStructFromGridFromTo(*nStructPtr, static_cast<int>(firstPos.x), static_cast<int>(firstPos.y),
-        static_cast<int>(firstPos.x + structWidth), static_cast<int>(firstPos.y + structHeight));
+    nStructPtr->SetWidth(structWidth);
+    nStructPtr->SetHeight(structHeight);
+    nStructPtr->SetStage(stage_);
 
-      nStructPtr->SetStructureEntity();
+    CopyGroupToStructure(*nStructPtr, info);
 
-      structList_.insert(std::make_pair(group, nStructPtr));
-      groups_.insert(group);
-    }
+    nStructPtr->SetStructureEntity();
+
+    structList_.insert(std::make_pair(group, nStructPtr));
+    groups_.insert(group);
   }
 
   void Grid::RemoveStructure(int group)
@@ -1175,7 +1022,7 @@ namespace Engine
     {
       for (int j = 0; j < width_; ++j)
       {
-        stream << std::setw(2) << stage_->getInstanceFromID(row_[i][j]).RequestData<int>("TileGroup") << " ";
+        stream << std::setw(2) << cellGroups_[CellIndex(j, i)] << " ";
       }
 
       stream << std::endl;
@@ -1193,7 +1040,9 @@ namespace Engine
   /*!
   \brief
   Loads the structure data from the given JSON file and loads and adds each
-  structure in the path into memory for later comparisons during building
+  structure in the path into memory for later comparisons during building.
+  The file is only parsed the first time, restarts of the stage copy the
+  structures out of its snapshot
 
   \param defPath
   The path to the JSON file to read all structures from
@@ -1202,72 +1051,93 @@ namespace Engine
   /****************************************************************************/
   void Grid::LoadStructureData(const std::string& defPath)
   {
+    std::shared_ptr<STRUCT_DATA> data = stage_->getSnapshot().load<STRUCT_DATA>(defPath, 
+      [&defPath]() { return ParseStructureData(defPath); });
+
+    GameInstance* gameObject = stage_->getMessenger().Request<GameInstance*>("PlayerController");
+
+    STRUCT_LIST * LSL = gameObject->RequestData<STRUCT_LIST*>("GetParsedStructureList");
+    STRUCT_INDEX * LSI = gameObject->RequestData<STRUCT_INDEX*>("GetStructureIndex");
+
+    LSL->insert(data->first.begin(), data->first.end());
+    LSI->insert(data->second.begin(), data->second.end());
+  }
+
+  /****************************************************************************/
+  /*!
+  \brief
+  Reads every structure listed in a structure definitions file
+
+  \param defPath
+  The path to the JSON file to read all structures from
+
+  \return
+  New structure list and pattern index. Caller owns it
+  */
+  /****************************************************************************/
+  STRUCT_DATA * Grid::ParseStructureData(const std::string& defPath)
+  {
+    std::unique_ptr<STRUCT_DATA> data(new STRUCT_DATA);
 
-    //if (loaded == false)
+    std::ifstream structDefs(defPath);
+    Json::Reader reader;
+    Json::Value root;
+    const Json::Value defValue;
+
+    if (structDefs.is_open())
     {
-      std::ifstream structDefs(defPath);
-      Json::Reader reader;
-      Json::Value root;
-      const Json::Value defValue;
+      reader.parse(structDefs, root);
 
-      if (structDefs.is_open())
-      {
-        reader.parse(structDefs, root);
+      std::vector<std::string> structFolders = root.getMemberNames();
 
-        std::vector<std::string> structFolders = root.getMemberNames();
+      // get each folder
+      for (auto & folderPath : structFolders)
+      {
+        Json::Value folder = root.get(folderPath, defValue);
 
-        // get each folder
-        for (auto & folderPath : structFolders)
+        if (folder != defValue)
         {
-          Json::Value folder = root.get(folderPath, defValue);
+          // Get each structure path in the folder
+          std::vector<std::string> structureDefs = folder.getMemberNames();
 
-          if (folder != defValue)
+          for (auto & structDef : structureDefs)
           {
-            // Get each structure path in the folder
-            std::vector<std::string> structureDefs = folder.getMemberNames();
+            Json::Value structure = folder.get(structDef, defValue);
 
-            for (auto & structDef : structureDefs)
+            // error
+            if (structure == defValue)
             {
-              Json::Value structure = folder.get(structDef, defValue);
-
-              // error
-              if (structure == defValue)
-              {
-                Log<Warning>("Error parsing structure definitions in file '%s'", defPath.c_str());
-                throw(std::runtime_error("Error parsing structure definitions"));
-              }
+              Log<Warning>("Error parsing structure definitions in file '%s'", defPath.c_str());
+              throw(std::runtime_error("Error parsing structure definitions"));
+            }
 
-              // Get the alias of the structure
-              std::string & alias = structDef;
+            // Get the alias of the structure
+            std::string & alias = structDef;
 
-              // Get the relative path of the structure
-              std::string structPath = folderPath + structure.get("path", defValue).asString();
+            // Get the relative path of the structure
+            std::string structPath = folderPath + structure.get("path", defValue).asString();
 
-              // Add the texture to the texture map
-              Stage* objStage = stage_;
+            STRUCT_LIST & LSL = data->first;
+            STRUCT_INDEX & LSI = data->second;
 
-              GameInstance* gameObject = objStage->getMessenger().Request<GameInstance*>("PlayerController");
+            LSL[alias] = Structure(structPath);
 
-              STRUCT_LIST * LSL = gameObject->RequestData<STRUCT_LIST*>("GetParsedStructureList");
+            // Index the pattern so built structures are recognized with one lookup
+            auto indexed = LSI.insert(std::make_pair(LSL[alias].GetPatternKey(), alias));
 
-              (*LSL)[alias] = Structure(structPath);
-            }
-          }
-          else
-          {
-            Log<Warning>("Error parsing structure definitions in file '%s'", defPath.c_str());
-            throw(std::runtime_error("Error parsing structure definitions"));
+            if (!indexed.second)
+              Log<Warning>("Structure '%s' has the same pattern as '%s'", alias.c_str(), indexed.first->second.c_str());
           }
         }
+        else
+        {
+          Log<Warning>("Error parsing structure definitions in file '%s'", defPath.c_str());
+          throw(std::runtime_error("Error parsing structure definitions"));
+        }
       }
     }
-    /*
-    else
-    {
-    Log<Error>("Failed to open structure definitions file '%s'", defPath.c_str());
-    throw(std::runtime_error("Could not open structure definitions!"));
-    }
-    */
+
+    return data.release();
   }
 
 }
@@ -8,9 +8,14 @@
 #include "../include/grid.h"
 #include "../include/Input.h"
 #include "../include/Messages.h"
+#include "../include/EngineCounters.h"
+#include "../include/FrameProfiler.h"
+#include "../include/MemoryTracker.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 static int BaseWindowSize_X;
 static int BaseWindowSize_Y;
@@ -21,8 +26,176 @@ static bool show_grid_heightmap = false;
 static bool show_framerate = false;
 static bool show_stage_info = false;
 static bool show_struct_info = false;
+static bool show_counters = false;
+static bool show_memory = false;
 
 static Display& disp = Engine::GSM::get().getDisplay();
+
+// Frame counts the framerate window can compute stats over
+static const char * FRAME_WINDOW_NAMES[] = { "60 frames", "300 frames", "1800 frames", "3600 frames" };
+static const size_t FRAME_WINDOW_SIZES[] = { 60, 300, 1800, 3600 };
+static int frame_window = 1;
+
+/****************************************************************************/
+/*!
+\brief
+Shows one line of frame time stats
+
+\param label
+Name of the stats
+
+\param stats
+The stats to show
+*/
+/****************************************************************************/
+static void ShowFrameStats(const char * label, const Engine::FrameStats & stats)
+{
+  ImGui::Text("%s (%u frames)", label, static_cast<unsigned>(stats.frames));
+  ImGui::Text("  mean %.2f  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms",
+    stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+}
+
+/****************************************************************************/
+/*!
+\brief
+Shows a progress bar while a stage is being reset. Stages preloading in the
+background don't show one
+*/
+/****************************************************************************/
+static void ShowLoadingStages()
+{
+  for (auto & order : Engine::Stage::StageList)
+  {
+    for (auto & stage : order.second)
+    {
+      if (!stage->isStageLoading() || stage->isStageLoadingInBackground())
+        continue;
+
+      ImGui::SetNextWindowPos(ImVec2(disp.GetWidth() * 0.5f - 150, disp.GetHeight() * 0.5f), ImGuiSetCond_Always);
+      ImGui::SetNextWindowSize(ImVec2(300, 0), ImGuiSetCond_Always);
+
+      ImGui::Begin("Loading", nullptr, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
+        ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings);
+
+      ImGui::Text("Loading %s", stage->getStageName().c_str());
+      ImGui::ProgressBar(stage->getLoadProgress());
+
+      ImGui::End();
+      return;
+    }
+  }
+}
+
+/****************************************************************************/
+/*!
+\brief
+Shows the frame time graph, percentiles and stutter log
+*/
+/****************************************************************************/
+static void UpdateFramerate()
+{
+  using Engine::FrameProfiler;
+
+  ImGui::Text("FPS: %.3f", 1 / disp.GetFrameTime());
+
+  // Frame time graph of the selected window
+  const auto & history = FrameProfiler::GetHistory();
+  size_t windowSize = FRAME_WINDOW_SIZES[frame_window];
+  size_t shown = std::min(windowSize, history.size());
+
+  static std::vector<float> graph;
+  graph.clear();
+
+  for (auto it = history.end() - shown; it != history.end(); ++it)
+    graph.push_back(static_cast<float>(it->total / 1000000.0));
+
+  ImGui::Combo("Window", &frame_window, FRAME_WINDOW_NAMES, IM_ARRAYSIZE(FRAME_WINDOW_NAMES));
+
+  if (!graph.empty())
+    ImGui::PlotLines("ms", graph.data(), static_cast<int>(graph.size()), 0, nullptr, 0.f, 50.f, ImVec2(0, 80));
+
+  ShowFrameStats("Window", FrameProfiler::GetWindowStats(windowSize));
+  ShowFrameStats("Lifetime", FrameProfiler::GetLifetimeStats());
+
+  float threshold = static_cast<float>(FrameProfiler::GetStutterThreshold());
+  if (ImGui::InputFloat("Stutter ms", &threshold, 1.f, 10.f, 1))
+    FrameProfiler::SetStutterThreshold(threshold);
+
+  if (ImGui::Button("Reset")) FrameProfiler::ResetStats();
+  ImGui::SameLine();
+  if (ImGui::Button("Export CSV"))
+  {
+    if (FrameProfiler::ExportCSV("frame_times.csv", "frame_stutters.csv"))
+      Logger::Log<Logger::Info>("Frame times written to frame_times.csv and frame_stutters.csv");
+    else
+      Logger::Log<Logger::Warning>("Failed to export frame times");
+  }
+
+  // Stutters, newest first, with the time each section of the frame took
+  const auto & names = FrameProfiler::GetSectionNames();
+  const auto & stutters = FrameProfiler::GetStutters();
+
+  ImGui::Text("Stutters: %u", static_cast<unsigned>(stutters.size()));
+  ImGui::BeginChild("Stutters", ImVec2(0, 150), true);
+
+  for (auto it = stutters.rbegin(); it != stutters.rend(); ++it)
+  {
+    std::ostringstream line;
+    line.precision(2);
+    line << std::fixed << "#" << it->frame << " " << it->total / 1000000.0 << " ms:";
+
+    for (size_t i = 0; i < names.size(); ++i)
+      line << " " << names[i] << " " << it->sections[i] / 1000000.0;
+
+    ImGui::TextUnformatted(line.str().c_str());
+  }
+
+  ImGui::EndChild();
+}
+
+/****************************************************************************/
+/*!
+\brief
+Shows live and peak memory of every subsystem, and what each allocated
+last frame
+*/
+/****************************************************************************/
+static void UpdateMemory()
+{
+  using Engine::MemoryTracker;
+
+  ImGui::Columns(6, "Memory");
+  ImGui::Text("System"); ImGui::NextColumn();
+  ImGui::Text("Live KB"); ImGui::NextColumn();
+  ImGui::Text("Peak KB"); ImGui::NextColumn();
+  ImGui::Text("Allocs"); ImGui::NextColumn();
+  ImGui::Text("Frees"); ImGui::NextColumn();
+  ImGui::Text("Frame KB"); ImGui::NextColumn();
+  ImGui::Separator();
+
+  for (size_t i = 0; i < MemoryTracker::TAG_COUNT; ++i)
+  {
+    Engine::MemoryTag tag = static_cast<Engine::MemoryTag>(i);
+    Engine::MemoryStats stats = MemoryTracker::GetStats(tag);
+
+    ImGui::Text("%s", MemoryTracker::GetTagName(tag)); ImGui::NextColumn();
+    ImGui::Text("%.1f", stats.live / 1024.0); ImGui::NextColumn();
+    ImGui::Text("%.1f", stats.peak / 1024.0); ImGui::NextColumn();
+    ImGui::Text("%u", static_cast<unsigned>(stats.frameAllocs)); ImGui::NextColumn();
+    ImGui::Text("%u", static_cast<unsigned>(stats.frameFrees)); ImGui::NextColumn();
+    ImGui::Text("%.1f", stats.frameBytes / 1024.0); ImGui::NextColumn();
+  }
+
+  ImGui::Columns(1);
+
+  if (ImGui::Button("Export CSV"))
+  {
+    if (MemoryTracker::ExportCSV("memory.csv"))
+      Logger::Log<Logger::Info>("Memory use written to memory.csv");
+    else
+      Logger::Log<Logger::Warning>("Failed to export memory use");
+  }
+}
 //static Engine::Grid& grid = Engine::Stage::GetStage("TestStage1").GetGrid();;
 
 /****************************************************************************/
@@ -48,17 +221,21 @@ void UpdateImGui(SDL_Window* window)
   {
     UpdateMain();
   }
+
+  ShowLoadingStages();
 }
 
 /****************************************************************************/
 /*!
 \brief
 Governs logic of updating the imgui interface
-4 Buttons / Windows currently
+5 Buttons / Windows currently
 - Framerate
 - Grid View / Group View
 - Stage info (Counts game objects only so far)
 - Structure info (Lists all structures on the grid currently)
+- Counters (Per frame values reported by engine systems)
+- Memory (Heap use per subsystem)
 
 */
 /****************************************************************************/
@@ -77,6 +254,12 @@ void UpdateMain()
     if (ImGui::Button("Grid View")) show_grid_view ^= 1;
     if (ImGui::Button("Stage Info")) show_stage_info ^= 1;
     if (ImGui::Button("Structure Info")) show_struct_info ^= 1;
+    if (ImGui::Button("Counters")) show_counters ^= 1;
+    if (ImGui::Button("Memory")) show_memory ^= 1;
+
+    bool gpuPicking = Engine::GSM::get().getRenderer().isGPUPicking();
+    if (ImGui::Checkbox("GPU Picking", &gpuPicking))
+      Engine::GSM::get().getRenderer().setGPUPicking(gpuPicking);
 
     // End Window
     ImGui::End();
@@ -85,13 +268,44 @@ void UpdateMain()
   if (show_framerate)
   {
     // Set Window Properties
-    ImGui::SetNextWindowSize(ImVec2(20, 20), ImGuiSetCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(420, 380), ImGuiSetCond_FirstUseEver);
 
     // Begin Window
     ImGui::Begin("Framerate", &show_framerate);
 
     // Window Logic
-    ImGui::Text("FPS: %.3f", 1 / disp.GetFrameTime());
+    UpdateFramerate();
+
+    // End Window
+    ImGui::End();
+  }
+
+  if (show_counters)
+  {
+    // Set Window Properties
+    ImGui::SetNextWindowSize(ImVec2(250, 200), ImGuiSetCond_FirstUseEver);
+
+    // Begin Window
+    ImGui::Begin("Counters", &show_counters);
+
+    // Window Logic
+    for (auto & counter : Engine::EngineCounters::GetAll())
+      ImGui::Text("%s: %.3f", counter.first.c_str(), counter.second);
+
+    // End Window
+    ImGui::End();
+  }
+
+  if (show_memory)
+  {
+    // Set Window Properties
+    ImGui::SetNextWindowSize(ImVec2(420, 220), ImGuiSetCond_FirstUseEver);
+
+    // Begin Window
+    ImGui::Begin("Memory", &show_memory);
+
+    // Window Logic
+    UpdateMemory();
 
     // End Window
     ImGui::End();
@@ -114,12 +328,12 @@ void UpdateMain()
       {
         for (int j = 0; j < grid.GetGridWidth(); ++j)
         {
-          int group = stage.getInstanceFromID(grid[i][j]).RequestData<int>("TileGroup");
-          if (stage.getInstanceFromID(grid[i][j]).RequestData<int>("TileGroup") > 1)
+          int group = grid.GetCellGroup(j, i);
+          if (group > 1)
           {
             if (e == 1)
             {
-              int height = stage.getInstanceFromID(grid[i][j]).RequestData<int>("TileHeight");
+              int height = grid.GetCellHeight(j, i);
               ImGui::TextColored(ImVec4(1.0f - height / 10.0f, 
                                         height / 3.0f, 
                                         height / 10.0f, 1.0f), 
@@ -242,7 +456,7 @@ void UpdateMain()
           {
             for (int j = 0; j < iter.second.GetY(); ++j)
             {
-              int l = iter.second.GetGrid()[j][i]->GetHeight();
+              int l = iter.second.GetTile(i, j).GetHeight();
               if (l)
               {
                 ImGui::Text(" %2i", l); ImGui::SameLine();
@@ -278,7 +492,7 @@ void UpdateMain()
           {
             for (int j = 0; j < order.second->GetY(); ++j)
             {
-              int l = order.second->GetGrid()[j][i]->GetHeight();
+              int l = order.second->GetTile(i, j).GetHeight();
               if (l)
               {
                 ImGui::Text(" %2i", l); ImGui::SameLine();
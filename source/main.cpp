@@ -4,9 +4,14 @@
 // FMOD Sound System Copyright  Firelight Technologies Pty, Ltd., 2017.
 // ---------------------------------------------------------------------------------
 #include <windows.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "../include/GSM.h"
 #include "../include/Logger.h"
+#include "../include/InputRecorder.h"
+#include "../include/MemoryTracker.h"
+#include "../include/audio_startup.h"
 
 #ifndef NDEBUG
 // Overrides WINAPI macro for debug mode
@@ -29,9 +34,45 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
   
   Engine::GSM & GameStageManager = Engine::GSM::get();
 
+  // -audio <fmod|sdl|null> picks the sound backend, it has to be known
+  // before the audio system starts up in Init
+  for (int i = 1; i + 1 < __argc; ++i)
+    if (!strcmp(__argv[i], "-audio"))
+      setAudioBackend(__argv[i + 1]);
+
   GameStageManager.Init();
+
+  // -record <file> saves this session's input, -replay <file> plays one 
+  // back, and -benchmark quits once the replay is done. -memreport <file>
+  // writes out memory use per subsystem when the game closes
+  bool benchmark = false;
+  const char * memReport = nullptr;
+
+  for (int i = 1; i < __argc; ++i)
+    if (!strcmp(__argv[i], "-benchmark"))
+      benchmark = true;
+
+  for (int i = 1; i + 1 < __argc; ++i)
+  {
+    if (!strcmp(__argv[i], "-record"))
+      Engine::InputRecorder::StartRecording(__argv[i + 1]);
+    else if (!strcmp(__argv[i], "-replay"))
+      Engine::InputRecorder::StartReplay(__argv[i + 1], benchmark);
+    else if (!strcmp(__argv[i], "-memreport"))
+      memReport = __argv[i + 1];
+  }
+
   GameStageManager.Loop();
+
+  // Before unloading, so it shows what the game was holding
+  if (memReport && !Engine::MemoryTracker::ExportCSV(memReport))
+    Logger::Log<Logger::Warning>("Failed to write memory report to '%s'", memReport);
+
+  Engine::InputRecorder::Stop();
   GameStageManager.Unload();
 
+  // Write out anything still queued before the process exits
+  Logger::Shutdown();
+
   return 0;
 }
@@ -12,6 +12,7 @@
 #include "../include/Input.h"
 #include "../include/GSM.h"
 #include "../include/camera.h"
+#include "../include/EngineCounters.h"
 #include "DrawUtils.h"
 
 #include <algorithm>
@@ -124,23 +125,47 @@ namespace Engine
     //}
   }
 
-  void Sprite::SetTransform()
+  /****************************************************************************/
+  /*!
+    \brief
+      Pushes the owner's transform into the draw token. Does nothing if the
+      transform hasn't changed since the last sync, and otherwise only writes
+      the fields that changed
+
+    \return
+      True if the transform had changed and was synced
+  */
+  /****************************************************************************/
+  bool Sprite::SetTransform()
   {
-    /*Transform * trans = dynamic_cast<Transform *>(getParent().getComponent("Transform"));
+    if (!transform_)
+      transform_ = dynamic_cast<Transform *>(getParent().getComponent("Transform"));
+
+    if (transform_->getVersion() == transformVersion_)
+      return false;
 
-    item_->transform_ = trans->getTransform();*/
-    glm::vec2 pos = getParent().RequestData<glm::vec2>("Position"); /// TODO add event to get adjusted position (with height)
-    float depth = getParent().RequestData<float>("TransformDepth");
-    glm::vec2 offset{ xOffset_, yOffset_ };
+    bool first = (transformVersion_ == 0);
+    transformVersion_ = transform_->getVersion();
 
-    float width = getParent().RequestData<float>("Width");
-    float height = getParent().RequestData<float>("Height");
-    float rot = getParent().RequestData<float>("Rotation");
+    /// TODO add event to get adjusted position (with height)
+    glm::vec2 pos = transform_->getPos() + glm::vec2{ xOffset_, yOffset_ };
+    glm::vec2 scale{ transform_->getWidth(), transform_->getHeight() };
+    float rot = transform_->getRot();
+    float depth = transform_->getDepth();
 
-    item_.setPosition(pos + offset);
-    item_.setScale(glm::vec2{ width, height });
-    item_.setRotation(rot);
-    item_.setDepth(depth);
+    if (first || pos != syncedPos_)
+      item_.setPosition(syncedPos_ = pos);
+
+    if (first || scale != syncedScale_)
+      item_.setScale(syncedScale_ = scale);
+
+    if (first || rot != syncedRot_)
+      item_.setRotation(syncedRot_ = rot);
+
+    if (first || depth != syncedDepth_)
+      item_.setDepth(syncedDepth_ = depth);
+
+    return true;
   }
 
   //SpriteHandler
@@ -234,6 +259,9 @@ namespace Engine
 
     sub->getParent().registerScriptEvent(events);
 
+    // Components caching the old graphic switch to this one
+    sub->getParent().PostMessage("GraphicChanged", Message<DrawToken>(sub->getItem()));
+
   }
 
   //void SpriteHandler::SpriteDrawOrderRequest(const Sprite * obj, Packet & data)
@@ -248,15 +276,18 @@ namespace Engine
 
   void SpriteHandler::update()
   {
+    unsigned synced = 0;
+
+    for (unsigned int i = 0; i < componentList_.size(); ++i)
     {
-      for (unsigned int i = 0; i < componentList_.size(); ++i)
+      if (componentList_[i]->getComponentType() == "Sprite")
       {
-        if (componentList_[i]->getComponentType() == "Sprite")
-        {
-          static_cast<Sprite*>(componentList_[i])->SetTransform();
-        }
+        if (static_cast<Sprite*>(componentList_[i])->SetTransform())
+          ++synced;
       }
     }
+
+    EngineCounters::Add("Sprites synced", synced);
   }
 
   void SpriteHandler::getLuaRegisters()